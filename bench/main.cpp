@@ -0,0 +1,396 @@
+// ============================================================================
+// DroneShield_Bench - 后端吞吐量基准
+//
+// 用法: DroneShield_Bench [--filter 子串] [--min-ms 300] [--json 结果文件] [--commit 提交号]
+// --json 以 JSON Lines 追加写入 (每个用例一行，带提交号和时间)，CI 逐提交保存即可对比回归
+// 界面用例在离屏平台 (QT_QPA_PLATFORM=offscreen) 上绘制，无显示器的 CI 主机也能运行
+// ============================================================================
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaMethod>
+#include <QPainter>
+#include <QStyleOptionViewItem>
+#include <QTextStream>
+#include <array>
+#include <functional>
+#include <memory>
+#include "src/Backend/devicemanager.h"
+#include "src/Backend/trackstore.h"
+#include "src/Backend/latencytracer.h"
+#include "src/Backend/Drivers/detectionframeparser.h"
+#include "src/Backend/HAL/framedecoder.h"
+#include "src/Backend/Drivers/spoofdriver.h"
+#include "src/Backend/Drivers/relaydriver.h"
+#include "src/Backend/Drivers/jammerdriver.h"
+#include "src/UI/tilecoord.h"
+#include "src/UI/targetlistmodel.h"
+#include "src/UI/targetcarddelegate.h"
+
+#ifndef DRONESHIELD_GIT_COMMIT
+#define DRONESHIELD_GIT_COMMIT "unknown"
+#endif
+
+namespace {
+
+// 累加每次调用的返回值，防止编译器把被测代码整个优化掉
+volatile size_t g_sink = 0;
+
+struct BenchCase {
+    QString name;
+    std::function<size_t()> fn;
+};
+
+struct BenchResult {
+    QString name;
+    quint64 iterations = 0;
+    double nsPerOp = 0.0;
+};
+
+BenchResult runCase(const BenchCase &c, qint64 minNs)
+{
+    // 预热 (填充缓存、触发惰性初始化)
+    for (int i = 0; i < 32; ++i) g_sink = g_sink + c.fn();
+
+    // 批量倍增直到总时长达标，计时开销摊薄到可以忽略
+    quint64 iterations = 0;
+    quint64 batch = 1;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.nsecsElapsed() < minNs) {
+        for (quint64 i = 0; i < batch; ++i) g_sink = g_sink + c.fn();
+        iterations += batch;
+        if (batch < (1u << 16)) batch *= 2;
+    }
+    return {c.name, iterations, double(timer.nsecsElapsed()) / double(iterations)};
+}
+
+// ---------------------------------------------------------------------------
+// 测试数据
+// ---------------------------------------------------------------------------
+QString makeDroneFrame(int count)
+{
+    QString frame = "42[\"droneStatus\",[";
+    for (int i = 0; i < count; ++i) {
+        if (i) frame += ',';
+        frame += QString("{\"uav_info\":{\"uav_id\":\"1636J14%1\",\"model_name\":\"Mavic 3\","
+                         "\"distance\":%2,\"azimuth\":%3,\"uav_lat\":34.2%4,\"uav_lng\":108.8%4,"
+                         "\"height\":120.5,\"freq\":2437.5,\"velocity\":\"South 10.0 m/s\","
+                         "\"pilot_lat\":34.21,\"pilot_lng\":108.83,\"pilot_distance\":\"--\","
+                         "\"whiteList\":false,\"uuid\":\"u%1\",\"img\":1,\"type\":\"drone\"}}")
+                     .arg(i, 5, 10, QChar('0'))
+                     .arg(300 + i * 7)
+                     .arg(i % 360)
+                     .arg(i, 4, 10, QChar('0'));
+    }
+    frame += "]]";
+    return frame;
+}
+
+// 旧版 TCP 侦测板：每帧一个目标
+QByteArray makeLegacyFrame(int index)
+{
+    return QString("{\"station_droneInfo\":{\"trace\":{\"uav_id\":\"1636J14%1\",\"model_name\":\"Mavic 3\","
+                   "\"uav_lat\":\"34.2%2\",\"uav_lng\":\"108.8%2\",\"Height\":120.5,\"freq\":2437.5,"
+                   "\"velocity\":\"South 10.0 m/s\",\"pilot_lat\":\"34.21\",\"pilot_lng\":\"108.83\","
+                   "\"pilot_distance\":0,\"distance\":%3,\"azimuth\":%4,\"uuid\":\"u%1\",\"type\":\"drone\"}}}")
+        .arg(index, 5, 10, QChar('0'))
+        .arg(index, 4, 10, QChar('0'))
+        .arg(300 + index * 7)
+        .arg(index % 360)
+        .toUtf8();
+}
+
+QList<DroneInfo> makeDrones(int count, int frame)
+{
+    QList<DroneInfo> drones;
+    drones.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        DroneInfo d;
+        d.uav_id = QString("1636J14%1").arg(i, 5, 10, QChar('0'));
+        d.model_name = "Mavic 3";
+        d.distance = 300 + i * 7 + (frame & 1); // 每帧都有变化
+        d.azimuth = i % 360;
+        d.uav_lat = 34.2 + i * 1e-4;
+        d.uav_lng = 108.8 + i * 1e-4;
+        d.uuid = QString("u%1").arg(i);
+        drones.append(d);
+    }
+    return drones;
+}
+
+// 旧实现：mid + toUtf8 + QJsonDocument 全量构建 DOM
+size_t parseWithQJson(const QString &message)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(message.mid(2).toUtf8());
+    QJsonArray root = doc.array();
+    if (root.size() < 2 || root.at(0).toString() != "droneStatus") return 0;
+
+    QList<DroneInfo> drones;
+    const QJsonArray list = root.at(1).toArray();
+    for (const QJsonValue &v : list) {
+        QJsonObject o = v.toObject().value("uav_info").toObject();
+        DroneInfo d;
+        d.uav_id = o.value("uav_id").toString();
+        d.model_name = o.value("model_name").toString();
+        d.distance = o.value("distance").toVariant().toDouble();
+        d.azimuth = o.value("azimuth").toDouble();
+        d.uav_lat = o.value("uav_lat").toDouble();
+        d.uav_lng = o.value("uav_lng").toDouble();
+        d.height = o.value("height").toDouble();
+        d.freq = o.value("freq").toDouble();
+        d.velocity = o.value("velocity").toString();
+        d.pilot_lat = o.value("pilot_lat").toDouble();
+        d.pilot_lng = o.value("pilot_lng").toDouble();
+        d.pilot_distance = o.value("pilot_distance").toVariant().toDouble();
+        d.whiteList = o.value("whiteList").toBool();
+        d.uuid = o.value("uuid").toString();
+        d.img = o.value("img").toInt();
+        d.type = o.value("type").toString();
+        drones.append(d);
+    }
+    return size_t(drones.size());
+}
+
+// 旧版 TileCoord 哈希：每次查找格式化一个 QString
+size_t legacyTileHash(const TileCoord &key, size_t seed)
+{
+    return qHash(QString("%1_%2_%3").arg(key.z).arg(key.x).arg(key.y), seed);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("DroneShield_Bench");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption filterOpt("filter", "只运行名称包含该子串的用例", "text");
+    QCommandLineOption minMsOpt("min-ms", "每个用例最短运行时间 (ms)", "ms", "300");
+    QCommandLineOption jsonOpt("json", "结果以 JSON Lines 追加写入该文件", "file");
+    QCommandLineOption commitOpt("commit", "结果中记录的提交号", "hash", DRONESHIELD_GIT_COMMIT);
+    parser.addOptions({filterOpt, minMsOpt, jsonOpt, commitOpt});
+    parser.process(app);
+
+    const qint64 minNs = qMax(10, parser.value(minMsOpt).toInt()) * 1000000LL;
+    const QString commit = parser.value(commitOpt);
+
+    QList<BenchCase> cases;
+
+    // 1. 侦测帧解析：流式解析 vs QJsonDocument
+    static DetectionFrameParser frameParser;
+    for (int n : {1, 10, 50}) {
+        QString frame = makeDroneFrame(n);
+        cases.append({QString("parse/stream/%1").arg(n), [frame]() {
+            frameParser.parse(QStringView(frame));
+            return size_t(frameParser.drones().size());
+        }});
+        cases.append({QString("parse/qjson/%1").arg(n), [frame]() {
+            return parseWithQJson(frame);
+        }});
+
+        // 二进制附件：UTF-8 JSON 与 qCompress 压缩 JSON (压缩用例含解压耗时)
+        QByteArray utf8 = frame.mid(frame.indexOf(',') + 1).chopped(1).toUtf8();
+        QByteArray packed = qCompress(utf8);
+        cases.append({QString("parse/utf8/%1").arg(n), [utf8]() {
+            frameParser.parseDrones(QByteArrayView(utf8));
+            return size_t(frameParser.drones().size());
+        }});
+        cases.append({QString("parse/zlib/%1").arg(n), [packed]() {
+            QByteArray inflated = qUncompress(packed);
+            frameParser.parseDrones(QByteArrayView(inflated));
+            return size_t(frameParser.drones().size());
+        }});
+    }
+
+    // 旧版 TCP 帧协议：64 帧连续流按 TCP 分段大小 (1460 B) 送入环形缓冲，
+    // 只拆帧 / 拆帧后逐帧流式解析
+    {
+        QByteArray stream;
+        for (int i = 0; i < 64; ++i) {
+            QByteArray json = makeLegacyFrame(i);
+            quint32 header[3] = {FrameDecoder::HEAD, quint32(json.size()), 1};
+            quint32 tail = FrameDecoder::TAIL;
+            stream.append(reinterpret_cast<const char *>(header), sizeof(header));
+            stream.append(json);
+            stream.append(reinterpret_cast<const char *>(&tail), sizeof(tail));
+        }
+        auto decoder = std::make_shared<FrameDecoder>();
+        cases.append({QString("decode/framed/64"), [stream, decoder]() {
+            FrameDecoder::Frame frame;
+            size_t frames = 0;
+            for (qsizetype off = 0; off < stream.size(); off += 1460) {
+                decoder->append(stream.constData() + off, qMin<qsizetype>(1460, stream.size() - off));
+                while (decoder->next(frame)) ++frames;
+            }
+            return frames;
+        }});
+        cases.append({QString("parse/legacy/64"), [stream, decoder]() {
+            FrameDecoder::Frame frame;
+            size_t drones = 0;
+            for (qsizetype off = 0; off < stream.size(); off += 1460) {
+                decoder->append(stream.constData() + off, qMin<qsizetype>(1460, stream.size() - off));
+                while (decoder->next(frame)) {
+                    if (frameParser.parseLegacy(frame.payload) == DetectionFrameParser::Event::DroneStatus) {
+                        drones += size_t(frameParser.drones().size());
+                    }
+                }
+            }
+            return drones;
+        }});
+    }
+
+    // 2. 航迹库合并 (稳态：目标集合不变、数值每帧变化)
+    for (int n : {10, 100, 500}) {
+        auto store = std::make_shared<TrackStore<DroneInfo>>();
+        auto frames = std::make_shared<std::array<QList<DroneInfo>, 2>>();
+        (*frames)[0] = makeDrones(n, 0);
+        (*frames)[1] = makeDrones(n, 1);
+        auto tick = std::make_shared<qint64>(0);
+        cases.append({QString("track/apply/%1").arg(n), [store, frames, tick]() {
+            DroneTrackDiff diff;
+            qint64 now = ++*tick;
+            store->apply((*frames)[now & 1], now, diff);
+            store->expire(now, diff);
+            return size_t(diff.updated.size());
+        }});
+    }
+
+    // 3. 决策路径：DeviceManager 处理一帧 (航迹增量 + 威胁评估)，手动模式下不会真正下发指令
+    DeviceManager core;
+    QMetaMethod onDrones = core.metaObject()->method(core.metaObject()->indexOfMethod(
+        QMetaObject::normalizedSignature("onDroneListUpdated(QList<DroneInfo>,FrameTrace)")));
+    for (int n : {10, 100}) {
+        auto frames = std::make_shared<std::array<QList<DroneInfo>, 2>>();
+        (*frames)[0] = makeDrones(n, 0);
+        (*frames)[1] = makeDrones(n, 1);
+        auto tick = std::make_shared<quint64>(0);
+        cases.append({QString("decision/frame/%1").arg(n), [&core, onDrones, frames, tick]() {
+            FrameTrace trace;
+            trace.seq = ++*tick;
+            trace.ingestNs = trace.parsedNs = LatencyClock::nowNs();
+            onDrones.invoke(&core, Qt::DirectConnection,
+                            Q_ARG(QList<DroneInfo>, (*frames)[*tick & 1]), Q_ARG(FrameTrace, trace));
+            return size_t(1);
+        }});
+    }
+
+    // 4. 指令组包
+    cases.append({"encode/spoof/circular", []() {
+        QJsonObject json;
+        json["sKey"] = "123456";
+        json["fCirRadius"] = 500.0;
+        json["fCirCycle"] = 50.0;
+        json["iCirRotDir"] = 0;
+        return size_t(SpoofDriver::encodePacket("610", json).size());
+    }});
+    cases.append({"encode/relay/all", []() {
+        return size_t(RelayDriver::allCommand(true).size());
+    }});
+    cases.append({"encode/relay/channel", []() {
+        return size_t(RelayDriver::channelCommand(3, true).size());
+    }});
+    cases.append({"encode/relay/mask16", []() {
+        static ModbusCodec codec;
+        static quint32 mask = 0;
+        return size_t(codec.writeCoils(0, 16, ++mask).size());
+    }});
+    QList<JammerConfigData> jammerConfigs;
+    for (int i = 0; i < 4; ++i) jammerConfigs.append({1, 400.0 + i * 500, 500.0 + i * 500, true});
+    cases.append({"encode/jammer/writeFreq", [jammerConfigs]() {
+        QJsonObject json = JammerDriver::buildFreqRequest("writeFreq", jammerConfigs);
+        return size_t(QJsonDocument(json).toJson(QJsonDocument::Compact).size());
+    }});
+
+    // 5. 瓦片键哈希：打包整数 vs 旧版字符串
+    cases.append({"tile/hash/packed", []() {
+        static int i = 0;
+        TileCoord c = {(i * 7) & 0x7FFF, (i * 13) & 0x7FFF, 15};
+        ++i;
+        return qHash(c, 0);
+    }});
+    cases.append({"tile/hash/qstring", []() {
+        static int i = 0;
+        TileCoord c = {(i * 7) & 0x7FFF, (i * 13) & 0x7FFF, 15};
+        ++i;
+        return legacyTileHash(c, 0);
+    }});
+
+    // 6. 延迟直方图记录
+    static LatencyHistogram histogram;
+    cases.append({"latency/histogram/record", []() {
+        static qint64 v = 1;
+        v = (v * 6364136223846793005LL + 1442695040888963407LL) & 0xFFFFFFF;
+        histogram.record(v);
+        return size_t(histogram.count());
+    }});
+
+    // 7. 目标列表 (模型/视图) 一个刷新周期：应用一帧航迹增量 (每个目标都有变化) + 绘制全部行
+    for (int n : {10, 100, 500}) {
+        auto model = std::make_shared<TargetListModel>();
+        auto delegate = std::make_shared<TargetCardDelegate>();
+        auto frames = std::make_shared<std::array<QList<DroneInfo>, 2>>();
+        (*frames)[0] = makeDrones(n, 0);
+        (*frames)[1] = makeDrones(n, 1);
+        auto canvas = std::make_shared<QImage>(320, 160, QImage::Format_ARGB32_Premultiplied);
+        auto tick = std::make_shared<quint64>(0);
+        cases.append({QString("ui/targetlist/%1").arg(n), [model, delegate, frames, canvas, tick]() {
+            for (const DroneInfo &d : (*frames)[++*tick & 1]) model->upsertDrone(trackKey(d), d);
+
+            // 各行画在同一画布上，只计格式化与绘制开销
+            QPainter painter(canvas.get());
+            QStyleOptionViewItem option;
+            option.rect = QRect(0, 0, canvas->width(), canvas->height());
+            for (int row = 0; row < model->rowCount(); ++row) {
+                QModelIndex index = model->index(row);
+                option.rect.setHeight(delegate->sizeHint(option, index).height());
+                delegate->paint(&painter, option, index);
+            }
+            return size_t(model->rowCount());
+        }});
+    }
+
+    // ---------------------------------------------------------------------------
+    QTextStream out(stdout);
+    out << "DroneShield_Bench  commit " << commit << "  "
+        << QDateTime::currentDateTime().toString(Qt::ISODate) << Qt::endl;
+    out << QString("%1 %2 %3").arg("用例", -32).arg("ns/op", 14).arg("次数", 12) << Qt::endl;
+
+    QFile jsonFile;
+    if (parser.isSet(jsonOpt)) {
+        jsonFile.setFileName(parser.value(jsonOpt));
+        if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            out << "无法写入 " << jsonFile.fileName() << Qt::endl;
+            return 1;
+        }
+    }
+
+    const QString filter = parser.value(filterOpt);
+    const QString timestamp = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    for (const BenchCase &c : cases) {
+        if (!filter.isEmpty() && !c.name.contains(filter)) continue;
+
+        BenchResult r = runCase(c, minNs);
+        out << QString("%1 %2 %3").arg(r.name, -32).arg(r.nsPerOp, 14, 'f', 1).arg(r.iterations, 12) << Qt::endl;
+
+        if (jsonFile.isOpen()) {
+            QJsonObject line;
+            line["commit"] = commit;
+            line["time"] = timestamp;
+            line["name"] = r.name;
+            line["ns_per_op"] = r.nsPerOp;
+            line["iterations"] = double(r.iterations);
+            jsonFile.write(QJsonDocument(line).toJson(QJsonDocument::Compact) + '\n');
+        }
+    }
+    return 0;
+}
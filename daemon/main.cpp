@@ -0,0 +1,79 @@
+// ============================================================================
+// DroneShield_Daemon - 无界面后端
+// 运行与界面程序相同的 DeviceManager (侦测/诱骗/干扰/压制 + 录制回放 + 延迟统计)，
+// 日志 (DeviceManager 与各模块的 qDebug/qWarning) 经消息处理函数加时间戳后
+// 输出到标准输出。用于无显示器的现场主机和长时间压力测试。
+//
+// 用法: DroneShield_Daemon [--auto]
+// 配置与界面程序共用 <程序目录>/config.ini
+// ============================================================================
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QTimer>
+#include <csignal>
+#include <cstdio>
+#include "src/Backend/devicemanager.h"
+
+namespace {
+// 信号处理函数里只置标志，由定时器在事件循环中检查后正常退出
+// (保证 DeviceManager 析构，录制文件/延迟统计得以落盘)
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+extern "C" void onStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+// 唯一的日志出口：DeviceManager::log 已经 qDebug，这里不再另接 sigLogMessage
+void writeLog(QtMsgType type, const QMessageLogContext &, const QString &msg)
+{
+    const char *level = "";
+    switch (type) {
+    case QtWarningMsg: level = "[警告] "; break;
+    case QtCriticalMsg: level = "[严重] "; break;
+    case QtFatalMsg: level = "[致命] "; break;
+    default: break;
+    }
+    QByteArray line = (QDateTime::currentDateTime().toString("HH:mm:ss.zzz ") + level + msg).toLocal8Bit();
+    line.append('\n');
+    std::fwrite(line.constData(), 1, size_t(line.size()), stdout);
+    std::fflush(stdout);
+}
+}
+
+int main(int argc, char *argv[])
+{
+    qInstallMessageHandler(writeLog);
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("DroneShield_Daemon");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("DroneShield 无界面后端");
+    parser.addHelpOption();
+    QCommandLineOption autoOpt("auto", "启动后直接进入自动防御模式");
+    parser.addOption(autoOpt);
+    parser.process(app);
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    QTimer stopPoll;
+    QObject::connect(&stopPoll, &QTimer::timeout, &app, [&app]() {
+        if (g_stopRequested) app.quit();
+    });
+    stopPoll.start(200);
+
+    // 单线程运行：没有界面线程需要隔离
+    DeviceManager core;
+
+    if (parser.isSet(autoOpt)) {
+        core.setSystemMode(SystemMode::Auto);
+    }
+
+    QTimer::singleShot(0, &core, &DeviceManager::start);
+
+    int ret = app.exec();
+    core.reportLatency();
+    return ret;
+}
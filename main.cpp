@@ -2,7 +2,10 @@
 #include <QApplication>
 #include <QTimer>
 #include <QPushButton>
+#include <QThread>
 #include "src/Backend/devicemanager.h"
+#include "src/Utils/configloader.h"
+#include "src/Utils/eventloopmonitor.h"
 #include "src/AppStyle.h"
 
 int main(int argc, char *argv[])
@@ -13,8 +16,34 @@ int main(int argc, char *argv[])
     MainWindow w;
     w.show();
 
+    // 跨线程排队传递的数据类型
+    qRegisterMetaType<DroneInfo>();
+    qRegisterMetaType<ImageInfo>();
+    qRegisterMetaType<JammerConfigData>();
+    qRegisterMetaType<QList<DroneInfo>>();
+    qRegisterMetaType<QList<ImageInfo>>();
+    qRegisterMetaType<QList<JammerConfigData>>();
+    qRegisterMetaType<DroneTrackDiff>();
+    qRegisterMetaType<ImageTrackDiff>();
+    qRegisterMetaType<FrameTrace>();
+
     // 创建后端核心管理器
-    DeviceManager *systemCore = new DeviceManager(&w);
+    // 线程模式：DeviceManager 及全部驱动 (WebSocket/UDP/TCP/HTTP) 运行在独立线程，
+    // 界面重绘、卡片刷新不再拖慢自动防御决策；下面的 connect 自动变为排队连接
+    ConfigLoader config;
+    QThread *backendThread = nullptr;
+    DeviceManager *systemCore = nullptr;
+
+    if (config.isBackendThreaded()) {
+        backendThread = new QThread(&a);
+        backendThread->setObjectName("DroneShieldBackend");
+        systemCore = new DeviceManager();
+        systemCore->moveToThread(backendThread);
+        QObject::connect(backendThread, &QThread::started, systemCore, &DeviceManager::start);
+        QObject::connect(backendThread, &QThread::finished, systemCore, &QObject::deleteLater);
+    } else {
+        systemCore = new DeviceManager(&w);
+    }
 
     // =======================================================
     // 1. 下行信号：后端 -> UI (数据展示)
@@ -24,13 +53,13 @@ int main(int argc, char *argv[])
     QObject::connect(systemCore, &DeviceManager::sigLogMessage,
                      &w, &MainWindow::slotUpdateLog);
 
-    // 【修复】无人机列表 (旧代码是 slotUpdateTargets，已删除，改为 slotUpdateDroneList)
-    QObject::connect(systemCore, &DeviceManager::sigDroneList,
-                     &w, &MainWindow::slotUpdateDroneList);
+    // 无人机航迹增量 (新增/变化/超时移除)
+    QObject::connect(systemCore, &DeviceManager::sigDroneTracks,
+                     &w, &MainWindow::slotApplyDroneDiff);
 
-    // 【新增】图传/频谱列表
-    QObject::connect(systemCore, &DeviceManager::sigImageList,
-                     &w, &MainWindow::slotUpdateImageList);
+    // 图传/频谱航迹增量
+    QObject::connect(systemCore, &DeviceManager::sigImageTracks,
+                     &w, &MainWindow::slotApplyImageDiff);
 
     // 【新增】告警数量 (右上角红点)
     QObject::connect(systemCore, &DeviceManager::sigAlertCount,
@@ -40,6 +69,12 @@ int main(int argc, char *argv[])
     QObject::connect(systemCore, &DeviceManager::sigSelfPosition,
                      &w, &MainWindow::slotUpdateDevicePos);
 
+    // 侦测断线宽限期 (状态栏提示目标为最后已知状态)
+    QObject::connect(systemCore, &DeviceManager::sigDetectionStale,
+                     &w, &MainWindow::slotSetDetectionStale);
+    QObject::connect(systemCore, &DeviceManager::sigDetectionSourcesDown,
+                     &w, &MainWindow::slotSetDetectionSourcesDown);
+
 
     // =======================================================
     // 2. 上行信号：UI -> 后端 (控制指令)
@@ -96,5 +131,30 @@ int main(int argc, char *argv[])
     w.slotUpdateLog("系统核心已加载，正在连接侦测节点...");
     w.slotUpdateLog("等待 SocketIO 数据流...");
 
-    return a.exec();
+    // 界面线程利用率与地图瓦片缓存统计 (压测时与后端统计一起输出)
+    if (config.eventLoopReportSec() > 0) {
+        EventLoopMonitor *guiMonitor = new EventLoopMonitor("界面线程", &w);
+        QObject::connect(guiMonitor, &EventLoopMonitor::sigReport, &w,
+                         [&w](const QString &name, double utilization, double maxLagMs) {
+            w.slotUpdateLog(QString("[负载] %1 利用率 %2%  最大事件延迟 %3 ms")
+                                .arg(name).arg(utilization * 100.0, 0, 'f', 1).arg(maxLagMs, 0, 'f', 1));
+            w.slotUpdateLog("[负载] " + w.tileCacheReport());
+        });
+        guiMonitor->start(config.eventLoopReportSec() * 1000);
+    }
+
+    // 信号全部连接完成后再启动链路，避免丢失早期日志
+    if (backendThread) {
+        backendThread->start(QThread::HighPriority);
+    } else {
+        systemCore->start();
+    }
+
+    int ret = a.exec();
+
+    if (backendThread) {
+        backendThread->quit();
+        backendThread->wait();
+    }
+    return ret;
 }
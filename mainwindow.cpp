@@ -11,91 +11,11 @@
 #include <QCheckBox>
 
 #include "src/UI/radarview.h"
+#include "src/UI/targetlistmodel.h"
+#include "src/UI/targetcarddelegate.h"
 #include "src/UI/jammerconfdialog.h"
 #include "src/UI/relaydialog.h"
 
-// ============================================================================
-// 卡片创建函数
-// ============================================================================
-QWidget* MainWindow::createDroneCard(const DroneInfo &info) {
-    QFrame *card = new QFrame(this);
-    card->setFrameShape(QFrame::Box);
-    card->setFrameShadow(QFrame::Plain);
-
-    card->setStyleSheet(
-        "QFrame { background-color: #2D2D2D; color: #FFFFFF; border: 1px solid #505050; border-radius: 4px; }"
-        "QLabel { border: none; background: transparent; }"
-        );
-
-    QVBoxLayout *layout = new QVBoxLayout(card);
-    layout->setSpacing(4);
-    layout->setContentsMargins(10, 10, 10, 10);
-
-    QLabel *lblTitle = new QLabel(QString("机型: %1").arg(info.model_name), card);
-    QFont titleFont;
-    titleFont.setBold(true);
-    titleFont.setPointSize(14);
-    lblTitle->setFont(titleFont);
-    lblTitle->setStyleSheet("color: #FFD700;");
-    layout->addWidget(lblTitle);
-
-    auto addRow = [&](QString label, QString value) {
-        QLabel *lbl = new QLabel(QString("%1: %2").arg(label).arg(value), card);
-        lbl->setStyleSheet("font-size: 12px;");
-        layout->addWidget(lbl);
-    };
-
-    addRow("ID", info.uav_id);
-    addRow("距离", QString::number(info.distance, 'f', 1) + " m");
-    addRow("方位角", QString::number(info.azimuth, 'f', 1) + "°");
-    addRow("频率", QString::number(info.freq, 'f', 1) + " MHz");
-    addRow("高度", QString::number(info.height, 'f', 1) + " m");
-    addRow("无人机坐标", QString("%1, %2").arg(info.uav_lat, 0, 'f', 6).arg(info.uav_lng, 0, 'f', 6));
-    addRow("飞手坐标", QString("%1, %2").arg(info.pilot_lat, 0, 'f', 6).arg(info.pilot_lng, 0, 'f', 6));
-    addRow("飞手距离", QString::number(info.pilot_distance, 'f', 1) + " m");
-    addRow("速度", info.velocity);
-    addRow("UUID", info.uuid);
-
-    return card;
-}
-
-QWidget* MainWindow::createImageCard(const ImageInfo &info) {
-    QFrame *card = new QFrame(this);
-    card->setFrameShape(QFrame::Box);
-    card->setFrameShadow(QFrame::Plain);
-
-    card->setStyleSheet(
-        "QFrame { background-color: #2D2D2D; color: #FFFFFF; border: 1px solid #505050; border-radius: 4px; }"
-        "QLabel { border: none; background: transparent; }"
-        );
-
-    QVBoxLayout *layout = new QVBoxLayout(card);
-    layout->setSpacing(4);
-    layout->setContentsMargins(10, 10, 10, 10);
-
-    // 根据类型显示不同标题颜色
-    // Type 1 = FPV (0x06), Type 0 = Image/Spectrum (0x07)
-    QString typeStr = (info.type == 1) ? "信号: FPV (0x06)" : "信号: 图传 (0x07)";
-    QLabel *lblTitle = new QLabel(typeStr, card);
-    QFont titleFont;
-    titleFont.setBold(true);
-    titleFont.setPointSize(14);
-    lblTitle->setFont(titleFont);
-
-    // FPV用蓝色，图传用绿色区分
-    lblTitle->setStyleSheet(info.type == 1 ? "color: #00BFFF;" : "color: #32CD32;");
-    layout->addWidget(lblTitle);
-
-    layout->addWidget(new QLabel(QString("ID: %1").arg(info.id), card));
-    layout->addWidget(new QLabel(QString("频率: %1 MHz").arg(info.freq, 0, 'f', 1), card));
-    layout->addWidget(new QLabel(QString("强度: %1").arg(info.amplitude, 0, 'f', 1), card));
-
-    QDateTime time = QDateTime::fromMSecsSinceEpoch(QDateTime::currentMSecsSinceEpoch());
-    layout->addWidget(new QLabel(QString("时间: %1").arg(time.toString("HH:mm:ss")), card));
-
-    return card;
-}
-
 // ============================================================================
 // 主窗口构造
 // ============================================================================
@@ -210,9 +130,7 @@ MainWindow::MainWindow(QWidget *parent)
     rightLayout->addWidget(controlGroup);
     ui->gridLayout_Main->addWidget(rightPanel, 0, 2, 2, 1);
 
-    // 5. 初始化
-    m_deviceManager = new DeviceManager(this);
-
+    // 5. 初始化 (后端 DeviceManager 由 main.cpp 创建并连接，可运行在独立线程)
     m_uiTimer = new QTimer(this);
     m_uiTimer->setInterval(500);
     connect(m_uiTimer, &QTimer::timeout, this, &MainWindow::onUiRefreshTimeout);
@@ -271,25 +189,27 @@ void MainWindow::setupLeftPanel()
     m_leftStack = new QStackedWidget(this);
     mainLayout->addWidget(m_leftStack);
 
-    auto createListContainer = [&](QWidget*& container, QVBoxLayout*& layout) {
-        QScrollArea *scroll = new QScrollArea();
-        scroll->setWidgetResizable(true);
-        scroll->setStyleSheet("background-color: #1E1E1E; border: none;");
+    // 卡片由代理直接绘制，三个列表共用一个代理
+    TargetCardDelegate *cardDelegate = new TargetCardDelegate(this);
 
-        container = new QWidget();
-        container->setStyleSheet("background: transparent;");
+    auto createListView = [&](QListView*& view, TargetListModel*& model) {
+        model = new TargetListModel(this);
 
-        layout = new QVBoxLayout(container);
-        layout->setAlignment(Qt::AlignTop);
-        layout->setSpacing(5);
+        view = new QListView();
+        view->setModel(model);
+        view->setItemDelegate(cardDelegate);
+        view->setUniformItemSizes(true); // 同一列表的卡片行数固定
+        view->setSelectionMode(QAbstractItemView::NoSelection);
+        view->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+        view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        view->setStyleSheet("QListView { background-color: #1E1E1E; border: none; }");
 
-        scroll->setWidget(container);
-        m_leftStack->addWidget(scroll);
+        m_leftStack->addWidget(view);
     };
 
-    createListContainer(m_droneContainer, m_droneLayout); // Index 0: 无人机
-    createListContainer(m_fpvContainer,   m_fpvLayout);   // Index 1: FPV
-    createListContainer(m_imageContainer, m_imageLayout); // Index 2: 图传
+    createListView(m_droneView, m_droneModel); // Index 0: 无人机
+    createListView(m_fpvView,   m_fpvModel);   // Index 1: FPV
+    createListView(m_imageView, m_imageModel); // Index 2: 图传
 
     // 3. 切换逻辑
     auto updateBtnState = [&](int index) {
@@ -308,35 +228,60 @@ void MainWindow::setupLeftPanel()
 // 数据处理槽 (分流到不同的 Cache)
 // ============================================================================
 
+QString MainWindow::tileCacheReport() const
+{
+    TileCacheStats s = m_radar->tileCacheStats();
+    return QString("地图瓦片 命中率 %1%  缓存 %2 张 %3/%4 MB  解码 %5 次 平均 %6 ms 最大 %7 ms")
+        .arg(s.hitRate() * 100.0, 0, 'f', 1)
+        .arg(s.tiles)
+        .arg(s.memoryKB / 1024.0, 0, 'f', 1)
+        .arg(s.budgetKB / 1024.0, 0, 'f', 0)
+        .arg(s.decodes)
+        .arg(s.avgDecodeMs(), 0, 'f', 2)
+        .arg(s.decodeNsMax / 1e6, 0, 'f', 2);
+}
+
 void MainWindow::slotUpdateLog(const QString &msg)
 {
     QString timeStr = QDateTime::currentDateTime().toString("[HH:mm:ss] ");
     ui->textLog->append(timeStr + msg);
 }
 
-void MainWindow::slotUpdateDroneList(const QList<DroneInfo> &drones)
+void MainWindow::slotApplyDroneDiff(const DroneTrackDiff &diff)
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    for (const auto &d : drones) {
-        m_droneCache.insert(d.uav_id, d);
-        m_lastSeenTime.insert(d.uav_id, now);
+    // 只处理发生变化的目标，模型只通知对应的行
+    auto store = [this](const DroneInfo &d) {
+        QString key = trackKey(d);
+        m_droneCache.insert(key, d);
+        m_droneModel->upsertDrone(key, d);
+    };
+    for (const auto &d : diff.added) store(d);
+    for (const auto &d : diff.updated) store(d);
+    for (const auto &key : diff.removed) {
+        m_droneCache.remove(key);
+        m_droneModel->removeTarget(key);
     }
 }
 
-void MainWindow::slotUpdateImageList(const QList<ImageInfo> &images)
+void MainWindow::slotApplyImageDiff(const ImageTrackDiff &diff)
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    for (const auto &img : images) {
+    auto store = [this](const ImageInfo &img) {
         // 根据 Type 分流
         if (img.type == 1) {
-            // Type 1 = FPV (0x06) -> 存入 FPV Cache
-            m_fpvCache.insert(img.id, img);
-            m_lastSeenTime.insert(img.id, now);
+            // Type 1 = FPV (0x06)
+            m_imageModel->removeTarget(img.id);
+            m_fpvModel->upsertImage(img.id, img);
         } else {
-            // Type 0 = Image/Spectrum (0x07) -> 存入 Image Cache
-            m_imageCache.insert(img.id, img);
-            m_lastSeenTime.insert(img.id, now);
+            // Type 0 = Image/Spectrum (0x07)
+            m_fpvModel->removeTarget(img.id);
+            m_imageModel->upsertImage(img.id, img);
         }
+    };
+    for (const auto &img : diff.added) store(img);
+    for (const auto &img : diff.updated) store(img);
+    for (const auto &key : diff.removed) {
+        m_fpvModel->removeTarget(key);
+        m_imageModel->removeTarget(key);
     }
 }
 
@@ -350,100 +295,55 @@ void MainWindow::slotUpdateDevicePos(double lat, double lng)
     if (m_radar) m_radar->setCenterPosition(lat, lng);
 }
 
-// ============================================================================
-// 定时刷新逻辑
-// ============================================================================
-void MainWindow::onUiRefreshTimeout()
+void MainWindow::slotSetDetectionStale(bool stale)
 {
-    // 1. 清理过期
-    cleanExpiredTargets();
-
-    // 2. 更新按钮文字
-    m_btnDrone->setText(QString("无人机 (%1)").arg(m_droneCache.size()));
-    m_btnFPV->setText(QString("FPV (%1)").arg(m_fpvCache.size()));
-    m_btnImage->setText(QString("图传 (%1)").arg(m_imageCache.size()));
-
-    // 3. 刷新当前页
-    int idx = m_leftStack->currentIndex();
-
-    if (idx == 0) { // 无人机
-        QLayoutItem *child;
-        while ((child = m_droneLayout->takeAt(0)) != nullptr) {
-            if (child->widget()) delete child->widget();
-            delete child;
-        }
-        for (const auto &info : m_droneCache) {
-            m_droneLayout->addWidget(createDroneCard(info));
-        }
-
-        QList<RadarTarget> mapTargets;
-        for (const auto &d : m_droneCache) {
-            RadarTarget t;
-            t.id = d.uav_id;
-            t.lat = d.uav_lat;
-            t.lng = d.uav_lng;
-            t.angle = d.azimuth;
-            mapTargets.append(t);
-        }
-        if (m_radar) m_radar->updateTargets(mapTargets);
-
-        if (m_droneCache.isEmpty()) {
-            ui->label_SystemStatus->setText("系统状态: 扫描中...");
-            ui->label_SystemStatus->setStyleSheet("color: #00ff00;");
-        } else {
-            ui->label_SystemStatus->setText(QString("系统状态: 发现威胁 (%1)").arg(m_droneCache.size()));
-            ui->label_SystemStatus->setStyleSheet("color: #ff0000; font-weight: bold; font-size: 14px;");
-        }
-    }
-    else if (idx == 1) { // FPV
-        QLayoutItem *child;
-        while ((child = m_fpvLayout->takeAt(0)) != nullptr) {
-            if (child->widget()) delete child->widget();
-            delete child;
-        }
-        for (const auto &info : m_fpvCache) {
-            m_fpvLayout->addWidget(createImageCard(info));
-        }
-    }
-    else if (idx == 2) { // 图传
-        QLayoutItem *child;
-        while ((child = m_imageLayout->takeAt(0)) != nullptr) {
-            if (child->widget()) delete child->widget();
-            delete child;
-        }
-        for (const auto &info : m_imageCache) {
-            m_imageLayout->addWidget(createImageCard(info));
-        }
-    }
+    m_detectionStale = stale;
 }
 
-void MainWindow::cleanExpiredTargets()
+void MainWindow::slotSetDetectionSourcesDown(const QStringList &names)
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    int timeout = 4000;
-
-    auto itD = m_droneCache.begin();
-    while (itD != m_droneCache.end()) {
-        if (now - m_lastSeenTime.value(itD.key(), 0) > timeout) {
-            m_lastSeenTime.remove(itD.key());
-            itD = m_droneCache.erase(itD);
-        } else ++itD;
-    }
+    m_detectionSourcesDown = names;
+}
 
-    auto itF = m_fpvCache.begin();
-    while (itF != m_fpvCache.end()) {
-        if (now - m_lastSeenTime.value(itF.key(), 0) > timeout) {
-            m_lastSeenTime.remove(itF.key());
-            itF = m_fpvCache.erase(itF);
-        } else ++itF;
+// ============================================================================
+// 定时刷新逻辑
+// ============================================================================
+void MainWindow::onUiRefreshTimeout()
+{
+    // 列表行已随航迹增量实时更新，这里只刷新计数、雷达与状态栏
+    // 1. 更新按钮文字 (过期目标已由后端航迹库移除)
+    m_btnDrone->setText(QString("无人机 (%1)").arg(m_droneModel->rowCount()));
+    m_btnFPV->setText(QString("FPV (%1)").arg(m_fpvModel->rowCount()));
+    m_btnImage->setText(QString("图传 (%1)").arg(m_imageModel->rowCount()));
+
+    // 2. 雷达目标
+    QList<RadarTarget> mapTargets;
+    mapTargets.reserve(m_droneCache.size());
+    for (const auto &d : m_droneCache) {
+        RadarTarget t;
+        t.id = d.uav_id;
+        t.lat = d.uav_lat;
+        t.lng = d.uav_lng;
+        t.angle = d.azimuth;
+        mapTargets.append(t);
     }
-
-    auto itI = m_imageCache.begin();
-    while (itI != m_imageCache.end()) {
-        if (now - m_lastSeenTime.value(itI.key(), 0) > timeout) {
-            m_lastSeenTime.remove(itI.key());
-            itI = m_imageCache.erase(itI);
-        } else ++itI;
+    if (m_radar) m_radar->updateTargets(mapTargets);
+
+    // 3. 状态栏：有目标时始终显示威胁 (宽限期内注明含最后已知目标)，离线数据源附在后面
+    QString links;
+    if (!m_detectionSourcesDown.isEmpty()) links = QString(" | 侦测离线: %1").arg(m_detectionSourcesDown.join(", "));
+    if (!m_droneCache.isEmpty()) {
+        ui->label_SystemStatus->setText(QString("系统状态: 发现威胁 (%1)%2%3")
+                                            .arg(m_droneCache.size())
+                                            .arg(m_detectionStale ? " 含最后已知目标" : "")
+                                            .arg(links));
+        ui->label_SystemStatus->setStyleSheet("color: #ff0000; font-weight: bold; font-size: 14px;");
+    } else if (!links.isEmpty()) {
+        ui->label_SystemStatus->setText("系统状态: 扫描中..." + links);
+        ui->label_SystemStatus->setStyleSheet("color: #ffaa00; font-weight: bold;");
+    } else {
+        ui->label_SystemStatus->setText("系统状态: 扫描中...");
+        ui->label_SystemStatus->setStyleSheet("color: #00ff00;");
     }
 }
 
@@ -468,12 +368,6 @@ void MainWindow::handleSpoofCheckBoxMutex(QCheckBox* current)
 
 void MainWindow::initConnections()
 {
-    connect(m_deviceManager, &DeviceManager::sigLogMessage, this, &MainWindow::slotUpdateLog);
-    connect(m_deviceManager, &DeviceManager::sigDroneList,  this, &MainWindow::slotUpdateDroneList);
-    connect(m_deviceManager, &DeviceManager::sigImageList,  this, &MainWindow::slotUpdateImageList);
-    connect(m_deviceManager, &DeviceManager::sigAlertCount, this, &MainWindow::slotUpdateAlertCount);
-    connect(m_deviceManager, &DeviceManager::sigSelfPosition, this, &MainWindow::slotUpdateDevicePos);
-
     connect(m_autoSwitch, &ToggleSwitch::toggled, this, [this](bool checked){
         emit sigSetAutoMode(checked);
         slotUpdateLog(checked ? ">>> [模式] 切换至自动接管 (AUTO)" : ">>> [模式] 切换至手动操作 (MANUAL)");
@@ -10,23 +10,25 @@
 #include <QWidget>
 #include <QCheckBox>
 #include <QStackedWidget>
+#include <QListView>
 #include <QMap>
 #include <QTimer>
 #include <QDateTime>
 
 // 引入统一数据结构
 #include "src/Backend/DataStructs.h"
+#include "src/Backend/trackstore.h"
 
 // 引入自定义控件
 #include "src/UI/toggleswitch.h"
 #include "src/Backend/Drivers/jammerdriver.h"
-#include "src/Backend/devicemanager.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
 class RadarView;
+class TargetListModel;
 
 class MainWindow : public QMainWindow
 {
@@ -36,15 +38,22 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // 地图瓦片缓存统计 (命中率 / 内存 / 解码耗时，启动以来累计)，随负载统计定期输出
+    QString tileCacheReport() const;
+
 public slots:
     void slotUpdateLog(const QString &msg);
 
-    // 数据接收槽
-    void slotUpdateDroneList(const QList<DroneInfo> &drones);
-    void slotUpdateImageList(const QList<ImageInfo> &images);
+    // 数据接收槽 (后端航迹库推送的增量，超时清理已在后端完成)
+    void slotApplyDroneDiff(const DroneTrackDiff &diff);
+    void slotApplyImageDiff(const ImageTrackDiff &diff);
 
     void slotUpdateAlertCount(int count);
     void slotUpdateDevicePos(double lat, double lng);
+    // 侦测断线：目标保留为最后已知状态，状态栏提示
+    void slotSetDetectionStale(bool stale);
+    // 离线的侦测数据源 (状态栏单独显示，不影响威胁提示)
+    void slotSetDetectionSourcesDown(const QStringList &names);
 
     // 定时刷新界面
     void onUiRefreshTimeout();
@@ -69,7 +78,6 @@ private:
     Ui::MainWindow *ui;
     RadarView *m_radar;
     ToggleSwitch *m_autoSwitch;
-    DeviceManager *m_deviceManager;
 
     // === 左侧面板控件 ===
     QStackedWidget *m_leftStack;
@@ -79,22 +87,20 @@ private:
     QPushButton *m_btnFPV;   // 0x06 FPV (原频谱位置)
     QPushButton *m_btnImage; // 0x07 图传 (原图传位置)
 
-    // 【修改】三个列表容器
-    QWidget *m_droneContainer;
-    QVBoxLayout *m_droneLayout;
+    // 【修改】三个列表 (模型/视图，只更新变化的行)
+    QListView *m_droneView;
+    TargetListModel *m_droneModel; // 0x02
 
-    QWidget *m_fpvContainer; // FPV 容器
-    QVBoxLayout *m_fpvLayout;
+    QListView *m_fpvView;
+    TargetListModel *m_fpvModel;   // 0x06
 
-    QWidget *m_imageContainer; // 图传容器
-    QVBoxLayout *m_imageLayout;
+    QListView *m_imageView;
+    TargetListModel *m_imageModel; // 0x07 (图传/Spectrum)
 
-    // === 【核心】数据缓存池 ===
+    // === 【核心】数据缓存池 (雷达绘制用) ===
     QMap<QString, DroneInfo> m_droneCache; // 0x02
-    QMap<QString, ImageInfo> m_fpvCache;   // 0x06
-    QMap<QString, ImageInfo> m_imageCache; // 0x07 (图传/Spectrum)
-
-    QMap<QString, qint64> m_lastSeenTime;
+    bool m_detectionStale = false;
+    QStringList m_detectionSourcesDown;
 
     QTimer *m_uiTimer;
 
@@ -111,11 +117,6 @@ private:
     void setupLeftPanel();
 
     void handleSpoofCheckBoxMutex(QCheckBox* current);
-    void cleanExpiredTargets();
-
-    // === 辅助函数 ===
-    QWidget* createDroneCard(const DroneInfo &info);
-    QWidget* createImageCard(const ImageInfo &info);
 };
 
 #endif // MAINWINDOW_H
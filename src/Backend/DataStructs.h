@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QList>
+#include <QMetaType>
 
 // ==========================================
 // 1. 干扰配置数据 (这是之前遗漏的结构体)
@@ -59,4 +60,9 @@ struct ImageInfo {
     int first = 0;          // 轮次标识
 };
 
+// 后端运行在独立线程时，以上结构需跨线程排队传递
+Q_DECLARE_METATYPE(JammerConfigData)
+Q_DECLARE_METATYPE(DroneInfo)
+Q_DECLARE_METATYPE(ImageInfo)
+
 #endif // DATASTRUCTS_H
@@ -1,187 +1,181 @@
 #include "detectiondriver.h"
 #include <QDebug>
+#include <QStringList>
 
-DetectionDriver::DetectionDriver(QObject *parent) : QObject(parent)
+DetectionDriver::DetectionDriver(const Config &config, const Settings &settings, QObject *parent)
+    : DetectionSource(config, settings, parent)
 {
-    m_webSocket = new QWebSocket();
-
-    connect(m_webSocket, &QWebSocket::connected, this, &DetectionDriver::onConnected);
-    connect(m_webSocket, &QWebSocket::disconnected, this, &DetectionDriver::onDisconnected);
-    connect(m_webSocket, &QWebSocket::textMessageReceived, this, &DetectionDriver::onTextMessageReceived);
-
-    // 重连定时器
-    m_reconnectTimer = new QTimer(this);
-    m_reconnectTimer->setInterval(5000);
-    connect(m_reconnectTimer, &QTimer::timeout, this, &DetectionDriver::onReconnectTimeout);
-
-    // 【新增】心跳定时器
-    m_heartbeatTimer = new QTimer(this);
-    connect(m_heartbeatTimer, &QTimer::timeout, this, &DetectionDriver::onHeartbeatTimeout);
+    // 以 this 为父对象，保证 moveToThread 时随驱动一起迁移到后端线程
+    m_socket = new SocketIoClient(config.name.isEmpty() ? QString("侦测") : "侦测:" + config.name, this);
+
+    // 断线后从几十毫秒起指数退避重连
+    SocketIoClient::Options options;
+    options.reconnectMinMs = m_settings.reconnectMinMs;
+    options.reconnectMaxMs = m_settings.reconnectMaxMs;
+    m_socket->setOptions(options);
+
+    connect(m_socket, &SocketIoClient::connected, this, &DetectionDriver::onConnected);
+    connect(m_socket, &SocketIoClient::disconnected, this, &DetectionDriver::onDisconnected);
+    connect(m_socket, &SocketIoClient::sigLog, this, &DetectionDriver::sigLog);
+
+    // 订阅业务事件
+    m_socket->on("droneStatus", [this](const SocketIoClient::Event &e) { onDroneStatus(e); });
+    m_socket->on("imageStatus", [this](const SocketIoClient::Event &e) { onImageStatus(e); });
+    m_socket->on("info", [this](const SocketIoClient::Event &e) { onDeviceInfo(e); });
+
+    // 录制：所有原始文本帧 (含握手/心跳) 原样写入，二进制附件紧随其头部帧写入
+    m_socket->setTextTap([this](const QString &message) {
+        if (m_recorder) m_recorder->recordText(StreamLog::DetectionText, message);
+    });
+    m_socket->setBinaryTap([this](const QByteArray &attachment) {
+        if (m_recorder) m_recorder->record(StreamLog::DetectionBinary, attachment);
+    });
 }
 
 DetectionDriver::~DetectionDriver()
 {
-    m_webSocket->close();
+    m_socket->close();
+}
+
+void DetectionDriver::start()
+{
+    if (!m_config.url.isEmpty()) startWork(m_config.url);
 }
 
 void DetectionDriver::startWork(const QString &url)
 {
-    m_targetUrl = url;
-    m_webSocket->open(QUrl(m_targetUrl));
-    emit sigLog("[侦测] 正在连接 WebSocket...");
+    m_socket->connectToServer(url);
+    emit sigLog(logTag() + " 正在连接 WebSocket...");
 }
 
 void DetectionDriver::stopWork()
 {
-    m_reconnectTimer->stop();
-    m_heartbeatTimer->stop(); // 停止心跳
-    m_webSocket->close();
+    m_socket->close();
 }
 
 void DetectionDriver::onConnected()
 {
-    emit sigLog("[侦测] WebSocket 已连接");
-    m_reconnectTimer->stop();
-    // 注意：心跳定时器在收到握手包(0...)后才启动
+    emit sigLog(logTag() + " WebSocket 已连接");
+    emit sigLinkStateChanged(true);
 }
 
 void DetectionDriver::onDisconnected()
 {
-    emit sigLog("[侦测] WebSocket 断开，5秒后重连...");
-    m_heartbeatTimer->stop(); // 断开时必须停止心跳
-    m_reconnectTimer->start();
-
-    // 断开时，发送空列表清空 UI，避免显示过时数据
-    emit sigDroneListUpdated(QList<DroneInfo>());
-}
-
-void DetectionDriver::onReconnectTimeout()
-{
-    m_webSocket->open(QUrl(m_targetUrl));
+    // 不再发送空列表清空目标：短暂断线时保留最后已知目标 (标记为过时)，
+    // 超过宽限期仍未恢复再由 DeviceManager 清除
+    emit sigLog(QString("%1 WebSocket 断开，正在重连 (保留最后已知目标 %2 ms)")
+                    .arg(logTag()).arg(m_settings.staleGraceMs));
+    emit sigLinkStateChanged(false);
 }
 
-// 【新增】心跳发送
-void DetectionDriver::onHeartbeatTimeout()
+QString DetectionDriver::linkReport() const
 {
-    if (m_webSocket->isValid()) {
-        // Socket.IO 心跳包就是简单的字符串 "2"
-        m_webSocket->sendTextMessage("2");
-        // qDebug() << "[侦测] 发送心跳: 2";
+    const SocketIoClient::LinkStats &s = m_socket->linkStats();
+    if (s.drops == 0) return QString();
+
+    QString report = QString("断开 %1 次").arg(s.drops);
+    if (s.recoveries > 0) {
+        report += QString(" 恢复耗时 最近 %1 ms / 平均 %2 ms / 最大 %3 ms")
+                      .arg(s.lastRecoverMs)
+                      .arg(s.totalRecoverMs / qint64(s.recoveries))
+                      .arg(s.maxRecoverMs);
     }
+    if (!m_socket->isConnected()) report += " (当前断开)";
+    return report;
 }
 
 // ============================================================================
-// 核心：消息解析
+// 事件处理：直接在 WebSocket 交付的 UTF-16 缓冲区上流式解析数据部分
 // ============================================================================
-void DetectionDriver::onTextMessageReceived(const QString &message)
+// 文本帧在线路上是 UTF-8，QWebSocket 交付的是 UTF-16：按码元换算回字节数
+quint64 DetectionDriver::utf8Size(QStringView text)
 {
-    // 1. 处理握手包 (0...)
-    // 格式: 0{"sid":"...","pingInterval":25000,"pingTimeout":20000}
-    if (message.startsWith("0")) {
-        handleHandshake(message.mid(1));
-        return;
+    quint64 bytes = 0;
+    for (QChar c : text) {
+        char16_t u = c.unicode();
+        if (u < 0x80) bytes += 1;
+        else if (u < 0x800 || c.isSurrogate()) bytes += 2; // 代理对两个码元合计 4 字节
+        else bytes += 3;
     }
+    return bytes;
+}
 
-    // 2. 处理服务器的心跳回执 (3)
-    if (message == "3") {
-        // 收到 Pong，连接正常，忽略即可
-        return;
-    }
-
-    // 3. 处理业务数据 (42...)
-    if (message.startsWith("42")) {
-        QString jsonStr = message.mid(2);
-        QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
-        if (!doc.isArray()) return;
-
-        QJsonArray rootArr = doc.array();
-        if (rootArr.isEmpty()) return;
-
-        QString eventName = rootArr[0].toString();
-        if (rootArr.size() < 2) return;
-        QJsonValue dataVal = rootArr[1];
-
-        if (eventName == "droneStatus") {
-            if (dataVal.isArray()) parseDroneStatus(dataVal.toArray());
-        }
-        else if (eventName == "imageStatus") {
-            if (dataVal.isArray()) parseImageStatus(dataVal.toArray());
-        }
-        else if (eventName == "info") {
-            if (dataVal.isObject()) parseDeviceInfo(dataVal.toObject());
-        }
-    }
+FrameTrace DetectionDriver::makeTrace(const SocketIoClient::Event &event)
+{
+    // 帧到达时刻 (用于统计 侦测 -> 指令 延迟)
+    FrameTrace trace;
+    trace.ingestNs = event.ingestNs;
+    trace.parsedNs = LatencyClock::nowNs();
+    trace.seq = ++m_frameSeq;
+    return trace;
 }
 
-// 【新增】解析握手信息并启动心跳
-void DetectionDriver::handleHandshake(const QString &payload)
+bool DetectionDriver::parseEvent(const SocketIoClient::Event &event,
+                                 bool (DetectionFrameParser::*text)(QStringView),
+                                 bool (DetectionFrameParser::*bytes)(QByteArrayView))
 {
-    QJsonDocument doc = QJsonDocument::fromJson(payload.toUtf8());
-    if (doc.isObject()) {
-        QJsonObject obj = doc.object();
-        if (obj.contains("pingInterval")) {
-            int interval = obj["pingInterval"].toInt();
-            // 建议比服务器要求的时间稍微短一点，比如减去 5秒，确保不超时
-            // 如果服务器说 25000，我们 20000 发一次
-            int timerInterval = (interval > 5000) ? (interval - 5000) : interval;
-
-            m_heartbeatTimer->setInterval(timerInterval);
-            m_heartbeatTimer->start();
-
-            emit sigLog(QString("[侦测] 握手成功，心跳间隔: %1ms").arg(timerInterval));
+    qint64 startNs = LatencyClock::nowNs();
+    PayloadFormat format = PayloadText;
+    quint64 wireBytes = 0;
+    bool ok = false;
+
+    if (!event.attachments) {
+        ok = (m_parser.*text)(event.data);
+    } else {
+        // 数据部分为 {"_placeholder":true,"num":0}，实际内容在第一个附件
+        const QByteArray &raw = event.attachments->first();
+        wireBytes += quint64(raw.size());
+        char lead = raw.isEmpty() ? 0 : raw.at(0);
+        if (lead == '[' || lead == '{') {
+            format = PayloadBinary;
+            ok = (m_parser.*bytes)(QByteArrayView(raw));
+        } else {
+            format = PayloadCompressed;
+            // qUncompress 每次返回新分配的缓冲 (解压耗时计入该格式的解析时间)
+            QByteArray inflated = qUncompress(raw);
+            ok = !inflated.isEmpty() && (m_parser.*bytes)(QByteArrayView(inflated));
         }
     }
+
+    PayloadStats &stats = m_payloadStats[format];
+    ++stats.frames;
+    stats.parseNs += LatencyClock::nowNs() - startNs;
+    // 文本帧按 UTF-8 编码后的字节数统计 (机型名等可能含中文)，不计入解析时间
+    stats.wireBytes += wireBytes + utf8Size(event.packet);
+    return ok;
 }
 
-// ... (以下 parseDroneStatus, parseImageStatus, parseDeviceInfo 保持不变) ...
+void DetectionDriver::onDroneStatus(const SocketIoClient::Event &event)
+{
+    if (!parseEvent(event, &DetectionFrameParser::parseDrones, &DetectionFrameParser::parseDrones)) return;
+    emit sigDroneListUpdated(m_parser.drones(), makeTrace(event));
+}
 
-void DetectionDriver::parseDroneStatus(const QJsonArray &dataArr)
+void DetectionDriver::onImageStatus(const SocketIoClient::Event &event)
 {
-    QList<DroneInfo> droneList;
-    for (const auto &item : dataArr) {
-        QJsonObject obj = item.toObject();
-        if (!obj.contains("uav_info")) continue;
-        QJsonObject info = obj["uav_info"].toObject();
-
-        DroneInfo drone;
-        drone.uav_id = info["uav_id"].toString();
-        drone.model_name = info["model_name"].toString();
-        drone.freq = info["freq"].toDouble();
-        drone.whiteList = info["whiteList"].toBool();
-
-        QString latStr = info["uav_lat"].toString();
-        QString lngStr = info["uav_lng"].toString();
-        drone.uav_lat = latStr.toDouble();
-        drone.uav_lng = lngStr.toDouble();
-
-        QString distStr = info["distance"].toString();
-        if (distStr == "--") drone.distance = 0.0;
-        else drone.distance = distStr.toDouble();
-
-        droneList.append(drone);
-    }
-    emit sigDroneListUpdated(droneList);
+    if (!parseEvent(event, &DetectionFrameParser::parseImages, &DetectionFrameParser::parseImages)) return;
+    emit sigImageListUpdated(m_parser.images(), makeTrace(event));
 }
 
-void DetectionDriver::parseImageStatus(const QJsonArray &dataArr)
+void DetectionDriver::onDeviceInfo(const SocketIoClient::Event &event)
 {
-    QList<ImageInfo> imageList;
-    for (const auto &item : dataArr) {
-        QJsonObject obj = item.toObject();
-        ImageInfo img;
-        img.id = obj["id"].toString();
-        img.freq = obj["freq"].toDouble();
-        img.amplitude = obj["amplitude"].toDouble();
-        img.type = obj["type"].toInt();
-        if (img.id.endsWith("_fpv")) img.type = 1;
-        imageList.append(img);
-    }
-    emit sigImageListUpdated(imageList);
+    if (!parseEvent(event, &DetectionFrameParser::parseInfo, &DetectionFrameParser::parseInfo)) return;
+    emit sigDevicePositionUpdated(m_parser.infoLat(), m_parser.infoLng());
 }
 
-void DetectionDriver::parseDeviceInfo(const QJsonObject &dataObj)
+QString DetectionDriver::payloadReport()
 {
-    double lat = dataObj["lat"].toDouble();
-    double lng = dataObj["lng"].toDouble();
-    emit sigDevicePositionUpdated(lat, lng);
+    static const char *NAMES[PayloadFormatCount] = {"文本", "二进制", "压缩"};
+
+    QStringList parts;
+    for (int i = 0; i < PayloadFormatCount; ++i) {
+        const PayloadStats &s = m_payloadStats[i];
+        if (s.frames == 0) continue;
+        parts << QString("%1 %2 帧 平均 %3 B / %4 us")
+                     .arg(NAMES[i]).arg(s.frames)
+                     .arg(double(s.wireBytes) / s.frames, 0, 'f', 0)
+                     .arg(s.parseNs / 1000.0 / s.frames, 0, 'f', 1);
+    }
+    m_payloadStats.fill(PayloadStats());
+    return parts.join("  ");
 }
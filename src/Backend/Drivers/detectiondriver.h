@@ -3,53 +3,77 @@
 
 #include <QObject>
 #include <QList>
-#include <QTimer>
-#include <QtWebSockets/QWebSocket>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <array>
 #include "../DataStructs.h"
+#include "detectionsource.h"
+#include "detectionframeparser.h"
+#include "../latencytracer.h"
+#include "../streamlog.h"
+#include "../HAL/socketioclient.h"
 
-class DetectionDriver : public QObject
+// Socket.IO (WebSocket) 侦测数据源
+class DetectionDriver : public DetectionSource
 {
     Q_OBJECT
 public:
-    explicit DetectionDriver(QObject *parent = nullptr);
+    DetectionDriver(const Config &config, const Settings &settings, QObject *parent = nullptr);
+    explicit DetectionDriver(QObject *parent = nullptr) : DetectionDriver(Config(), Settings(), parent) {}
     ~DetectionDriver();
 
+    void start() override;
+    void stop() override { stopWork(); }
+
     void startWork(const QString &url);
     void stopWork();
 
-signals:
-    void sigDroneListUpdated(const QList<DroneInfo> &drones);
-    void sigImageListUpdated(const QList<ImageInfo> &images);
-    void sigDevicePositionUpdated(double lat, double lng);
-    void sigLog(const QString &msg);
+    // 录制收到的原始帧 (可为空)
+    void setRecorder(StreamRecorder *recorder) { m_recorder = recorder; }
+
+    // 载荷格式统计：每帧线上字节数与解析耗时 (文本 / 二进制 / 压缩)，输出后清零
+    QString payloadReport() override;
+    // 链路统计：断开次数与恢复耗时 (无断开时为空)
+    QString linkReport() const override;
+
+public slots:
+    // 回放入口：与 WebSocket 收到的帧走同一分发路径
+    void injectTextFrame(const QString &message) { m_socket->injectText(message); }
+    void injectBinaryFrame(const QByteArray &attachment) { m_socket->injectBinary(attachment); }
 
 private slots:
     void onConnected();
     void onDisconnected();
-    void onTextMessageReceived(const QString &message);
-    void onReconnectTimeout();
-
-    // 【新增】心跳发送槽函数
-    void onHeartbeatTimeout();
 
 private:
-    void parseDroneStatus(const QJsonArray &dataArr);
-    void parseImageStatus(const QJsonArray &dataArr);
-    void parseDeviceInfo(const QJsonObject &dataObj);
+    // Socket.IO 事件处理 (事件名由 SocketIoClient 查表分发)
+    void onDroneStatus(const SocketIoClient::Event &event);
+    void onImageStatus(const SocketIoClient::Event &event);
+    void onDeviceInfo(const SocketIoClient::Event &event);
+    FrameTrace makeTrace(const SocketIoClient::Event &event);
+
+    // 载荷格式：文本事件 42[...]；二进制事件 45x- 的附件为 UTF-8 JSON 或
+    // qCompress 压缩的 JSON (4 字节大端原始长度 + zlib 流)
+    enum PayloadFormat { PayloadText, PayloadBinary, PayloadCompressed, PayloadFormatCount };
+    struct PayloadStats {
+        quint64 frames = 0;
+        quint64 wireBytes = 0;
+        qint64 parseNs = 0;
+    };
+
+    // 按载荷格式取事件数据并解析 (text/bytes 为对应的解析入口)
+    bool parseEvent(const SocketIoClient::Event &event,
+                    bool (DetectionFrameParser::*text)(QStringView),
+                    bool (DetectionFrameParser::*bytes)(QByteArrayView));
+    static quint64 utf8Size(QStringView text); // 文本帧的 UTF-8 字节数
 
-    // 【新增】解析握手包，启动心跳
-    void handleHandshake(const QString &payload);
+    SocketIoClient *m_socket;
 
-    QWebSocket *m_webSocket;
-    QTimer *m_reconnectTimer;
+    quint64 m_frameSeq = 0;
+    StreamRecorder *m_recorder = nullptr;
 
-    // 【新增】心跳定时器
-    QTimer *m_heartbeatTimer;
+    // 【新增】流式解析器 (复用结果槽位，避免每帧构建 JSON DOM)
+    DetectionFrameParser m_parser;
 
-    QString m_targetUrl;
+    std::array<PayloadStats, PayloadFormatCount> m_payloadStats;
 };
 
 #endif // DETECTIONDRIVER_H
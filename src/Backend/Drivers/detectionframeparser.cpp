@@ -0,0 +1,585 @@
+#include "detectionframeparser.h"
+#include <cstddef>
+#include <type_traits>
+
+namespace {
+
+// 预分配槽位数，覆盖繁忙站点单帧的目标数量
+constexpr int kReserveSlots = 64;
+
+// 嵌套层数上限，防止恶意/损坏数据导致递归过深
+constexpr int kMaxDepth = 32;
+
+// ---------------------------------------------------------------------------
+// 字符片段 -> 数值 / 字符串 (分别对应 UTF-16 与 UTF-8 输入)
+// ---------------------------------------------------------------------------
+double toDouble(const char16_t *s, const char16_t *e)
+{
+    bool ok = false;
+    double v = QStringView(s, e - s).toDouble(&ok);
+    return ok ? v : 0.0;
+}
+
+double toDouble(const char *s, const char *e)
+{
+    bool ok = false;
+    double v = QByteArrayView(s, e - s).toDouble(&ok);
+    return ok ? v : 0.0;
+}
+
+void appendRun(QString &out, const char16_t *s, const char16_t *e)
+{
+    out.append(QStringView(s, e - s));
+}
+
+void appendRun(QString &out, const char *s, const char *e)
+{
+    out.append(QString::fromUtf8(s, e - s));
+}
+
+template <typename Char>
+char16_t unit(Char c)
+{
+    return char16_t(static_cast<std::make_unsigned_t<Char>>(c));
+}
+
+int hexValue(char16_t c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 键名比较：长度在编译期确定，不分配内存
+template <typename Char>
+struct KeyView {
+    const Char *s = nullptr;
+    const Char *e = nullptr;
+
+    template <std::size_t N>
+    bool operator==(const char (&lit)[N]) const {
+        if (e - s != qsizetype(N - 1)) return false;
+        for (std::size_t i = 0; i < N - 1; ++i) {
+            if (s[i] != Char(lit[i])) return false;
+        }
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 顺序读取器：只前进，不回溯，出错后停在末尾
+// ---------------------------------------------------------------------------
+template <typename Char>
+class JsonReader
+{
+public:
+    JsonReader(const Char *begin, const Char *end) : m_p(begin), m_end(end) {}
+
+    bool ok() const { return m_ok; }
+    const Char *position() const { return m_p; }
+
+    Char peek() {
+        skipWs();
+        return m_p < m_end ? *m_p : Char(0);
+    }
+
+    bool consume(char c) {
+        if (peek() == Char(c)) {
+            ++m_p;
+            return true;
+        }
+        return false;
+    }
+
+    bool expect(char c) {
+        if (consume(c)) return true;
+        fail();
+        return false;
+    }
+
+    // 读取字符串的原始片段 (不含引号)
+    bool rawString(KeyView<Char> &out, bool &hasEscape) {
+        hasEscape = false;
+        if (!expect('"')) return false;
+        out.s = m_p;
+        while (m_p < m_end) {
+            Char c = *m_p;
+            if (c == '"') {
+                out.e = m_p++;
+                return true;
+            }
+            if (c == '\\') {
+                if (m_end - m_p < 2) break;
+                hasEscape = true;
+                m_p += 2;
+                continue;
+            }
+            ++m_p;
+        }
+        fail();
+        return false;
+    }
+
+    bool key(KeyView<Char> &out) {
+        bool hasEscape = false;
+        return rawString(out, hasEscape) && expect(':');
+    }
+
+    // 字符串字段：兼容数字写法 (部分固件把编号发成数字)
+    QString string() {
+        Char c = peek();
+        if (c == '"') {
+            KeyView<Char> v;
+            bool hasEscape = false;
+            if (!rawString(v, hasEscape)) return QString();
+            return hasEscape ? unescape(v.s, v.e) : makeString(v.s, v.e);
+        }
+        if (c == 'n') {
+            skipScalar();
+            return QString();
+        }
+        const Char *s = m_p;
+        skipScalar();
+        return makeString(s, m_p);
+    }
+
+    // 数值字段：兼容 123.4 / "123.4" / "--" (无效值按 0 处理)
+    double number() {
+        Char c = peek();
+        if (c == '"') {
+            KeyView<Char> v;
+            bool hasEscape = false;
+            if (!rawString(v, hasEscape)) return 0.0;
+            return toDouble(v.s, v.e);
+        }
+        if (c == 't' || c == 'f' || c == 'n') {
+            const Char *s = m_p;
+            skipScalar();
+            return (m_p - s == 4 && *s == 't') ? 1.0 : 0.0;
+        }
+        const Char *s = m_p;
+        skipScalar();
+        return toDouble(s, m_p);
+    }
+
+    bool boolean() {
+        Char c = peek();
+        if (c == 't' || c == 'f' || c == 'n') {
+            const Char *s = m_p;
+            skipScalar();
+            return m_p - s == 4 && *s == 't';
+        }
+        if (c == '"') {
+            KeyView<Char> v;
+            bool hasEscape = false;
+            if (!rawString(v, hasEscape)) return false;
+            return v == "true" || v == "1";
+        }
+        return number() != 0.0;
+    }
+
+    // 跳过任意值 (未知字段 / 不关心的事件)
+    void skipValue(int depth = 0) {
+        if (depth > kMaxDepth) {
+            fail();
+            return;
+        }
+        Char c = peek();
+        if (c == '"') {
+            KeyView<Char> v;
+            bool hasEscape = false;
+            rawString(v, hasEscape);
+        } else if (c == '{') {
+            ++m_p;
+            if (consume('}')) return;
+            do {
+                KeyView<Char> k;
+                if (!key(k)) return;
+                skipValue(depth + 1);
+            } while (m_ok && consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++m_p;
+            if (consume(']')) return;
+            do {
+                skipValue(depth + 1);
+            } while (m_ok && consume(','));
+            expect(']');
+        } else {
+            skipScalar();
+        }
+    }
+
+private:
+    void fail() {
+        m_ok = false;
+        m_p = m_end;
+    }
+
+    void skipWs() {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) ++m_p;
+    }
+
+    // 数字 / true / false / null
+    void skipScalar() {
+        const Char *s = m_p;
+        while (m_p < m_end) {
+            Char c = *m_p;
+            if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') break;
+            ++m_p;
+        }
+        if (m_p == s) fail();
+    }
+
+    static QString makeString(const Char *s, const Char *e) {
+        QString out;
+        appendRun(out, s, e);
+        return out;
+    }
+
+    static QString unescape(const Char *s, const Char *e) {
+        QString out;
+        out.reserve(e - s);
+        const Char *run = s;
+        const Char *p = s;
+        while (p < e) {
+            if (*p != '\\') {
+                ++p;
+                continue;
+            }
+            appendRun(out, run, p);
+            ++p; // 已由 rawString 保证转义符后至少还有一个字符
+            switch (*p) {
+            case 'n': out.append(QChar('\n')); break;
+            case 'r': out.append(QChar('\r')); break;
+            case 't': out.append(QChar('\t')); break;
+            case 'b': out.append(QChar('\b')); break;
+            case 'f': out.append(QChar('\f')); break;
+            case 'u': {
+                int code = 0;
+                int i = 1;
+                for (; i <= 4 && p + i < e; ++i) {
+                    int h = hexValue(unit(p[i]));
+                    if (h < 0) break;
+                    code = code * 16 + h;
+                }
+                if (i == 5) {
+                    out.append(QChar(char16_t(code)));
+                    p += 4;
+                }
+                break;
+            }
+            default: out.append(QChar(unit(*p))); break; // \" \\ \/
+            }
+            run = ++p;
+        }
+        appendRun(out, run, e);
+        return out;
+    }
+
+    const Char *m_p;
+    const Char *m_end;
+    bool m_ok = true;
+};
+
+// ---------------------------------------------------------------------------
+// 业务结构：字段直接写入目标槽位
+// ---------------------------------------------------------------------------
+// 从 '{' 之后读到对应的 '}' (非空对象)
+template <typename Char>
+bool readDroneMembers(JsonReader<Char> &r, DroneInfo &d)
+{
+    do {
+        KeyView<Char> k;
+        if (!r.key(k)) return false;
+
+        if (k == "uav_id") d.uav_id = r.string();
+        else if (k == "model_name") d.model_name = r.string();
+        else if (k == "distance") d.distance = r.number();
+        else if (k == "azimuth") d.azimuth = r.number();
+        else if (k == "uav_lat") d.uav_lat = r.number();
+        else if (k == "uav_lng") d.uav_lng = r.number();
+        else if (k == "height" || k == "Height") d.height = r.number();
+        else if (k == "freq") d.freq = r.number();
+        else if (k == "velocity") d.velocity = r.string();
+        else if (k == "pilot_lat") d.pilot_lat = r.number();
+        else if (k == "pilot_lng") d.pilot_lng = r.number();
+        else if (k == "pilot_distance") d.pilot_distance = r.number();
+        else if (k == "whiteList") d.whiteList = r.boolean();
+        else if (k == "uuid") d.uuid = r.string();
+        else if (k == "img") d.img = static_cast<int>(r.number());
+        else if (k == "type") d.type = r.string();
+        else r.skipValue();
+    } while (r.ok() && r.consume(','));
+    return r.expect('}');
+}
+
+template <typename Char>
+bool readDrone(JsonReader<Char> &r, DroneInfo &d)
+{
+    if (!r.expect('{')) return false;
+    if (r.consume('}')) return true;
+    return readDroneMembers(r, d);
+}
+
+// droneStatus: [{"uav_info": {...}}, ...]，没有 uav_info 的条目直接跳过
+template <typename Char>
+bool readDroneArray(JsonReader<Char> &r, QList<DroneInfo> &out)
+{
+    if (!r.expect('[')) return false;
+    if (r.consume(']')) return true;
+    do {
+        if (r.peek() != Char('{')) {
+            r.skipValue();
+            continue;
+        }
+        r.expect('{');
+        if (r.consume('}')) continue;
+
+        bool found = false;
+        do {
+            KeyView<Char> k;
+            if (!r.key(k)) return false;
+            if (!found && k == "uav_info" && r.peek() == Char('{')) {
+                out.emplaceBack();
+                if (!readDrone(r, out.last())) return false;
+                found = true;
+            } else {
+                r.skipValue();
+            }
+        } while (r.ok() && r.consume(','));
+        if (!r.expect('}')) return false;
+    } while (r.ok() && r.consume(','));
+    return r.expect(']');
+}
+
+template <typename Char>
+bool readImage(JsonReader<Char> &r, ImageInfo &img)
+{
+    if (!r.expect('{')) return false;
+    if (r.consume('}')) return true;
+    do {
+        KeyView<Char> k;
+        if (!r.key(k)) return false;
+
+        if (k == "id") img.id = r.string();
+        else if (k == "freq") img.freq = r.number();
+        else if (k == "amplitude") img.amplitude = r.number();
+        else if (k == "type") img.type = static_cast<int>(r.number());
+        else if (k == "mes") img.mes = static_cast<long long>(r.number());
+        else if (k == "first") img.first = static_cast<int>(r.number());
+        else r.skipValue();
+    } while (r.ok() && r.consume(','));
+    if (!r.expect('}')) return false;
+
+    if (img.id.endsWith(QLatin1String("_fpv"))) img.type = 1;
+    return true;
+}
+
+template <typename Char>
+bool readImageArray(JsonReader<Char> &r, QList<ImageInfo> &out)
+{
+    if (!r.expect('[')) return false;
+    if (r.consume(']')) return true;
+    do {
+        if (r.peek() != Char('{')) {
+            r.skipValue();
+            continue;
+        }
+        out.emplaceBack();
+        if (!readImage(r, out.last())) return false;
+    } while (r.ok() && r.consume(','));
+    return r.expect(']');
+}
+
+template <typename Char>
+bool readDeviceInfo(JsonReader<Char> &r, double &lat, double &lng)
+{
+    lat = 0.0;
+    lng = 0.0;
+    if (!r.expect('{')) return false;
+    if (r.consume('}')) return true;
+    do {
+        KeyView<Char> k;
+        if (!r.key(k)) return false;
+        if (k == "lat") lat = r.number();
+        else if (k == "lng") lng = r.number();
+        else r.skipValue();
+    } while (r.ok() && r.consume(','));
+    return r.expect('}');
+}
+
+// 旧版 station_droneInfo: {"trace": {...}}，trace 为空对象时不产生目标
+template <typename Char>
+bool readLegacyDrone(JsonReader<Char> &r, QList<DroneInfo> &out)
+{
+    if (!r.expect('{')) return false;
+    if (r.consume('}')) return true;
+    do {
+        KeyView<Char> k;
+        if (!r.key(k)) return false;
+        if (out.isEmpty() && k == "trace" && r.consume('{')) {
+            if (r.consume('}')) continue;
+            out.emplaceBack();
+            if (!readDroneMembers(r, out.last())) return false;
+        } else {
+            r.skipValue();
+        }
+    } while (r.ok() && r.consume(','));
+    return r.expect('}');
+}
+
+// 旧版 imageInfo / fpvInfo: {"freq", "amplitude", "mes", "pro"}，type 由键名决定
+template <typename Char>
+bool readLegacyImage(JsonReader<Char> &r, ImageInfo &img, int type)
+{
+    QString pro;
+    bool hasPro = false;
+    if (!r.expect('{')) return false;
+    if (!r.consume('}')) {
+        do {
+            KeyView<Char> k;
+            if (!r.key(k)) return false;
+            if (k == "freq") img.freq = r.number();
+            else if (k == "amplitude") img.amplitude = r.number();
+            else if (k == "mes") img.mes = static_cast<long long>(r.number());
+            else if (k == "pro") {
+                pro = r.string();
+                hasPro = true;
+            } else r.skipValue();
+        } while (r.ok() && r.consume(','));
+        if (!r.expect('}')) return false;
+    }
+
+    img.type = type;
+    if (type == 1) {
+        img.id = QString("FPV %1MHz").arg(img.freq);
+    } else {
+        img.id = QString("Spectrum %1MHz").arg(img.freq);
+        if (hasPro) img.id += " (" + pro + ")";
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// 入口
+// ============================================================================
+DetectionFrameParser::DetectionFrameParser()
+{
+    m_drones.reserve(kReserveSlots);
+    m_images.reserve(kReserveSlots);
+}
+
+DetectionFrameParser::Event DetectionFrameParser::parse(QStringView frame)
+{
+    return parseImpl(frame.utf16(), frame.utf16() + frame.size());
+}
+
+DetectionFrameParser::Event DetectionFrameParser::parse(QByteArrayView frame)
+{
+    return parseImpl(frame.data(), frame.data() + frame.size());
+}
+
+template <typename Char>
+DetectionFrameParser::Event DetectionFrameParser::parseImpl(const Char *begin, const Char *end)
+{
+    // 格式: 42["eventName", data]
+    if (end - begin < 2 || begin[0] != Char('4') || begin[1] != Char('2')) return Event::Invalid;
+
+    JsonReader<Char> r(begin + 2, end);
+    if (!r.expect('[')) return Event::Invalid;
+
+    KeyView<Char> name;
+    bool hasEscape = false;
+    if (!r.rawString(name, hasEscape) || !r.consume(',')) return Event::Invalid;
+
+    // 先按事件名分流，不关心的事件不解析数据部分
+    Event kind = Event::Unknown;
+    if (name == "droneStatus") kind = Event::DroneStatus;
+    else if (name == "imageStatus") kind = Event::ImageStatus;
+    else if (name == "info") kind = Event::DeviceInfo;
+    else return Event::Unknown;
+
+    return parseData(kind, r.position(), end);
+}
+
+template <typename Char>
+DetectionFrameParser::Event DetectionFrameParser::parseData(Event kind, const Char *begin, const Char *end)
+{
+    JsonReader<Char> r(begin, end);
+    switch (kind) {
+    case Event::DroneStatus:
+        m_drones.clear();
+        if (r.peek() != Char('[') || !readDroneArray(r, m_drones)) return Event::Invalid;
+        return kind;
+    case Event::ImageStatus:
+        m_images.clear();
+        if (r.peek() != Char('[') || !readImageArray(r, m_images)) return Event::Invalid;
+        return kind;
+    case Event::DeviceInfo:
+        if (r.peek() != Char('{') || !readDeviceInfo(r, m_infoLat, m_infoLng)) return Event::Invalid;
+        return kind;
+    default:
+        return Event::Unknown;
+    }
+}
+
+bool DetectionFrameParser::parseDrones(QStringView data)
+{
+    return parseData(Event::DroneStatus, data.utf16(), data.utf16() + data.size()) == Event::DroneStatus;
+}
+
+bool DetectionFrameParser::parseImages(QStringView data)
+{
+    return parseData(Event::ImageStatus, data.utf16(), data.utf16() + data.size()) == Event::ImageStatus;
+}
+
+bool DetectionFrameParser::parseInfo(QStringView data)
+{
+    return parseData(Event::DeviceInfo, data.utf16(), data.utf16() + data.size()) == Event::DeviceInfo;
+}
+
+bool DetectionFrameParser::parseDrones(QByteArrayView data)
+{
+    return parseData(Event::DroneStatus, data.data(), data.data() + data.size()) == Event::DroneStatus;
+}
+
+bool DetectionFrameParser::parseImages(QByteArrayView data)
+{
+    return parseData(Event::ImageStatus, data.data(), data.data() + data.size()) == Event::ImageStatus;
+}
+
+bool DetectionFrameParser::parseInfo(QByteArrayView data)
+{
+    return parseData(Event::DeviceInfo, data.data(), data.data() + data.size()) == Event::DeviceInfo;
+}
+
+DetectionFrameParser::Event DetectionFrameParser::parseLegacy(QByteArrayView payload)
+{
+    JsonReader<char> r(payload.data(), payload.data() + payload.size());
+    if (!r.expect('{')) return Event::Invalid;
+    if (r.consume('}')) return Event::Unknown;
+
+    // 每帧只带一个业务键，遇到第一个就解析并返回，其余内容不再扫描
+    do {
+        KeyView<char> k;
+        if (!r.key(k)) return Event::Invalid;
+        if (k == "station_droneInfo") {
+            m_drones.clear();
+            return readLegacyDrone(r, m_drones) ? Event::DroneStatus : Event::Invalid;
+        }
+        if (k == "imageInfo" || k == "fpvInfo") {
+            m_images.clear();
+            m_images.emplaceBack();
+            return readLegacyImage(r, m_images.last(), k == "fpvInfo" ? 1 : 0) ? Event::ImageStatus : Event::Invalid;
+        }
+        if (k == "station_pos") {
+            return readDeviceInfo(r, m_infoLat, m_infoLng) ? Event::DeviceInfo : Event::Invalid;
+        }
+        r.skipValue();
+    } while (r.ok() && r.consume(','));
+    return r.expect('}') ? Event::Unknown : Event::Invalid;
+}
@@ -0,0 +1,66 @@
+#ifndef DETECTIONFRAMEPARSER_H
+#define DETECTIONFRAMEPARSER_H
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <QByteArrayView>
+#include "../DataStructs.h"
+
+// ============================================================================
+// 侦测帧流式解析器 (SAX 风格)
+// 直接在 WebSocket 交付的缓冲区上顺序扫描 42["event", data]：
+// 不做 mid()/toUtf8() 拷贝，不构建 QJsonDocument，字段直接写入复用的结果槽位
+// ============================================================================
+class DetectionFrameParser
+{
+public:
+    enum class Event {
+        Invalid,      // 非 42 业务包 / 格式错误
+        Unknown,      // 合法事件，但不关心 (如 detect_batch)，数据部分不解析
+        DroneStatus,
+        ImageStatus,
+        DeviceInfo
+    };
+
+    DetectionFrameParser();
+
+    // 输入完整 Socket.IO 事件包 (含 "42" 前缀)
+    Event parse(QStringView frame);    // 文本帧 (QWebSocket 交付的 UTF-16)
+    Event parse(QByteArrayView frame); // 二进制帧 / 录制数据 (UTF-8)
+
+    // 只解析事件数据部分 (事件名已由 SocketIoClient 查表分发)，data 从数组/对象起始处开始
+    bool parseDrones(QStringView data);
+    bool parseImages(QStringView data);
+    bool parseInfo(QStringView data);
+    // 二进制附件 (UTF-8 JSON)
+    bool parseDrones(QByteArrayView data);
+    bool parseImages(QByteArrayView data);
+    bool parseInfo(QByteArrayView data);
+
+    // 旧版 TCP 侦测板的帧载荷 (UTF-8，一个顶层对象，按第一个业务键分流)：
+    //   station_droneInfo.trace -> DroneStatus (最多一个目标，trace 为空时没有目标)
+    //   imageInfo / fpvInfo -> ImageStatus (一条，条目名按旧版格式生成)
+    //   station_pos -> DeviceInfo
+    Event parseLegacy(QByteArrayView payload);
+
+    // 解析结果，下一次 parse 前有效
+    const QList<DroneInfo> &drones() const { return m_drones; }
+    const QList<ImageInfo> &images() const { return m_images; }
+    double infoLat() const { return m_infoLat; }
+    double infoLng() const { return m_infoLng; }
+
+private:
+    template <typename Char>
+    Event parseImpl(const Char *begin, const Char *end);
+    template <typename Char>
+    Event parseData(Event kind, const Char *begin, const Char *end);
+
+    // 结果槽位：clear() 保留容量，稳定负载下每帧不再重新分配数组
+    QList<DroneInfo> m_drones;
+    QList<ImageInfo> m_images;
+    double m_infoLat = 0.0;
+    double m_infoLng = 0.0;
+};
+
+#endif // DETECTIONFRAMEPARSER_H
@@ -0,0 +1,25 @@
+#include "detectionsource.h"
+
+DetectionSource::DetectionSource(const Config &config, const Settings &settings, QObject *parent)
+    : QObject(parent), m_config(config), m_settings(settings)
+{
+}
+
+bool DetectionSource::typeFromString(const QString &text, Type &type)
+{
+    QString t = text.trimmed().toLower();
+    if (t.isEmpty() || t == "socketio" || t == "websocket") {
+        type = Type::SocketIo;
+        return true;
+    }
+    if (t == "tcp" || t == "legacy") {
+        type = Type::LegacyTcp;
+        return true;
+    }
+    return false;
+}
+
+QString DetectionSource::logTag() const
+{
+    return m_config.name.isEmpty() ? QString("[侦测]") : QString("[侦测:%1]").arg(m_config.name);
+}
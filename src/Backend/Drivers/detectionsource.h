@@ -0,0 +1,71 @@
+#ifndef DETECTIONSOURCE_H
+#define DETECTIONSOURCE_H
+
+#include <QObject>
+#include <QList>
+#include "../DataStructs.h"
+#include "../latencytracer.h"
+
+// ============================================================================
+// 侦测数据源 (接入后端的公共接口)
+// 每块侦测板对应一个数据源，由 DeviceManager 按配置创建，输出统一的目标列表，
+// 再经 TrackFusion 跨数据源关联/去重后进入航迹库
+// ============================================================================
+class DetectionSource : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Type {
+        SocketIo, // Socket.IO (WebSocket)
+        LegacyTcp // 旧版 TCP 帧协议 (侦测板主动连入)
+    };
+
+    struct Config {
+        QString name;                // 日志/统计中的名称，单一数据源可为空
+        Type type = Type::SocketIo;
+        QString url;                 // socketio: ws://host:port/socket.io/?EIO=3
+                                     // tcp: tcp://[监听地址]:端口
+    };
+
+    // 所有数据源共用的链路参数
+    struct Settings {
+        int reconnectMinMs = 50;   // 断线后首次重连等待 (指数退避 + 抖动)
+        int reconnectMaxMs = 5000; // 重连等待上限
+        int staleGraceMs = 10000;  // 断线后保留最后已知目标的宽限期
+    };
+
+    // 配置中的类型名 (socketio / websocket / tcp / legacy)，不认识返回 false
+    static bool typeFromString(const QString &text, Type &type);
+
+    DetectionSource(const Config &config, const Settings &settings, QObject *parent = nullptr);
+
+    const Config &config() const { return m_config; }
+    const Settings &settings() const { return m_settings; }
+    QString name() const { return m_config.name; }
+
+    // 按配置连接 / 断开
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+    // 周期统计 (负载日志)，无内容时为空
+    virtual QString payloadReport() { return QString(); }
+    virtual QString linkReport() const { return QString(); }
+
+signals:
+    // trace: 帧到达/解析完成时间戳，用于全链路延迟统计
+    void sigDroneListUpdated(const QList<DroneInfo> &drones, const FrameTrace &trace);
+    void sigImageListUpdated(const QList<ImageInfo> &images, const FrameTrace &trace);
+    void sigDevicePositionUpdated(double lat, double lng);
+    // 链路通断；断开期间目标数据视为过时
+    void sigLinkStateChanged(bool online);
+    void sigLog(const QString &msg);
+
+protected:
+    // 日志前缀："[侦测]" 或 "[侦测:名称]"
+    QString logTag() const;
+
+    Config m_config;
+    Settings m_settings;
+};
+
+#endif // DETECTIONSOURCE_H
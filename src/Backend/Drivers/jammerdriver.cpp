@@ -3,9 +3,22 @@
 #include <QUrl>
 #include <QNetworkReply>
 
+namespace {
+// HTTP 请求串行发出，上一条回复后再发下一条；回复失败或超时后重发
+const int JAMMER_MIN_INTERVAL_MS = 50;
+const int JAMMER_ACK_TIMEOUT_MS = 5000;
+}
+
 JammerDriver::JammerDriver(QObject *parent) : QObject(parent)
 {
     m_manager = new QNetworkAccessManager(this);
+
+    CommandScheduler::Options options;
+    options.minIntervalMs = JAMMER_MIN_INTERVAL_MS;
+    options.requireAck = true;
+    options.ackTimeoutMs = JAMMER_ACK_TIMEOUT_MS;
+    m_scheduler = new CommandScheduler("干扰", options, this);
+    connect(m_scheduler, &CommandScheduler::sigLog, this, &JammerDriver::sigLog);
 }
 
 JammerDriver::~JammerDriver() {}
@@ -25,9 +38,8 @@ void JammerDriver::setJamming(bool enable)
     sendPostRequest(apiPath, json);
 }
 
-void JammerDriver::setWriteFreq(const QList<JammerConfigData> &configs)
+QJsonObject JammerDriver::buildFreqRequest(const QString &key, const QList<JammerConfigData> &configs)
 {
-    QString apiPath = "/setWriteFreq";
     QJsonArray arr;
     for (const auto &cfg : configs) {
         QJsonObject item;
@@ -39,26 +51,18 @@ void JammerDriver::setWriteFreq(const QList<JammerConfigData> &configs)
         arr.append(item);
     }
     QJsonObject json;
-    json["writeFreq"] = arr;
-    sendPostRequest(apiPath, json);
+    json[key] = arr;
+    return json;
+}
+
+void JammerDriver::setWriteFreq(const QList<JammerConfigData> &configs)
+{
+    sendPostRequest("/setWriteFreq", buildFreqRequest("writeFreq", configs));
 }
 
 void JammerDriver::setFixedFreq(const QList<JammerConfigData> &configs)
 {
-    QString apiPath = "/setFixedFreq";
-    QJsonArray arr;
-    for (const auto &cfg : configs) {
-        QJsonObject item;
-        item["freqType"] = cfg.freqType;
-        item["startFreq"] = cfg.startFreq;
-        item["endFreq"] = cfg.endFreq;
-        item["isSelect"] = 1;
-        item["isErrMsg"] = "";
-        arr.append(item);
-    }
-    QJsonObject json;
-    json["constFreq"] = arr;
-    sendPostRequest(apiPath, json);
+    sendPostRequest("/setFixedFreq", buildFreqRequest("constFreq", configs));
 }
 
 // ============================================================================
@@ -66,6 +70,13 @@ void JammerDriver::setFixedFreq(const QList<JammerConfigData> &configs)
 // ============================================================================
 void JammerDriver::sendPostRequest(const QString &apiPath, const QJsonObject &json)
 {
+    m_scheduler->submit(apiPath, [this, apiPath, json]() { return transmit(apiPath, json); });
+}
+
+bool JammerDriver::transmit(const QString &apiPath, const QJsonObject &json)
+{
+    if (m_baseUrl.isEmpty()) return false;
+
     QUrl url(m_baseUrl + apiPath);
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
@@ -83,8 +94,13 @@ void JammerDriver::sendPostRequest(const QString &apiPath, const QJsonObject &js
     emit sigLog(logMsg);
 
     QNetworkReply *reply = m_manager->post(request, data);
+    m_pendingReply = reply;
 
     connect(reply, &QNetworkReply::finished, this, [this, reply, apiPath](){
+        // 超时后已被重发取代的旧请求，其回复不再算作确认
+        bool current = (reply == m_pendingReply);
+        if (current) m_pendingReply = nullptr;
+
         // 2. 接收后：把结果显示在 UI 上
         if (reply->error() == QNetworkReply::NoError) {
             QByteArray respData = reply->readAll();
@@ -94,6 +110,7 @@ void JammerDriver::sendPostRequest(const QString &apiPath, const QJsonObject &js
                                      .arg(statusCode)
                                      .arg(QString::fromUtf8(respData)); // 显示服务器到底回了什么
             emit sigLog(successMsg);
+            if (current) m_scheduler->acknowledge();
         } else {
             // 打印详细错误码，比如 404 Not Found, 500 Internal Error, Connection Refused
             QString errorMsg = QString("[HTTP失败] 错误: %1\n详情: %2")
@@ -103,4 +120,5 @@ void JammerDriver::sendPostRequest(const QString &apiPath, const QJsonObject &js
         }
         reply->deleteLater();
     });
+    return true;
 }
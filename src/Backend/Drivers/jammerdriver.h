@@ -9,6 +9,7 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include "../DataStructs.h"
+#include "../commandscheduler.h"
 
 class JammerDriver : public QObject
 {
@@ -22,15 +23,24 @@ public:
     void setWriteFreq(const QList<JammerConfigData> &configs);
     void setFixedFreq(const QList<JammerConfigData> &configs);
 
+    // 频段配置请求体: {"<key>": [{freqType, startFreq, endFreq, isSelect, isErrMsg}, ...]}
+    static QJsonObject buildFreqRequest(const QString &key, const QList<JammerConfigData> &configs);
+
+    const CommandScheduler *scheduler() const { return m_scheduler; }
+
 signals:
     // 【新增】这是一个日志信号，专门用来往UI界面发消息
     void sigLog(const QString &message);
 
 private:
+    // 按接口路径提交给调度器，同一接口只保留最新请求体；transmit 真正发出 POST
     void sendPostRequest(const QString &apiPath, const QJsonObject &json);
+    bool transmit(const QString &apiPath, const QJsonObject &json);
 
     QNetworkAccessManager *m_manager;
     QString m_baseUrl;
+    CommandScheduler *m_scheduler;
+    QNetworkReply *m_pendingReply = nullptr; // 在途请求，只有它的成功回复算作确认
 };
 
 #endif // JAMMERDRIVER_H
@@ -0,0 +1,167 @@
+#include "legacydetectiondriver.h"
+#include <QHostAddress>
+#include <QUrl>
+
+namespace {
+// 图传/FPV 超过此时间无上报视为消失
+constexpr int IMAGE_IDLE_MS = 3000;
+}
+
+LegacyDetectionDriver::LegacyDetectionDriver(const Config &config, const Settings &settings, QObject *parent)
+    : DetectionSource(config, settings, parent)
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &LegacyDetectionDriver::onNewConnection);
+
+    m_imageIdleTimer = new QTimer(this);
+    m_imageIdleTimer->setSingleShot(true);
+    m_imageIdleTimer->setInterval(IMAGE_IDLE_MS);
+    connect(m_imageIdleTimer, &QTimer::timeout, this, &LegacyDetectionDriver::onImageIdle);
+}
+
+LegacyDetectionDriver::~LegacyDetectionDriver()
+{
+    stop();
+}
+
+void LegacyDetectionDriver::start()
+{
+    QUrl url(m_config.url);
+    QHostAddress address = url.host().isEmpty() ? QHostAddress(QHostAddress::Any) : QHostAddress(url.host());
+    int port = url.port(8089);
+
+    if (m_server->listen(address, quint16(port))) {
+        emit sigLog(QString("%1 TCP 监听端口 %2，等待侦测板连接").arg(logTag()).arg(port));
+    } else {
+        emit sigLog(QString("%1 TCP 监听失败: %2").arg(logTag(), m_server->errorString()));
+    }
+}
+
+void LegacyDetectionDriver::stop()
+{
+    if (m_client) {
+        m_client->disconnect(this);
+        m_client->abort();
+        m_client->deleteLater();
+        m_client = nullptr;
+    }
+    m_server->close();
+}
+
+void LegacyDetectionDriver::onNewConnection()
+{
+    bool wasOnline = (m_client != nullptr);
+    if (m_client) {
+        m_client->disconnect(this);
+        m_client->abort();
+        m_client->deleteLater();
+    }
+
+    m_client = m_server->nextPendingConnection();
+    connect(m_client, &QTcpSocket::readyRead, this, &LegacyDetectionDriver::onReadyRead);
+    connect(m_client, &QTcpSocket::disconnected, this, &LegacyDetectionDriver::onClientDisconnected);
+    m_decoder.clear();
+
+    emit sigLog(QString("%1 侦测板已连接: %2").arg(logTag(), m_client->peerAddress().toString()));
+    if (!wasOnline) emit sigLinkStateChanged(true);
+}
+
+void LegacyDetectionDriver::onClientDisconnected()
+{
+    if (!m_client) return;
+    m_client->deleteLater();
+    m_client = nullptr;
+    ++m_drops;
+
+    emit sigLog(QString("%1 侦测板断开 (保留最后已知目标 %2 ms)").arg(logTag()).arg(m_settings.staleGraceMs));
+    emit sigLinkStateChanged(false);
+}
+
+// 数据直接读入拆帧器的环形缓冲，每读一段取出其中的完整帧
+void LegacyDetectionDriver::onReadyRead()
+{
+    qint64 ingestNs = LatencyClock::nowNs();
+    FrameDecoder::Frame frame;
+
+    while (m_client && m_client->bytesAvailable() > 0) {
+        qsizetype space = 0;
+        char *dst = m_decoder.writeSpace(space);
+        if (space == 0) break; // 取完帧后缓冲不会满 (帧超出容量时拆帧器自行扩容)
+        qint64 n = m_client->read(dst, space);
+        if (n <= 0) break;
+        m_decoder.commit(n);
+
+        while (m_decoder.next(frame)) handleFrame(frame, ingestNs);
+    }
+}
+
+void LegacyDetectionDriver::handleFrame(const FrameDecoder::Frame &frame, qint64 ingestNs)
+{
+    // 载荷视图 (UTF-8) 直接交给流式解析器，不拷贝、不构建 QJsonDocument
+    qint64 startNs = LatencyClock::nowNs();
+    DetectionFrameParser::Event event = m_parser.parseLegacy(frame.payload);
+    qint64 parsedNs = LatencyClock::nowNs();
+    m_parseNs += parsedNs - startNs;
+    if (event == DetectionFrameParser::Event::Invalid) {
+        ++m_badJson; // 计入周期统计，不逐帧刷日志
+        return;
+    }
+
+    FrameTrace trace;
+    trace.seq = ++m_frameSeq;
+    trace.ingestNs = ingestNs;
+    trace.parsedNs = parsedNs;
+
+    switch (event) {
+    case DetectionFrameParser::Event::DroneStatus:
+        // 该协议每帧只上报一个目标，其余目标由航迹库按超时保留
+        if (!m_parser.drones().isEmpty()) emit sigDroneListUpdated(m_parser.drones(), trace);
+        break;
+    case DetectionFrameParser::Event::ImageStatus:
+        m_imageIdleTimer->start();
+        emit sigImageListUpdated(m_parser.images(), trace);
+        break;
+    case DetectionFrameParser::Event::DeviceInfo:
+        if (m_parser.infoLat() > 0.1 && m_parser.infoLng() > 0.1) {
+            emit sigDevicePositionUpdated(m_parser.infoLat(), m_parser.infoLng());
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void LegacyDetectionDriver::onImageIdle()
+{
+    emit sigImageListUpdated(QList<ImageInfo>(), FrameTrace());
+}
+
+QString LegacyDetectionDriver::payloadReport()
+{
+    const FrameDecoder::Stats &now = m_decoder.stats();
+    quint64 frames = now.frames - m_reported.frames;
+    quint64 skipped = now.skippedBytes - m_reported.skippedBytes;
+    quint64 bad = now.badFrames - m_reported.badFrames;
+
+    QString report;
+    if (frames > 0) {
+        report = QString("TCP 帧 %1 平均 %2 B / %3 us")
+                     .arg(frames)
+                     .arg(double(now.payloadBytes - m_reported.payloadBytes) / frames, 0, 'f', 0)
+                     .arg(m_parseNs / 1000.0 / frames, 0, 'f', 1);
+    }
+    if (skipped > 0) report += QString(" 重同步丢弃 %1 B").arg(skipped);
+    if (bad > 0) report += QString(" 坏帧 %1").arg(bad);
+    if (m_badJson > 0) report += QString(" JSON 错误 %1").arg(m_badJson);
+
+    m_reported = now;
+    m_parseNs = 0;
+    m_badJson = 0;
+    return report.trimmed();
+}
+
+QString LegacyDetectionDriver::linkReport() const
+{
+    if (m_drops == 0) return QString();
+    return QString("断开 %1 次%2").arg(m_drops).arg(m_client ? QString() : QString(" (当前断开)"));
+}
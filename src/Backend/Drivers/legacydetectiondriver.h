@@ -0,0 +1,57 @@
+#ifndef LEGACYDETECTIONDRIVER_H
+#define LEGACYDETECTIONDRIVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include "detectionsource.h"
+#include "detectionframeparser.h"
+#include "../HAL/framedecoder.h"
+
+// ============================================================================
+// 旧版侦测板 (TCP 帧协议) 数据源
+// 侦测板作为客户端连入本机监听端口 (Url = tcp://绑定地址:端口，地址可省略)，
+// 数据按 FrameDecoder 拆帧，每帧一个 JSON 对象 (流式解析)：
+//   station_droneInfo.trace -> 无人机；imageInfo -> 图传；fpvInfo -> FPV；
+//   station_pos -> 基站坐标
+// 同一时刻只保留一个连接，新连接替换旧连接
+// ============================================================================
+class LegacyDetectionDriver : public DetectionSource
+{
+    Q_OBJECT
+public:
+    LegacyDetectionDriver(const Config &config, const Settings &settings, QObject *parent = nullptr);
+    ~LegacyDetectionDriver();
+
+    void start() override;
+    void stop() override;
+
+    QString payloadReport() override;
+    QString linkReport() const override;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onClientDisconnected();
+    void onImageIdle();
+
+private:
+    void handleFrame(const FrameDecoder::Frame &frame, qint64 ingestNs);
+
+    QTcpServer *m_server;
+    QTcpSocket *m_client = nullptr;
+    QTimer *m_imageIdleTimer; // 图传/FPV 停止上报后发空列表 (该协议只上报存在的信号)
+
+    FrameDecoder m_decoder;
+    DetectionFrameParser m_parser;
+    quint64 m_frameSeq = 0;
+    quint64 m_drops = 0;
+
+    // 周期统计 (payloadReport 输出后清零)
+    FrameDecoder::Stats m_reported;
+    qint64 m_parseNs = 0;
+    quint64 m_badJson = 0;
+};
+
+#endif // LEGACYDETECTIONDRIVER_H
@@ -1,14 +1,52 @@
 #include "relaydriver.h"
-#include <QDebug>
+#include <QtAlgorithms>
 
-RelayDriver::RelayDriver(QObject *parent) : QObject(parent)
+namespace {
+// 继电器每条 Modbus 写指令都会回显，收到回显再发下一条
+const int RELAY_MIN_INTERVAL_MS = 50;
+const int RELAY_ACK_TIMEOUT_MS = 300;
+
+// 线圈状态读回周期；写出后超过 RELAY_SETTLE_MS 读回仍不符即判定卡滞
+const int RELAY_POLL_MS = 1000;
+const int RELAY_SETTLE_MS = 300;
+
+// 整组全开/全关帧写 32 个线圈 (与现场网络助手使用的帧一致)
+const int RELAY_ALL_COILS = 32;
+
+inline quint32 channelMask(int channels)
+{
+    return channels >= 32 ? 0xFFFFFFFFu : (1u << channels) - 1;
+}
+}
+
+RelayDriver::RelayDriver(const Settings &settings, QObject *parent)
+    : QObject(parent),
+      m_settings(settings),
+      m_allMask(channelMask(qBound(1, settings.channels, 32))),
+      m_codec(settings.framing, settings.unit),
+      m_state(m_allMask, RELAY_SETTLE_MS)
 {
+    m_settings.channels = qBound(1, m_settings.channels, 32);
+
     m_socket = new QTcpSocket(this);
 
     connect(m_socket, &QTcpSocket::connected, this, &RelayDriver::onConnected);
     connect(m_socket, &QTcpSocket::disconnected, this, &RelayDriver::onDisconnected);
     // Qt 5.15+ 使用 errorOccurred
     connect(m_socket, &QTcpSocket::errorOccurred, this, &RelayDriver::onErrorOccurred);
+    connect(m_socket, &QTcpSocket::readyRead, this, &RelayDriver::onReadyRead);
+
+    CommandScheduler::Options options;
+    options.minIntervalMs = RELAY_MIN_INTERVAL_MS;
+    options.requireAck = true;
+    options.ackTimeoutMs = RELAY_ACK_TIMEOUT_MS;
+    m_scheduler = new CommandScheduler("压制", options, this);
+    connect(m_scheduler, &CommandScheduler::sigLog, this, &RelayDriver::sigLog);
+
+    m_clock.start();
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(RELAY_POLL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &RelayDriver::onPollTimeout);
 }
 
 RelayDriver::~RelayDriver()
@@ -43,12 +81,20 @@ void RelayDriver::onConnected()
 {
     emit sigLog("[压制] TCP 连接成功!");
     emit sigConnected(true);
+
+    // 先读回实际状态，再按差异下发 (重连后不盲目重发全部指令)
+    m_rxBuffer.clear();
+    onPollTimeout();
+    m_pollTimer->start();
 }
 
 void RelayDriver::onDisconnected()
 {
     emit sigLog("[压制] TCP 连接断开");
     emit sigConnected(false);
+
+    m_pollTimer->stop();
+    m_state.invalidate();
 }
 
 void RelayDriver::onErrorOccurred(QAbstractSocket::SocketError socketError)
@@ -59,89 +105,179 @@ void RelayDriver::onErrorOccurred(QAbstractSocket::SocketError socketError)
 
 void RelayDriver::onReadyRead()
 {
-    // 继电器回复的数据，暂时不需要处理，仅做调试
-    // QByteArray data = m_socket->readAll();
+    // 录制模式下原样写入录制文件，再按帧解析
+    QByteArray data = m_socket->readAll();
+    if (m_recorder) m_recorder->record(StreamLog::RelayRx, data);
+    m_rxBuffer.append(data);
+    parseReplies();
 }
 
-void RelayDriver::sendCommand(const QByteArray &data)
+void RelayDriver::onPollTimeout()
+{
+    if (m_socket->state() != QAbstractSocket::ConnectedState) return;
+    // 读回是后台指令：不占用处置写指令的发送时机
+    m_scheduler->submit("read", [this, data = m_codec.readCoils(0, quint16(m_settings.channels))]() {
+        return transmit(data, FrameTrace());
+    }, CommandScheduler::Priority::Background);
+}
+
+// ============================================================================
+// 回复解析：由 ModbusCodec 按帧格式切帧并校验，每个有效回复确认一条在途指令
+// ============================================================================
+void RelayDriver::parseReplies()
+{
+    while (!m_rxBuffer.isEmpty()) {
+        ModbusCodec::Reply reply;
+        int consumed = m_codec.takeReply(m_rxBuffer, reply);
+        if (consumed == 0) return; // 等待剩余字节
+        m_rxBuffer.remove(0, consumed);
+        if (reply.valid) handleReply(reply);
+    }
+}
+
+void RelayDriver::handleReply(const ModbusCodec::Reply &reply)
+{
+    if (reply.exception) {
+        emit sigLog(QString("[压制] 继电器返回异常: 功能码 %1 异常码 %2")
+                        .arg(reply.function, 2, 16, QChar('0')).arg(reply.exceptionCode));
+    } else if (reply.function == ModbusCodec::WriteSingleCoil) {
+        // 回显包含线圈地址与写入值
+        if (reply.address < m_settings.channels) {
+            quint32 bit = 1u << reply.address;
+            m_state.setActual(bit, reply.value == 0xFF00 ? bit : 0, m_clock.elapsed());
+        }
+    } else if (reply.function == ModbusCodec::ReadCoils) {
+        m_state.setActual(m_allMask, reply.coils, m_clock.elapsed());
+        checkStuck();
+    }
+    // 写多线圈回显不含线圈值，以下一次读回为准
+
+    // 读回被写指令抢占后回复仍可能晚到：只更新实际状态，不能当作写指令的回显
+    bool isRead = reply.function == ModbusCodec::ReadCoils;
+    if (isRead == (m_scheduler->inFlightSetting() == QLatin1String("read"))) m_scheduler->acknowledge();
+    if (reply.function == ModbusCodec::ReadCoils && !reply.exception) reconcile();
+}
+
+void RelayDriver::checkStuck()
+{
+    quint32 stuck = m_state.stuckBits(m_clock.elapsed());
+    if (stuck == m_stuck) return;
+
+    for (int ch = 1; ch <= m_settings.channels; ++ch) {
+        quint32 bit = 1u << (ch - 1);
+        if ((stuck & bit) && !(m_stuck & bit)) {
+            emit sigLog(QString("[压制] 告警: 通道 %1 读回为 %2，与期望不符 (疑似继电器卡滞)，重发")
+                            .arg(ch).arg((m_state.actual() & bit) ? "ON" : "OFF"));
+        } else if (!(stuck & bit) && (m_stuck & bit)) {
+            emit sigLog(QString("[压制] 通道 %1 状态已恢复一致").arg(ch));
+        }
+    }
+    m_stuck = stuck;
+}
+
+// ============================================================================
+// 状态调和：只下发期望与预期不一致的通道
+// 单路变化写单线圈 (0x05)；多路变化用一条写多线圈帧 (0x0F) 覆盖全部通道，
+// 帧内容取自最新期望状态，调度器合并时整帧取代旧帧不会丢失变更。
+// 写多线圈始终按现场验证过的整板格式写 32 个线圈 (与 [Relay] Channels 无关)：
+// 默认站号/RTU 下全开/全关与 allCommand() 逐字节相同，部分通道时未使用的高位线圈写 0
+// ============================================================================
+void RelayDriver::reconcile()
+{
+    quint32 delta = m_state.delta();
+    if (delta == 0) return;
+
+    qint64 now = m_clock.elapsed();
+    if (qPopulationCount(delta) == 1) {
+        int coil = qCountTrailingZeroBits(delta);
+        sendCommand(QString("ch%1").arg(coil + 1), m_codec.writeCoil(quint16(coil), m_state.target() & delta));
+        m_state.markWritten(delta, now);
+        return;
+    }
+
+    quint32 target = m_state.target();
+    if (target == m_allMask) target = 0xFFFFFFFFu;
+    QByteArray cmd = m_codec.writeCoils(0, RELAY_ALL_COILS, target);
+    sendCommand("coils", cmd);
+    m_state.markWritten(m_allMask, now);
+}
+
+bool RelayDriver::transmit(const QByteArray &data, const FrameTrace &trace)
 {
     if (m_socket->state() != QAbstractSocket::ConnectedState) {
-        // 尝试自动重连
-        m_socket->connectToHost(m_targetIp, m_targetPort);
+        // 尝试自动重连 (连接中不重复发起)，调度器稍后重试
+        if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+            m_socket->connectToHost(m_targetIp, m_targetPort);
+        }
         emit sigLog("[压制] 发送失败: 未连接 (尝试重连...)");
-        return;
+        return false;
     }
 
     m_socket->write(data);
     m_socket->flush();
+    if (m_recorder) m_recorder->record(StreamLog::RelayTx, data);
+    if (m_latency) m_latency->markTransmit(LatencyTracer::StageRelayTx, trace);
+
+    // 打印发送的 Hex，方便对比协议表
+    // emit sigLog(QString("[压制TX] %1").arg(QString(data.toHex().toUpper())));
+    return true;
+}
 
-    // 打印发送的 Hex，方便对比协议表     // emit sigLog(QString("[压制TX] %1").arg(QString(data.toHex().toUpper())));
+void RelayDriver::sendCommand(const QString &setting, const QByteArray &data)
+{
+    // 随指令保存提交时的处置帧：限速或等待确认后由定时器写出时仍按该帧计延迟
+    FrameTrace trace = m_latency ? m_latency->activeTrace() : FrameTrace();
+    m_scheduler->submit(setting, [this, data, trace]() { return transmit(data, trace); });
 }
 
 // ============================================================================
-// 全开 / 全关 (根据协议表底部)
+// 固定指令帧 (默认 RTU 站号 0xFE)
+// 全开: FE 0F 00 00 00 20 04 FF FF FF FF F6 0B
+// 全关: FE 0F 00 00 00 20 04 00 00 00 00 F7 9F
+// 通道 1 开: FE 05 00 00 FF 00 98 35
 // ============================================================================
-void RelayDriver::setAll(bool on)
+QByteArray RelayDriver::allCommand(bool on)
 {
-    QByteArray cmd;
-    if (on) {
-        // 全开指令 (与你的网络助手日志完全一致)
-        // FE 0F 00 00 00 20 04 FF FF FF FF F6 0B
-        cmd = QByteArray::fromHex("FE0F0000002004FFFFFFFFF60B");
-        emit sigLog("[指令] 压制全开 (All ON)");
-    } else {
-        // 全关指令 (与你的网络助手日志完全一致)
-        // FE 0F 00 00 00 20 04 00 00 00 00 F7 9F
-        cmd = QByteArray::fromHex("FE0F000000200400000000F79F");
-        emit sigLog("[指令] 压制全关 (All OFF)");
-    }
-
-    // 【调试核心】打印 Qt 实际发送的 HEX 字符串
-    // 请检查控制台输出，必须和网络助手里的一模一样，不能短！
-    qDebug() << "------------------------------------------------";
-    qDebug() << "[Relay Check] 计划发送:" << cmd.toHex().toUpper();
-    qDebug() << "[Relay Check] 字节长度:" << cmd.size(); // 应该是 13
-    qDebug() << "------------------------------------------------";
+    ModbusCodec codec;
+    return codec.writeCoils(0, RELAY_ALL_COILS, on ? 0xFFFFFFFFu : 0);
+}
 
-    if (!cmd.isEmpty()) {
-        sendCommand(cmd);
-    }
+QByteArray RelayDriver::channelCommand(int channel, bool on)
+{
+    if (channel < 1 || channel > 32) return QByteArray();
+    ModbusCodec codec;
+    return codec.writeCoil(quint16(channel - 1), on);
 }
 
 // ============================================================================
-// 单路控制 (1-7路)
+// 控制接口
 // ============================================================================
+void RelayDriver::setAll(bool on)
+{
+    emit sigLog(on ? "[指令] 压制全开 (All ON)" : "[指令] 压制全关 (All OFF)");
+    m_state.setDesired(m_allMask, on ? m_allMask : 0);
+    reconcile();
+}
+
 void RelayDriver::setChannel(int channel, bool on)
 {
-    QString hexStr;
-
-    switch (channel) {
-    case 1:
-        hexStr = on ? "FE050000FF009835" : "FE0500000000D9C5";
-        break;
-    case 2:
-        hexStr = on ? "FE050001FF00C9F5" : "FE05000100008805";
-        break;
-    case 3:
-        hexStr = on ? "FE050002FF0039F5" : "FE05000200007805";
-        break;
-    case 4:
-        hexStr = on ? "FE050003FF006835" : "FE050003000029C5";
-        break;
-    case 5:
-        hexStr = on ? "FE050004FF00D9F4" : "FE05000400009804";
-        break;
-    case 6:
-        hexStr = on ? "FE050005FF008834" : "FE0500050000C9C4";
-        break;
-    case 7:
-        hexStr = on ? "FE050006FF007834" : "FE050006000039C4";
-        break;
-    default:
-        emit sigLog(QString("[压制] 错误: 不支持的通道 %1 (仅支持 1-7)").arg(channel));
+    if (channel < 1 || channel > m_settings.channels) {
+        emit sigLog(QString("[压制] 错误: 不支持的通道 %1 (仅支持 1-%2)").arg(channel).arg(m_settings.channels));
         return;
     }
 
     emit sigLog(QString("[指令] 压制通道 %1 -> %2").arg(channel).arg(on ? "ON" : "OFF"));
-    sendCommand(QByteArray::fromHex(hexStr.toLatin1()));
+    quint32 bit = 1u << (channel - 1);
+    m_state.setDesired(bit, on ? bit : 0);
+    reconcile();
+}
+
+void RelayDriver::setChannels(quint32 mask, bool on)
+{
+    mask &= m_allMask;
+    if (mask == 0) return;
+
+    emit sigLog(QString("[指令] 压制通道掩码 0x%1 -> %2").arg(mask, 0, 16).arg(on ? "ON" : "OFF"));
+    m_state.setDesired(mask, on ? mask : 0);
+    reconcile();
 }
@@ -3,21 +3,54 @@
 
 #include <QObject>
 #include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "../latencytracer.h"
+#include "../streamlog.h"
+#include "../commandscheduler.h"
+#include "../actuatorstate.h"
+#include "../HAL/modbuscodec.h"
 
 class RelayDriver : public QObject
 {
     Q_OBJECT
 public:
-    explicit RelayDriver(QObject *parent = nullptr);
+    struct Settings {
+        int channels = 7;  // 继电器路数 (1-32)，通道 N 对应线圈 N-1
+        ModbusCodec::Framing framing = ModbusCodec::Framing::Rtu;
+        quint8 unit = 0xFE; // 站号
+    };
+
+    explicit RelayDriver(const Settings &settings = Settings(), QObject *parent = nullptr);
+    explicit RelayDriver(QObject *parent) : RelayDriver(Settings(), parent) {}
     ~RelayDriver();
 
     // 连接继电器
     void connectToDevice(const QString &ip, int port);
     void disconnectDevice();
 
-    // 控制接口
+    // 控制接口：只设置期望状态，与读回的实际状态比对后下发差异
     void setAll(bool on);               // 全开/全关
     void setChannel(int channel, bool on); // 单通道控制
+    void setChannels(quint32 mask, bool on); // 多通道 (bit0 = 通道 1)，一帧写出
+
+    int channelCount() const { return m_settings.channels; }
+    quint32 allChannels() const { return m_allMask; }
+
+    // 期望 / 实际线圈状态 (bit0 = 通道 1)
+    const ActuatorState &state() const { return m_state; }
+
+    // 指令帧 (默认 RTU，站号 0xFE；channelCommand 对不支持的通道返回空)
+    static QByteArray allCommand(bool on);
+    static QByteArray channelCommand(int channel, bool on);
+
+    // 指令写出时打发送时间戳 (可为空)
+    void setLatencyTracer(LatencyTracer *tracer) { m_latency = tracer; }
+
+    // 录制指令与继电器回复 (可为空)
+    void setRecorder(StreamRecorder *recorder) { m_recorder = recorder; }
+
+    const CommandScheduler *scheduler() const { return m_scheduler; }
 
 signals:
     // 【新增】日志信号
@@ -30,13 +63,36 @@ private slots:
     void onDisconnected();
     void onErrorOccurred(QAbstractSocket::SocketError socketError);
     void onReadyRead();
+    void onPollTimeout();
 
 private:
-    void sendCommand(const QByteArray &data);
+    // 按设置项提交给调度器 (合并 + 限速 + 等待回显)，transmit 真正写出 TCP
+    void sendCommand(const QString &setting, const QByteArray &data);
+    bool transmit(const QByteArray &data, const FrameTrace &trace);
+
+    // 下发期望与预期状态不一致的通道
+    void reconcile();
+    // 从接收缓冲切出完整回复帧 (TCP 可能分包/粘包)
+    void parseReplies();
+    void handleReply(const ModbusCodec::Reply &reply);
+    void checkStuck();
+
+    Settings m_settings;
+    quint32 m_allMask;
+    ModbusCodec m_codec;
 
     QTcpSocket *m_socket;
     QString m_targetIp;
     int m_targetPort;
+    LatencyTracer *m_latency = nullptr;
+    StreamRecorder *m_recorder = nullptr;
+    CommandScheduler *m_scheduler;
+
+    ActuatorState m_state;
+    QByteArray m_rxBuffer;
+    QTimer *m_pollTimer;      // 周期读回线圈状态
+    QElapsedTimer m_clock;
+    quint32 m_stuck = 0;      // 已告警的卡滞通道
 };
 
 #endif // RELAYDRIVER_H
@@ -0,0 +1,116 @@
+#include "replaydriver.h"
+#include <QDateTime>
+
+namespace {
+// 尽快回放时每轮最多处理的记录数，之后让出事件循环，保证定时器/界面信号照常处理
+const int MAX_BATCH = 256;
+}
+
+ReplayDriver::ReplayDriver(QObject *parent) : QObject(parent)
+{
+    m_stepTimer = new QTimer(this);
+    m_stepTimer->setSingleShot(true);
+    m_stepTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_stepTimer, &QTimer::timeout, this, &ReplayDriver::onStepTimeout);
+}
+
+bool ReplayDriver::open(const QString &path)
+{
+    if (!m_reader.open(path)) {
+        emit sigLog(QString("[回放] 无法打开录制文件: %1").arg(path));
+        return false;
+    }
+    m_path = path;
+    emit sigLog(QString("[回放] 录制文件: %1 (录制于 %2)")
+                    .arg(path, QDateTime::fromMSecsSinceEpoch(m_reader.startTimeUtcMs())
+                                   .toString("yyyy-MM-dd HH:mm:ss")));
+    return true;
+}
+
+void ReplayDriver::start()
+{
+    if (!m_reader.isOpen() || m_running) return;
+
+    m_running = true;
+    m_dispatched = 0;
+    m_firstNs = -1;
+    m_hasNext = m_reader.next(m_next);
+    m_clock.start();
+
+    emit sigLog(QString("[回放] 开始，速度: %1").arg(m_speed > 0 ? QString("%1x").arg(m_speed) : "最快"));
+    scheduleNext();
+}
+
+void ReplayDriver::stop()
+{
+    m_running = false;
+    m_stepTimer->stop();
+}
+
+void ReplayDriver::onStepTimeout()
+{
+    if (!m_running) return;
+
+    // 把所有已到时间的记录一次发完 (最快模式下按批处理)
+    int batch = 0;
+    while (m_hasNext && batch < MAX_BATCH) {
+        if (m_firstNs < 0) m_firstNs = m_next.tNs;
+        if (m_speed > 0) {
+            qint64 dueNs = qint64((m_next.tNs - m_firstNs) / m_speed);
+            if (dueNs > m_clock.nsecsElapsed()) break;
+        }
+        dispatch(m_next);
+        ++batch;
+        m_hasNext = m_reader.next(m_next);
+    }
+    scheduleNext();
+}
+
+void ReplayDriver::scheduleNext()
+{
+    if (!m_hasNext) {
+        double seconds = m_clock.nsecsElapsed() / 1e9;
+        emit sigLog(QString("[回放] 完成: %1 条记录，用时 %2 s").arg(m_dispatched).arg(seconds, 0, 'f', 2));
+
+        if (m_loop) {
+            m_reader.rewind();
+            m_firstNs = -1;
+            m_hasNext = m_reader.next(m_next);
+            m_clock.restart();
+            if (m_hasNext) {
+                m_stepTimer->start(0);
+                return;
+            }
+        }
+        m_running = false;
+        emit sigFinished();
+        return;
+    }
+
+    int waitMs = 0;
+    if (m_speed > 0 && m_firstNs >= 0) {
+        qint64 dueNs = qint64((m_next.tNs - m_firstNs) / m_speed);
+        waitMs = int(qMax<qint64>(0, (dueNs - m_clock.nsecsElapsed()) / 1000000));
+    }
+    m_stepTimer->start(waitMs);
+}
+
+void ReplayDriver::dispatch(const StreamLog::Record &record)
+{
+    ++m_dispatched;
+    switch (record.channel) {
+    case StreamLog::DetectionText:
+        emit sigDetectionFrame(QString(reinterpret_cast<const QChar *>(record.payload.data()),
+                                       record.payload.size() / qsizetype(sizeof(QChar))));
+        break;
+    case StreamLog::DetectionBinary:
+        emit sigDetectionBinary(record.payload.toByteArray());
+        break;
+    case StreamLog::SpoofRx:
+        emit sigSpoofDatagram(record.payload.toByteArray());
+        break;
+    default:
+        // 发出的指令与继电器回复只用于离线分析，回放时不需要送回驱动
+        break;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef REPLAYDRIVER_H
+#define REPLAYDRIVER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "../streamlog.h"
+
+// ============================================================================
+// 录制回放驱动
+// 按录制时的时间间隔把侦测帧、诱骗上报重新送入对应驱动的解析入口，
+// 走与真实硬件完全相同的 解析 -> 决策 -> 指令 路径。
+// speed: 1.0 = 原速，N = N 倍速，0 = 不等待尽快回放 (压力测试)
+// ============================================================================
+class ReplayDriver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReplayDriver(QObject *parent = nullptr);
+
+    bool open(const QString &path);
+    void setSpeed(double speed) { m_speed = speed; }
+    void setLoop(bool loop) { m_loop = loop; }
+
+    void start();
+    void stop();
+
+signals:
+    void sigDetectionFrame(const QString &message);
+    void sigDetectionBinary(const QByteArray &attachment);
+    void sigSpoofDatagram(const QByteArray &datagram);
+    void sigFinished();
+    void sigLog(const QString &msg);
+
+private slots:
+    void onStepTimeout();
+
+private:
+    void scheduleNext();
+    void dispatch(const StreamLog::Record &record);
+
+    StreamReader m_reader;
+    QString m_path;
+    QTimer *m_stepTimer;
+    QElapsedTimer m_clock;
+
+    double m_speed = 1.0;
+    bool m_loop = false;
+    bool m_running = false;
+
+    StreamLog::Record m_next;
+    bool m_hasNext = false;
+    qint64 m_firstNs = -1; // 本轮第一条记录的时间
+
+    quint64 m_dispatched = 0;
+};
+
+#endif // REPLAYDRIVER_H
@@ -3,16 +3,37 @@
 #include <QNetworkInterface>
 #include <QDateTime>
 
+namespace {
+// UDP 无逐条确认，只做合并与限速 (连续指令间隔 20ms，避免设备丢包)
+const int SPOOF_MIN_INTERVAL_MS = 20;
+
+// 602 写出后超过此时间，状态上报仍与期望不符即判定开关未生效
+const int SPOOF_SETTLE_MS = 1000;
+}
+
 SpoofDriver::SpoofDriver(const QString &targetIp, int targetPort, QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_switchState(1, SPOOF_SETTLE_MS)
 {
     // 1. 初始化发送端
     m_targetAddr = QHostAddress(targetIp);
     m_targetPort = targetPort;
     m_udpSender = new QUdpSocket(this);
 
-    // 2. 初始化接收端 (监听 9098)
+    // 2. 接收端 (监听 9098)，在 startWork() 中绑定
     m_udpReceiver = new QUdpSocket(this);
+
+    // 3. 指令调度
+    CommandScheduler::Options options;
+    options.minIntervalMs = SPOOF_MIN_INTERVAL_MS;
+    m_scheduler = new CommandScheduler("诱骗", options, this);
+    connect(m_scheduler, &CommandScheduler::sigLog, this, &SpoofDriver::sigSpoofLog);
+
+    m_clock.start();
+}
+
+// 绑定与登录放在所属线程中执行 (后端线程模式下由 DeviceManager::start 调用)
+void SpoofDriver::startWork()
+{
     // ShareAddress 允许端口复用，防止被占用报错
     if (m_udpReceiver->bind(QHostAddress::AnyIPv4, 9098, QUdpSocket::ShareAddress)) {
         qDebug() << "[SpoofDriver] 成功绑定本地端口: 9098";
@@ -22,9 +43,8 @@ SpoofDriver::SpoofDriver(const QString &targetIp, int targetPort, QObject *paren
         qCritical() << "[SpoofDriver] 绑定 9098 失败:" << m_udpReceiver->errorString();
     }
 
-    // 3. 启动时自动发送登录包
-    // 延时 100ms 发送，确保 Socket 准备就绪
-    QMetaObject::invokeMethod(this, "sendLogin", Qt::QueuedConnection);
+    // 启动时自动发送登录包 (排队执行，确保 Socket 准备就绪)
+    QMetaObject::invokeMethod(this, &SpoofDriver::sendLogin, Qt::QueuedConnection);
 }
 
 SpoofDriver::~SpoofDriver()
@@ -41,43 +61,53 @@ void SpoofDriver::onReadyRead()
         datagram.resize(m_udpReceiver->pendingDatagramSize());
         m_udpReceiver->readDatagram(datagram.data(), datagram.size());
 
-        // 1. 转为字符串处理
-        // 格式示例: FF0262599{"iSysSta":3, ... "dbFixLon":119.xxx ...}
-        QString rawData = QString::fromUtf8(datagram);
-
-        // 2. 简单的协议校验 (FF开头且长度足够)
-        if (rawData.startsWith("FF") && rawData.length() > 10) {
-
-            // 提取 JSON 部分 (第9位开始到最后)
-            // 0-1: FF, 2-5: Length, 6-8: Code(599), 9...: JSON
-            QString jsonStr = rawData.mid(9);
-
-            // 3. 解析 JSON
-            QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
-            if (doc.isObject()) {
-                QJsonObject obj = doc.object();
-
-                // 【核心】提取经纬度 (兼容 599 或 600 协议)
-                if (obj.contains("dbFixLat") && obj.contains("dbFixLon")) {
-                    double lat = obj["dbFixLat"].toDouble();
-                    double lng = obj["dbFixLon"].toDouble();
-
-                    // 只有当坐标有效(非0)时才更新
-                    // 过滤掉经纬度为0或者极其微小的情况
-                    if (lat > 1.0 && lng > 1.0) {
-                        emit sigDevicePosition(lat, lng);
+        if (m_recorder) m_recorder->record(StreamLog::SpoofRx, datagram);
+        processDatagram(datagram, true);
+    }
+}
 
-                        // 调试时可以打开下面这行，看是否收到坐标
-                        // qDebug() << "[Spoof GPS] 基站坐标更新:" << lat << lng;
-                    }
+void SpoofDriver::processDatagram(const QByteArray &datagram, bool live)
+{
+    // 1. 转为字符串处理
+    // 格式示例: FF0262599{"iSysSta":3, ... "dbFixLon":119.xxx ...}
+    QString rawData = QString::fromUtf8(datagram);
+
+    // 2. 简单的协议校验 (FF开头且长度足够)
+    if (rawData.startsWith("FF") && rawData.length() > 10) {
+
+        // 提取 JSON 部分 (第9位开始到最后)
+        // 0-1: FF, 2-5: Length, 6-8: Code(599), 9...: JSON
+        QString jsonStr = rawData.mid(9);
+
+        // 3. 解析 JSON
+        QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
+        if (doc.isObject()) {
+            QJsonObject obj = doc.object();
+
+            // 【核心】提取经纬度 (兼容 599 或 600 协议)
+            if (obj.contains("dbFixLat") && obj.contains("dbFixLon")) {
+                double lat = obj["dbFixLat"].toDouble();
+                double lng = obj["dbFixLon"].toDouble();
+
+                // 只有当坐标有效(非0)时才更新
+                // 过滤掉经纬度为0或者极其微小的情况
+                if (lat > 1.0 && lng > 1.0) {
+                    emit sigDevicePosition(lat, lng);
+
+                    // 调试时可以打开下面这行，看是否收到坐标
+                    // qDebug() << "[Spoof GPS] 基站坐标更新:" << lat << lng;
                 }
             }
+
+            // 功放开关实际状态 (只认现场上报)
+            if (live && obj.contains("iPASwitch")) {
+                onSwitchStatus(obj["iPASwitch"].toInt() == 1);
+            }
         }
     }
 }
 
-// 核心协议封装
-void SpoofDriver::sendCommand(const QString &code, const QJsonObject &json)
+QByteArray SpoofDriver::encodePacket(const QString &code, const QJsonObject &json)
 {
     QJsonDocument doc(json);
     QByteArray jsonBytes = doc.toJson(QJsonDocument::Compact);
@@ -90,15 +120,30 @@ void SpoofDriver::sendCommand(const QString &code, const QJsonObject &json)
     packet.append(lenStr.toUtf8());
     packet.append(code.toUtf8());
     packet.append(jsonBytes);
+    return packet;
+}
+
+void SpoofDriver::sendCommand(const QString &setting, const QString &code, const QJsonObject &json)
+{
+    FrameTrace trace = m_latency ? m_latency->activeTrace() : FrameTrace();
+    m_scheduler->submit(setting, [this, code, json, trace]() { return transmit(code, json, trace); });
+}
+
+bool SpoofDriver::transmit(const QString &code, const QJsonObject &json, const FrameTrace &trace)
+{
+    QByteArray packet = encodePacket(code, json);
 
     qint64 ret = m_udpSender->writeDatagram(packet, m_targetAddr, m_targetPort);
+    if (ret != -1 && m_latency) m_latency->markTransmit(LatencyTracer::StageSpoofTx, trace);
+    if (m_recorder) m_recorder->record(StreamLog::SpoofTx, packet);
 
     if (ret == -1) {
         emit sigSpoofLog(QString("[诱骗异常] 发送失败: %1").arg(m_udpSender->errorString()));
     } else {
         // 正常发送不刷屏日志，仅调试输出
-        qDebug() << "[Spoof TX] " << code << jsonBytes;
+        qDebug() << "[Spoof TX] " << code << packet.mid(9);
     }
+    return ret != -1;
 }
 
 // ================= 业务指令 =================
@@ -111,17 +156,44 @@ void SpoofDriver::setPosition(double lon, double lat, double alt)
     json["dbLon"] = lon;
     json["dbLat"] = lat;
     json["dbAlt"] = alt;
-    sendCommand("601", json);
+    sendCommand("position", "601", json);
 }
 
 void SpoofDriver::setSwitch(bool enable)
 {
+    m_switchState.setDesired(1, enable ? 1 : 0);
+    // 设备已处于该状态 (或同一变更已下发待确认) 时不重复发送
+    if (m_switchState.delta() == 0) return;
+
+    emit sigSpoofLog(QString("[指令] 射频开关 -> %1").arg(enable ? "ON" : "OFF"));
+    reconcileSwitch();
+}
+
+void SpoofDriver::reconcileSwitch()
+{
+    if (m_switchState.delta() == 0) return;
+
     // CMD: 602 射频开关
     QJsonObject json;
     json["sKey"] = SKEY;
-    json["iSwitch"] = enable ? 1 : 0;
-    sendCommand("602", json);
-    emit sigSpoofLog(QString("[指令] 射频开关 -> %1").arg(enable ? "ON" : "OFF"));
+    json["iSwitch"] = int(m_switchState.desired() & 1);
+    sendCommand("switch", "602", json);
+    m_switchState.markWritten(1, m_clock.elapsed());
+}
+
+// 状态上报：更新实际状态，下发后仍不一致则告警并重发
+void SpoofDriver::onSwitchStatus(bool on)
+{
+    qint64 now = m_clock.elapsed();
+    m_switchState.setActual(1, on ? 1 : 0, now);
+
+    bool stuck = m_switchState.stuckBits(now) != 0;
+    if (stuck != m_switchStuck) {
+        emit sigSpoofLog(stuck ? QString("[诱骗] 告警: 射频开关上报为 %1，与期望不符，重发").arg(on ? "ON" : "OFF")
+                               : QString("[诱骗] 射频开关状态已恢复一致"));
+        m_switchStuck = stuck;
+    }
+    reconcileSwitch();
 }
 
 void SpoofDriver::startCircular(double radius, double cycle)
@@ -132,7 +204,7 @@ void SpoofDriver::startCircular(double radius, double cycle)
     json["fCirRadius"] = radius;
     json["fCirCycle"] = cycle;
     json["iCirRotDir"] = 0; // 0: 顺时针
-    sendCommand("610", json);
+    sendCommand("mode", "610", json); // 圆周/定向互相取代
     emit sigSpoofLog(QString("[指令] 模式 -> 圆周驱离 (R=%1)").arg(radius));
 }
 
@@ -143,7 +215,7 @@ void SpoofDriver::startDirectional(SpoofDirection dir, double speed)
     json["sKey"] = SKEY;
     json["fInitSpeedVal"] = speed;
     json["fInitSpeedHead"] = static_cast<int>(dir);
-    sendCommand("608", json);
+    sendCommand("mode", "608", json);
     emit sigSpoofLog(QString("[指令] 模式 -> 定向驱离 (角度:%1)").arg(static_cast<int>(dir)));
 }
 
@@ -155,7 +227,7 @@ void SpoofDriver::sendLogin()
     json["sIP"] = getLocalIP();
     json["iPort"] = 9098; // 告诉硬件往 9098 发数据
 
-    sendCommand("619", json);
+    sendCommand("login", "619", json);
     emit sigSpoofLog(QString("[系统] 发送登录包 -> LocalIP: %1, ListenPort: 9098").arg(json["sIP"].toString()));
 }
 
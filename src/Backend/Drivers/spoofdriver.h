@@ -5,6 +5,11 @@
 #include <QUdpSocket>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QElapsedTimer>
+#include "../latencytracer.h"
+#include "../streamlog.h"
+#include "../commandscheduler.h"
+#include "../actuatorstate.h"
 
 // 【必须保留】定义驱离方向枚举，否则 CPP 会报错
 enum class SpoofDirection {
@@ -21,6 +26,9 @@ public:
     explicit SpoofDriver(const QString &targetIp, int targetPort, QObject *parent = nullptr);
     ~SpoofDriver();
 
+    // 绑定接收端口并发送登录包
+    void startWork();
+
     // 发送指令函数
     void setPosition(double lon, double lat, double alt);
     void setSwitch(bool enable);
@@ -31,6 +39,25 @@ public:
 
     void sendLogin();
 
+    // 组包: "FF" + 4 位十进制长度 + 指令码 + 紧凑 JSON
+    static QByteArray encodePacket(const QString &code, const QJsonObject &json);
+
+    // 指令写出时打发送时间戳 (可为空)
+    void setLatencyTracer(LatencyTracer *tracer) { m_latency = tracer; }
+
+    // 录制收发的 UDP 数据报 (可为空)
+    void setRecorder(StreamRecorder *recorder) { m_recorder = recorder; }
+
+    const CommandScheduler *scheduler() const { return m_scheduler; }
+
+    // 射频开关 期望 / 实际状态 (实际状态来自 599/600 上报的 iPASwitch)
+    const ActuatorState &switchState() const { return m_switchState; }
+
+public slots:
+    // 回放入口：与 9098 端口收到的数据报走同一解析路径，但只更新基站坐标；
+    // 录制的开关状态不是现场设备的状态，不能写入实际状态、触发 602 重发或卡滞告警
+    void injectDatagram(const QByteArray &datagram) { processDatagram(datagram, false); }
+
 signals:
     void sigSpoofLog(const QString &msg);
 
@@ -41,7 +68,13 @@ private slots:
     void onReadyRead();
 
 private:
-    void sendCommand(const QString &code, const QJsonObject &json);
+    // 按设置项提交给调度器 (合并 + 限速)，transmit 真正写出 UDP
+    void sendCommand(const QString &setting, const QString &code, const QJsonObject &json);
+    bool transmit(const QString &code, const QJsonObject &json, const FrameTrace &trace);
+    void processDatagram(const QByteArray &datagram, bool live);
+    // 射频开关期望与实际不一致时下发 602
+    void reconcileSwitch();
+    void onSwitchStatus(bool on);
     QString getLocalIP();
 
     QUdpSocket *m_udpSender;
@@ -49,6 +82,13 @@ private:
     QHostAddress m_targetAddr;
     quint16 m_targetPort;
     const QString SKEY = "123456";
+    LatencyTracer *m_latency = nullptr;
+    StreamRecorder *m_recorder = nullptr;
+    CommandScheduler *m_scheduler;
+
+    ActuatorState m_switchState;
+    QElapsedTimer m_clock;
+    bool m_switchStuck = false;
 };
 
 #endif // SPOOFDRIVER_H
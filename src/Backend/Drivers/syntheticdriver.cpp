@@ -0,0 +1,240 @@
+#include "syntheticdriver.h"
+#include "../../Utils/geodesy.h"
+#include <QtMath>
+#include <QDateTime>
+#include <QtWebSockets/QWebSocketServer>
+#include <QtWebSockets/QWebSocket>
+
+namespace {
+const double FPV_FREQS[] = {5658.0, 5695.0, 5732.0, 5769.0, 5806.0, 5843.0, 5880.0, 5917.0};
+const char *MODELS[] = {"Mavic 3", "Mini 4 Pro", "Air 3", "Matrice 30", "Avata 2", "Autel EVO II"};
+}
+
+SyntheticDriver::SyntheticDriver(const Settings &settings, QObject *parent)
+    : QObject(parent), m_settings(settings), m_rng(settings.seed)
+{
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, &QTimer::timeout, this, &SyntheticDriver::onTick);
+}
+
+SyntheticDriver::~SyntheticDriver()
+{
+    stop();
+}
+
+SyntheticDriver::Trajectory SyntheticDriver::trajectoryFromString(const QString &name)
+{
+    QString n = name.toLower();
+    if (n == "linear") return Trajectory::Linear;
+    if (n == "circular") return Trajectory::Circular;
+    if (n == "randomwalk") return Trajectory::RandomWalk;
+    return Trajectory::Mixed;
+}
+
+QString SyntheticDriver::start()
+{
+    m_targets.clear();
+    m_targets.reserve(m_settings.targets);
+    for (int i = 0; i < m_settings.targets; ++i) m_targets.append(spawnTarget());
+
+    m_clock.start();
+    m_lastTickNs = 0;
+    m_framesGenerated = 0;
+    m_tickTimer->start(qMax(1, int(1000.0 / qMax(0.1, m_settings.rateHz))));
+
+    emit sigLog(QString("[压测] 合成数据源启动: %1 目标, %2 Hz, 替换率 %3/s")
+                    .arg(m_settings.targets).arg(m_settings.rateHz).arg(m_settings.churnPerSec));
+
+    if (m_settings.mode != Mode::Loopback) return QString();
+
+    m_server = new QWebSocketServer("DroneShieldSynthetic", QWebSocketServer::NonSecureMode, this);
+    if (!m_server->listen(QHostAddress::LocalHost, m_settings.port)) {
+        emit sigLog(QString("[压测] 回环端口 %1 监听失败: %2").arg(m_settings.port).arg(m_server->errorString()));
+        return QString();
+    }
+    connect(m_server, &QWebSocketServer::newConnection, this, &SyntheticDriver::onNewConnection);
+    return QString("ws://127.0.0.1:%1/socket.io/?EIO=3&transport=websocket").arg(m_settings.port);
+}
+
+void SyntheticDriver::stop()
+{
+    m_tickTimer->stop();
+    if (m_client) m_client->close();
+    if (m_server) m_server->close();
+}
+
+// ============================================================================
+// 回环 WebSocket：模拟 Socket.IO (EIO3) 服务端的握手与心跳
+// ============================================================================
+void SyntheticDriver::onNewConnection()
+{
+    QWebSocket *socket = m_server->nextPendingConnection();
+    if (m_client) m_client->deleteLater();
+    m_client = socket;
+    connect(m_client, &QWebSocket::textMessageReceived, this, &SyntheticDriver::onClientMessage);
+    connect(m_client, &QWebSocket::disconnected, this, [this, socket]() {
+        if (m_client == socket) m_client = nullptr;
+        socket->deleteLater();
+    });
+    m_client->sendTextMessage("0{\"sid\":\"synthetic\",\"upgrades\":[],\"pingInterval\":25000,\"pingTimeout\":20000}");
+    m_client->sendTextMessage("40");
+}
+
+void SyntheticDriver::onClientMessage(const QString &message)
+{
+    if (message == "2" && m_client) m_client->sendTextMessage("3");
+}
+
+void SyntheticDriver::publish(const QString &frame)
+{
+    ++m_framesGenerated;
+    if (m_settings.mode == Mode::Loopback) {
+        if (m_client) m_client->sendTextMessage(frame);
+    } else {
+        emit sigFrame(frame);
+    }
+}
+
+// ============================================================================
+// 目标运动
+// ============================================================================
+SyntheticDriver::Target SyntheticDriver::spawnTarget()
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    Target t;
+    t.id = QString("SYN%1").arg(m_nextId++, 8, 10, QChar('0'));
+
+    if (m_settings.trajectory == Trajectory::Mixed) {
+        t.model = Trajectory(m_nextId % 3);
+    } else {
+        t.model = m_settings.trajectory;
+    }
+
+    // 新目标从活动半径边缘附近出现
+    double bearing = unit(m_rng) * 2 * M_PI;
+    double range = m_settings.radiusM * (0.5 + 0.5 * unit(m_rng));
+    t.x = range * qSin(bearing);
+    t.y = range * qCos(bearing);
+    t.heading = bearing + M_PI + (unit(m_rng) - 0.5); // 大致朝向中心
+    t.speed = 5.0 + unit(m_rng) * 20.0;
+    t.height = 30.0 + unit(m_rng) * 300.0;
+    t.freq = unit(m_rng) < 0.5 ? 2400.0 + unit(m_rng) * 83.0 : 5725.0 + unit(m_rng) * 125.0;
+
+    t.orbitR = 100.0 + unit(m_rng) * 400.0;
+    t.orbitCx = t.x * 0.5;
+    t.orbitCy = t.y * 0.5;
+    t.orbitW = t.speed / t.orbitR;
+    return t;
+}
+
+void SyntheticDriver::advance(Target &t, double dt)
+{
+    switch (t.model) {
+    case Trajectory::Circular: {
+        double angle = qAtan2(t.x - t.orbitCx, t.y - t.orbitCy) + t.orbitW * dt;
+        t.x = t.orbitCx + t.orbitR * qSin(angle);
+        t.y = t.orbitCy + t.orbitR * qCos(angle);
+        t.heading = angle + M_PI / 2;
+        return;
+    }
+    case Trajectory::RandomWalk: {
+        std::normal_distribution<double> turn(0.0, 0.6 * std::sqrt(dt));
+        t.heading += turn(m_rng);
+        break;
+    }
+    default:
+        break;
+    }
+
+    t.x += t.speed * qSin(t.heading) * dt;
+    t.y += t.speed * qCos(t.heading) * dt;
+
+    // 越过活动半径后掉头
+    if (t.x * t.x + t.y * t.y > m_settings.radiusM * m_settings.radiusM) {
+        t.heading = qAtan2(-t.x, -t.y);
+    }
+}
+
+void SyntheticDriver::onTick()
+{
+    qint64 now = m_clock.nsecsElapsed();
+    double dt = (now - m_lastTickNs) / 1e9;
+    m_lastTickNs = now;
+
+    for (Target &t : m_targets) advance(t, dt);
+
+    // 按替换率随机换掉部分目标 (旧 ID 消失，由航迹库超时移除)
+    m_churnAccumulator += m_settings.churnPerSec * m_targets.size() * dt;
+    if (!m_targets.isEmpty()) {
+        std::uniform_int_distribution<int> pick(0, int(m_targets.size()) - 1);
+        while (m_churnAccumulator >= 1.0) {
+            m_targets[pick(m_rng)] = spawnTarget();
+            m_churnAccumulator -= 1.0;
+        }
+    }
+
+    publish(buildDroneFrame());
+    if (m_settings.images > 0) publish(buildImageFrame());
+}
+
+// ============================================================================
+// 组帧 (字段与侦测设备 droneStatus/imageStatus 一致)
+// ============================================================================
+QString SyntheticDriver::buildDroneFrame() const
+{
+    const Geodesy::LocalProjection localFrame(m_settings.centerLat, m_settings.centerLng);
+
+    QString frame;
+    frame.reserve(64 + m_targets.size() * 420);
+    frame += QLatin1String("42[\"droneStatus\",[");
+
+    for (int i = 0; i < m_targets.size(); ++i) {
+        const Target &t = m_targets.at(i);
+        double distance = std::sqrt(t.x * t.x + t.y * t.y);
+        double azimuth = qRadiansToDegrees(qAtan2(t.x, t.y));
+        if (azimuth < 0) azimuth += 360.0;
+        double headingDeg = qRadiansToDegrees(t.heading);
+        QPointF geo = localFrame.toGeo(t.x, t.y);
+
+        if (i) frame += QLatin1Char(',');
+        frame += QLatin1String("{\"uav_info\":{\"uav_id\":\"") + t.id
+               + QLatin1String("\",\"model_name\":\"") + QLatin1String(MODELS[qHash(t.id) % 6])
+               + QLatin1String("\",\"distance\":") + QString::number(distance, 'f', 1)
+               + QLatin1String(",\"azimuth\":") + QString::number(azimuth, 'f', 1)
+               + QLatin1String(",\"uav_lat\":") + QString::number(geo.y(), 'f', 7)
+               + QLatin1String(",\"uav_lng\":") + QString::number(geo.x(), 'f', 7)
+               + QLatin1String(",\"height\":") + QString::number(t.height, 'f', 1)
+               + QLatin1String(",\"freq\":") + QString::number(t.freq, 'f', 1)
+               + QLatin1String(",\"velocity\":\"") + QString::number(t.speed, 'f', 1)
+               + QLatin1String(" m/s ") + QString::number(headingDeg, 'f', 0)
+               + QLatin1String("\",\"pilot_lat\":") + QString::number(m_settings.centerLat, 'f', 7)
+               + QLatin1String(",\"pilot_lng\":") + QString::number(m_settings.centerLng, 'f', 7)
+               + QLatin1String(",\"pilot_distance\":\"--\",\"whiteList\":false,\"uuid\":\"")
+               + t.id + QLatin1String("\",\"img\":1,\"type\":\"drone\"}}");
+    }
+    frame += QLatin1String("]]");
+    return frame;
+}
+
+QString SyntheticDriver::buildImageFrame() const
+{
+    qint64 mes = QDateTime::currentMSecsSinceEpoch();
+    QString frame;
+    frame.reserve(64 + m_settings.images * 110);
+    frame += QLatin1String("42[\"imageStatus\",[");
+    for (int i = 0; i < m_settings.images; ++i) {
+        double freq = FPV_FREQS[i % 8] + (i / 8) * 3.0;
+        bool fpv = (i % 2) == 0;
+        if (i) frame += QLatin1Char(',');
+        frame += QLatin1String("{\"id\":\"") + QString::number(freq, 'f', 1)
+               + QLatin1String(fpv ? "_fpv" : "_img")
+               + QLatin1String("\",\"freq\":") + QString::number(freq, 'f', 1)
+               + QLatin1String(",\"amplitude\":") + QString::number(60.0 + (i * 7) % 35, 'f', 1)
+               + QLatin1String(",\"type\":") + QString::number(fpv ? 1 : 0)
+               + QLatin1String(",\"mes\":") + QString::number(mes)
+               + QLatin1String(",\"first\":0}");
+    }
+    frame += QLatin1String("]]");
+    return frame;
+}
@@ -0,0 +1,102 @@
+#ifndef SYNTHETICDRIVER_H
+#define SYNTHETICDRIVER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <random>
+
+class QWebSocketServer;
+class QWebSocket;
+
+// ============================================================================
+// 合成侦测数据源 (压力测试)
+// 在进程内按设定的目标数/帧率/替换率生成 droneStatus/imageStatus 帧，
+// 帧格式与侦测设备一致，可直接注入 DetectionDriver 的解析入口 (Inject)，
+// 也可通过本机 WebSocket 回环发送 (Loopback)，连同 socket 收包路径一起压测
+// ============================================================================
+class SyntheticDriver : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Trajectory {
+        Linear,     // 匀速直线，越界折返
+        Circular,   // 绕各自圆心盘旋
+        RandomWalk, // 航向随机扰动
+        Mixed       // 三种按目标轮换
+    };
+
+    enum class Mode {
+        Inject,     // 直接调用 DetectionDriver::injectTextFrame
+        Loopback    // 本机 WebSocket 服务端，DetectionDriver 照常连接
+    };
+
+    struct Settings {
+        int targets = 200;          // 同时存在的无人机数
+        int images = 10;            // 图传/FPV 信号数
+        double rateHz = 20.0;       // 每秒帧数
+        double churnPerSec = 0.05;  // 每秒被替换的目标比例 (新目标出现、旧目标消失)
+        double radiusM = 3000.0;    // 目标活动半径
+        Trajectory trajectory = Trajectory::Mixed;
+        Mode mode = Mode::Inject;
+        quint16 port = 18090;       // Loopback 监听端口
+        quint32 seed = 1;           // 随机种子 (相同配置可复现)
+        double centerLat = 0.0;
+        double centerLng = 0.0;
+    };
+
+    explicit SyntheticDriver(const Settings &settings, QObject *parent = nullptr);
+    ~SyntheticDriver();
+
+    // Loopback 模式下返回供 DetectionDriver 连接的地址，Inject 模式返回空
+    QString start();
+    void stop();
+
+    quint64 framesGenerated() const { return m_framesGenerated; }
+
+    static Trajectory trajectoryFromString(const QString &name);
+
+signals:
+    void sigFrame(const QString &message); // Inject 模式
+    void sigLog(const QString &msg);
+
+private slots:
+    void onTick();
+    void onNewConnection();
+    void onClientMessage(const QString &message);
+
+private:
+    struct Target {
+        QString id;
+        Trajectory model;
+        double x, y;       // 相对中心的东/北坐标 (m)
+        double heading;    // 航向 (rad，正北为 0，顺时针)
+        double speed;      // m/s
+        double height;
+        double freq;
+        double orbitCx, orbitCy, orbitR, orbitW; // 盘旋参数
+    };
+
+    Target spawnTarget();
+    void advance(Target &t, double dt);
+    QString buildDroneFrame() const;
+    QString buildImageFrame() const;
+    void publish(const QString &frame);
+
+    Settings m_settings;
+    QTimer *m_tickTimer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTickNs = 0;
+
+    QList<Target> m_targets;
+    double m_churnAccumulator = 0.0;
+    quint64 m_nextId = 0;
+    quint64 m_framesGenerated = 0;
+    std::mt19937 m_rng;
+
+    QWebSocketServer *m_server = nullptr;
+    QWebSocket *m_client = nullptr;
+};
+
+#endif // SYNTHETICDRIVER_H
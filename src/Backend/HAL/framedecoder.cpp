@@ -0,0 +1,137 @@
+#include "framedecoder.h"
+#include <cstring>
+
+namespace {
+qsizetype roundUpPow2(qsizetype n)
+{
+    qsizetype p = 256;
+    while (p < n) p <<= 1;
+    return p;
+}
+}
+
+FrameDecoder::FrameDecoder(qsizetype capacity, quint32 maxPayload) : m_maxPayload(maxPayload)
+{
+    m_buffer.resize(roundUpPow2(capacity));
+    m_mask = m_buffer.size() - 1;
+}
+
+void FrameDecoder::clear()
+{
+    m_read = 0;
+    m_used = 0;
+}
+
+char *FrameDecoder::writeSpace(qsizetype &space)
+{
+    qsizetype write = (m_read + m_used) & m_mask;
+    qsizetype free = m_buffer.size() - m_used;
+    // 写位置到环尾，或到读位置 (已回绕时)
+    space = qMin(free, m_buffer.size() - write);
+    return m_buffer.data() + write;
+}
+
+void FrameDecoder::commit(qsizetype bytes)
+{
+    m_used += bytes;
+}
+
+qsizetype FrameDecoder::append(const char *data, qsizetype size)
+{
+    qsizetype written = 0;
+    while (written < size) {
+        qsizetype space = 0;
+        char *dst = writeSpace(space);
+        if (space == 0) break;
+        qsizetype n = qMin(space, size - written);
+        memcpy(dst, data + written, size_t(n));
+        commit(n);
+        written += n;
+    }
+    return written;
+}
+
+quint32 FrameDecoder::le32(qsizetype offset) const
+{
+    return quint32(at(offset)) | (quint32(at(offset + 1)) << 8)
+         | (quint32(at(offset + 2)) << 16) | (quint32(at(offset + 3)) << 24);
+}
+
+void FrameDecoder::consume(qsizetype bytes)
+{
+    m_read = (m_read + bytes) & m_mask;
+    m_used -= bytes;
+    if (m_used == 0) m_read = 0; // 空时回到环头，后续整帧更可能连续
+}
+
+// 单帧超过当前容量：扩容并把未处理数据排成连续 (只在出现更大的帧时发生)
+void FrameDecoder::grow(qsizetype needed)
+{
+    QByteArray bigger(roundUpPow2(needed), Qt::Uninitialized);
+    qsizetype first = qMin(m_used, m_buffer.size() - m_read);
+    memcpy(bigger.data(), m_buffer.constData() + m_read, size_t(first));
+    memcpy(bigger.data() + first, m_buffer.constData(), size_t(m_used - first));
+    m_buffer = bigger;
+    m_mask = m_buffer.size() - 1;
+    m_read = 0;
+}
+
+bool FrameDecoder::next(Frame &frame)
+{
+    while (m_used >= 4) {
+        // 1. 帧头：不符则前移一个字节重新同步
+        if (le32(0) != HEAD) {
+            consume(1);
+            ++m_stats.skippedBytes;
+            continue;
+        }
+        if (m_used < HEADER_SIZE) return false;
+
+        // 2. 长度字段：超限视为误同步 (载荷中恰好出现 55555555)
+        quint32 length = le32(4);
+        if (length > m_maxPayload) {
+            consume(1);
+            ++m_stats.badFrames;
+            ++m_stats.skippedBytes;
+            continue;
+        }
+
+        // 载荷是 JSON 对象：首字节不是 '{' 的帧头是误同步，立即前移，
+        // 不按假长度等待 (否则要等够该长度的数据才能发现帧尾不符)
+        if (length > 0 && m_used > HEADER_SIZE && at(HEADER_SIZE) != '{') {
+            consume(1);
+            ++m_stats.badFrames;
+            ++m_stats.skippedBytes;
+            continue;
+        }
+
+        qsizetype total = HEADER_SIZE + qsizetype(length) + TAIL_SIZE;
+        if (total > m_buffer.size()) grow(total);
+        if (m_used < total) return false;
+
+        // 3. 帧尾
+        if (le32(HEADER_SIZE + length) != TAIL) {
+            consume(1);
+            ++m_stats.badFrames;
+            ++m_stats.skippedBytes;
+            continue;
+        }
+
+        frame.type = le32(8);
+        qsizetype start = (m_read + HEADER_SIZE) & m_mask;
+        qsizetype contiguous = m_buffer.size() - start;
+        if (qsizetype(length) <= contiguous) {
+            frame.payload = QByteArrayView(m_buffer.constData() + start, length);
+        } else {
+            m_linear.resize(length);
+            memcpy(m_linear.data(), m_buffer.constData() + start, size_t(contiguous));
+            memcpy(m_linear.data() + contiguous, m_buffer.constData(), size_t(length - contiguous));
+            frame.payload = QByteArrayView(m_linear);
+        }
+        consume(total);
+        ++m_stats.frames;
+        m_stats.payloadBytes += length;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtGlobal>
+
+// ============================================================================
+// 定长头 + 长度字段 的 TCP 拆帧器 (旧版侦测板协议)
+//
+// 帧格式：55 55 55 55 | 长度 (u32 小端) | 类型 (u32 小端) | JSON (长度字节) | AA AA AA AA
+//
+// 接收数据直接读入环形缓冲 (writeSpace/commit)，按长度字段定位帧尾，不逐字节
+// 扫描括号；帧头不符、长度超限、载荷不以 '{' 开头或帧尾不符时逐字节前移
+// 重新寻找帧头，每个字节最多被跳过一次，缓冲区增长不会导致重复扫描。
+// 长度上限按实际帧大小 (单目标 JSON 几百字节) 设定，误同步的帧头不会让
+// 拆帧器为一个不存在的大帧长时间等待。
+// 载荷在环内连续时直接返回视图，跨越环尾时拷贝一次到复用的缓冲。
+// ============================================================================
+class FrameDecoder
+{
+public:
+    static constexpr quint32 HEAD = 0x55555555u;
+    static constexpr quint32 TAIL = 0xAAAAAAAAu;
+    static constexpr qsizetype HEADER_SIZE = 12; // 帧头 + 长度 + 类型
+    static constexpr qsizetype TAIL_SIZE = 4;
+
+    struct Frame {
+        quint32 type = 0;
+        QByteArrayView payload; // 下次 writeSpace()/append() 前有效
+    };
+
+    struct Stats {
+        quint64 frames = 0;
+        quint64 payloadBytes = 0;
+        quint64 skippedBytes = 0; // 重新同步时丢弃的字节
+        quint64 badFrames = 0;    // 长度超限或帧尾不符
+    };
+
+    // capacity 取整到 2 的幂；单帧超过容量时按需扩容 (不超过 maxPayload)
+    explicit FrameDecoder(qsizetype capacity = 64 * 1024, quint32 maxPayload = 16 * 1024);
+
+    // 连续可写区域 (可能小于总空闲空间，写满后再次调用取环头部分)
+    char *writeSpace(qsizetype &space);
+    void commit(qsizetype bytes);
+    // 拷贝写入 (回放/测试用)，返回实际写入字节数
+    qsizetype append(const char *data, qsizetype size);
+
+    // 取出下一完整帧；数据不足返回 false
+    bool next(Frame &frame);
+
+    void clear();
+    qsizetype size() const { return m_used; }
+    qsizetype capacity() const { return m_buffer.size(); }
+    const Stats &stats() const { return m_stats; }
+
+private:
+    quint8 at(qsizetype offset) const { return quint8(m_buffer.at((m_read + offset) & m_mask)); }
+    quint32 le32(qsizetype offset) const;
+    void consume(qsizetype bytes);
+    void grow(qsizetype needed);
+
+    QByteArray m_buffer;
+    qsizetype m_mask = 0;
+    qsizetype m_read = 0;  // 读位置 (已取模)
+    qsizetype m_used = 0;  // 未处理字节数
+    quint32 m_maxPayload;
+    QByteArray m_linear;   // 跨越环尾的载荷
+    Stats m_stats;
+};
+
+#endif // FRAMEDECODER_H
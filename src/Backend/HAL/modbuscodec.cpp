@@ -0,0 +1,137 @@
+#include "modbuscodec.h"
+#include "../../Utils/crcutils.h"
+
+namespace {
+const int MBAP_HEADER = 7; // 事务号 2 + 协议 2 + 长度 2 + 站号 1
+
+inline void appendWord(QByteArray &out, quint16 value)
+{
+    out.append(char(value >> 8));
+    out.append(char(value & 0xFF));
+}
+
+inline quint16 readWord(const uchar *p)
+{
+    return quint16((p[0] << 8) | p[1]);
+}
+}
+
+QByteArray ModbusCodec::readCoils(quint16 start, quint16 count)
+{
+    QByteArray pdu;
+    pdu.append(char(ReadCoils));
+    appendWord(pdu, start);
+    appendWord(pdu, count);
+    return frame(pdu);
+}
+
+QByteArray ModbusCodec::writeCoil(quint16 coil, bool on)
+{
+    QByteArray pdu;
+    pdu.append(char(WriteSingleCoil));
+    appendWord(pdu, coil);
+    appendWord(pdu, on ? 0xFF00 : 0x0000);
+    return frame(pdu);
+}
+
+QByteArray ModbusCodec::writeCoils(quint16 start, quint16 count, quint32 values)
+{
+    Q_ASSERT(count >= 1 && count <= 32);
+    int bytes = (count + 7) / 8;
+    if (count < 32) values &= (1u << count) - 1;
+
+    QByteArray pdu;
+    pdu.append(char(WriteMultipleCoils));
+    appendWord(pdu, start);
+    appendWord(pdu, count);
+    pdu.append(char(bytes));
+    for (int i = 0; i < bytes; ++i) {
+        pdu.append(char((values >> (8 * i)) & 0xFF)); // 线圈值低位在前
+    }
+    return frame(pdu);
+}
+
+QByteArray ModbusCodec::frame(const QByteArray &pdu)
+{
+    QByteArray out;
+    if (m_framing == Framing::Tcp) {
+        out.reserve(MBAP_HEADER + pdu.size());
+        appendWord(out, ++m_transaction);
+        appendWord(out, 0);
+        appendWord(out, quint16(pdu.size() + 1));
+        out.append(char(m_unit));
+        out.append(pdu);
+    } else {
+        out.reserve(1 + pdu.size() + 2);
+        out.append(char(m_unit));
+        out.append(pdu);
+        CrcUtils::appendModbus(out);
+    }
+    return out;
+}
+
+// ============================================================================
+// 回复拆帧
+// ============================================================================
+int ModbusCodec::replyPduLength(const uchar *pdu, qsizetype available)
+{
+    if (available < 1) return 0;
+    quint8 function = pdu[0];
+    if (function & 0x80) return 2;                     // 功能码 + 异常码
+    if (function == WriteSingleCoil || function == WriteMultipleCoils) return 5;
+    if (function == ReadCoils) return available < 2 ? 0 : 2 + pdu[1];
+    return -1;
+}
+
+void ModbusCodec::parsePdu(const uchar *pdu, Reply &reply)
+{
+    reply = Reply();
+    reply.valid = true;
+    reply.function = pdu[0] & 0x7F;
+    if (pdu[0] & 0x80) {
+        reply.exception = true;
+        reply.exceptionCode = pdu[1];
+    } else if (reply.function == ReadCoils) {
+        reply.coilBytes = pdu[1];
+        for (int i = 0; i < reply.coilBytes && i < 4; ++i) {
+            reply.coils |= quint32(pdu[2 + i]) << (8 * i);
+        }
+    } else {
+        reply.address = readWord(pdu + 1);
+        reply.value = readWord(pdu + 3);
+    }
+}
+
+int ModbusCodec::takeReply(const QByteArray &buffer, Reply &reply) const
+{
+    reply.valid = false;
+    const uchar *d = reinterpret_cast<const uchar *>(buffer.constData());
+    const qsizetype size = buffer.size();
+
+    if (m_framing == Framing::Tcp) {
+        if (size < MBAP_HEADER + 1) return 0;
+        quint16 length = readWord(d + 4);
+        if (readWord(d + 2) != 0 || length < 2 || length > 254) return 1;
+        int total = 6 + length;
+        if (size < total) return 0;
+        if (d[6] != m_unit || replyPduLength(d + MBAP_HEADER, length - 1) != length - 1) return total;
+        parsePdu(d + MBAP_HEADER, reply);
+        return total;
+    }
+
+    if (size < 2) return 0;
+    if (d[0] != m_unit) return 1;
+    int pduLength = replyPduLength(d + 1, size - 1);
+    if (pduLength < 0) return 1;
+    if (pduLength == 0) return 0;
+    int total = 1 + pduLength + 2;
+    if (size < total) return 0;
+    if (!CrcUtils::checkModbus(buffer.constData(), total)) return 1;
+    parsePdu(d + 1, reply);
+    return total;
+}
+
+ModbusCodec::Framing ModbusCodec::framingFromString(const QString &name)
+{
+    return name.trimmed().toLower() == "tcp" ? Framing::Tcp : Framing::Rtu;
+}
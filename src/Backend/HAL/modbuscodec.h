@@ -0,0 +1,66 @@
+#ifndef MODBUSCODEC_H
+#define MODBUSCODEC_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// ============================================================================
+// Modbus 线圈指令组帧 / 回复拆帧
+//
+// Rtu: 站号 + PDU + CRC16 (串口服务器透传的 RTU over TCP 也用此格式)
+// Tcp: MBAP 头 (事务号, 协议 0, 长度, 站号) + PDU，无 CRC
+// 支持功能码 0x01 读线圈、0x05 写单线圈、0x0F 写多线圈 (最多 32 路，
+// 按位掩码一帧写出)。
+// ============================================================================
+class ModbusCodec
+{
+public:
+    enum class Framing { Rtu, Tcp };
+
+    enum Function : quint8 {
+        ReadCoils = 0x01,
+        WriteSingleCoil = 0x05,
+        WriteMultipleCoils = 0x0F
+    };
+
+    // 解析出的一条回复
+    struct Reply {
+        bool valid = false;
+        quint8 function = 0;
+        bool exception = false;
+        quint8 exceptionCode = 0;
+        quint16 address = 0;  // 写回显：起始线圈
+        quint16 value = 0;    // 写单线圈回显：0xFF00 / 0x0000；写多线圈回显：线圈数
+        quint32 coils = 0;    // 读线圈：bit0 = 起始线圈 (最多 32 路)
+        int coilBytes = 0;
+    };
+
+    explicit ModbusCodec(Framing framing = Framing::Rtu, quint8 unit = 0xFE)
+        : m_framing(framing), m_unit(unit) {}
+
+    Framing framing() const { return m_framing; }
+    quint8 unit() const { return m_unit; }
+
+    QByteArray readCoils(quint16 start, quint16 count);
+    QByteArray writeCoil(quint16 coil, bool on);
+    QByteArray writeCoils(quint16 start, quint16 count, quint32 values);
+
+    // 从接收缓冲头部取一条回复：返回应消费的字节数，0 = 数据不完整需等待。
+    // 站号/功能码无法识别或校验失败时返回 1 且 reply.valid = false (丢弃 1 字节重新同步)
+    int takeReply(const QByteArray &buffer, Reply &reply) const;
+
+    static Framing framingFromString(const QString &name);
+
+private:
+    QByteArray frame(const QByteArray &pdu);
+    // 回复 PDU 长度：-1 = 无法识别，0 = 字节不足以判断
+    static int replyPduLength(const uchar *pdu, qsizetype available);
+    static void parsePdu(const uchar *pdu, Reply &reply);
+
+    Framing m_framing;
+    quint8 m_unit;
+    quint16 m_transaction = 0;
+};
+
+#endif // MODBUSCODEC_H
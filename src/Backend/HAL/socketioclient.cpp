@@ -1,58 +1,143 @@
 #include "socketioclient.h"
+#include "../latencytracer.h"
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QMetaMethod>
+#include <QRandomGenerator>
+#include <QUrlQuery>
 #include <QDebug>
 
-SocketIoClient::SocketIoClient(QObject *parent) : QObject(parent)
+namespace {
+// Socket.IO 包中事件数组的起始下标：跳过可选的命名空间 ("/ns,") 与确认号
+qsizetype arrayStart(QStringView packet, qsizetype pos)
 {
-    m_webSocket = new QWebSocket();
+    if (pos < packet.size() && packet[pos] == u'/') {
+        qsizetype comma = packet.indexOf(u',', pos);
+        if (comma < 0) return -1;
+        pos = comma + 1;
+    }
+    while (pos < packet.size() && packet[pos].isDigit()) ++pos;
+    return (pos < packet.size() && packet[pos] == u'[') ? pos : -1;
+}
+
+inline qsizetype skipSpace(QStringView s, qsizetype pos)
+{
+    while (pos < s.size() && s[pos].isSpace()) ++pos;
+    return pos;
+}
+
+// TCP 连接建立前的这些错误说明服务端不可达；升级请求发出后 QWebSocket 同样用
+// ConnectionRefusedError 报告 HTTP 握手被拒绝，须结合 m_upgradeSent 区分
+bool isReachabilityError(QAbstractSocket::SocketError error)
+{
+    return error == QAbstractSocket::ConnectionRefusedError
+        || error == QAbstractSocket::HostNotFoundError
+        || error == QAbstractSocket::NetworkError
+        || error == QAbstractSocket::SocketTimeoutError;
+}
+}
+
+SocketIoClient::SocketIoClient(const QString &name, QObject *parent) : QObject(parent), m_name(name)
+{
+    m_webSocket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
     m_isManualClose = false;
 
-    // 初始化重连定时器
+    // 初始化重连定时器 (单次；连接失败与断开都会重新启动)
     m_reconnectTimer = new QTimer(this);
-    m_reconnectTimer->setInterval(3000);
+    m_reconnectTimer->setSingleShot(true);
     connect(m_reconnectTimer, &QTimer::timeout, this, &SocketIoClient::onReconnectTimerOut);
 
-    // 连接成功
-    connect(m_webSocket, &QWebSocket::connected, this, [this](){
-        m_reconnectTimer->stop();
-        qDebug() << "[SocketIO] 物理连接建立";
-    });
+    // 预连接探测：connectToHost 走 Qt 的主机名缓存，解析结果随后被 WebSocket 复用
+    m_probe = new QTcpSocket(this);
+    connect(m_probe, &QTcpSocket::connected, this, &SocketIoClient::onProbeConnected);
+    connect(m_probe, &QTcpSocket::errorOccurred, m_probe, &QTcpSocket::abort);
 
-    // 连接断开 -> 启动重连
-    connect(m_webSocket, &QWebSocket::disconnected, this, [this](){
-        emit disconnected();
-        if (!m_isManualClose) {
-            qDebug() << "[SocketIO] 连接断开，3秒后尝试重连...";
-            m_reconnectTimer->start();
-        }
+    m_pingTimer = new QTimer(this);
+    connect(m_pingTimer, &QTimer::timeout, this, &SocketIoClient::onPingTimeout);
+
+    m_livenessTimer = new QTimer(this);
+    m_livenessTimer->setSingleShot(true);
+    connect(m_livenessTimer, &QTimer::timeout, this, &SocketIoClient::onLivenessTimeout);
+
+    connect(m_webSocket, &QWebSocket::connected, this, &SocketIoClient::onSocketConnected);
+    connect(m_webSocket, &QWebSocket::disconnected, this, &SocketIoClient::onSocketDisconnected);
+    connect(m_webSocket, &QWebSocket::textMessageReceived, this, &SocketIoClient::onTextMessageReceived);
+    connect(m_webSocket, &QWebSocket::binaryMessageReceived, this, &SocketIoClient::onBinaryMessageReceived);
+    connect(m_webSocket, &QWebSocket::bytesWritten, this, &SocketIoClient::onBytesWritten);
+    // 对端关闭读通道同样说明 TCP 曾连通 (握手阶段服务端拒绝后直接断开)
+    connect(m_webSocket, &QWebSocket::readChannelFinished, this, [this]() {
+        if (!m_opened) m_upgradeSent = true;
     });
 
-    // 发生错误 -> 启动重连
-    connect(m_webSocket, &QWebSocket::errorOccurred, this, [this](QAbstractSocket::SocketError error){
-        qDebug() << "[SocketIO Error]" << error;
-        // 如果当前没连上，且定时器没跑，就启动它
-        if (m_webSocket->state() != QAbstractSocket::ConnectedState && !m_isManualClose) {
-            if (!m_reconnectTimer->isActive()) {
-                m_reconnectTimer->start();
-            }
+    // 发生错误 -> 升级请求已发出 (TCP 已连通) 但会话未打开，视为握手被拒绝
+    // (例如 EIO 版本不符返回 HTTP 400)，下次改用另一 EIO 版本；然后按退避启动重连。
+    // 只有 TCP 都未连通时才做预连接探测，端口可达时探测会绕过退避
+    connect(m_webSocket, &QWebSocket::errorOccurred, this, [this](QAbstractSocket::SocketError error) {
+        qDebug() << QString("[%1 Error]").arg(m_name) << error << m_webSocket->errorString();
+        if (m_isManualClose || m_webSocket->state() == QAbstractSocket::ConnectedState) return;
+        bool reached = m_upgradeSent || error == QAbstractSocket::RemoteHostClosedError
+                    || !isReachabilityError(error);
+        if (!m_attemptOpened && reached) {
+            m_version = (m_version == EngineVersion::V3) ? EngineVersion::V4 : EngineVersion::V3;
+            m_probe->abort();
+            emit sigLog(QString("[%1] 握手被拒绝，改用 EIO=%2 重试").arg(m_name).arg(int(m_version)));
         }
+        scheduleReconnect(!reached);
     });
+}
 
-    connect(m_webSocket, &QWebSocket::textMessageReceived, this, &SocketIoClient::onTextMessageReceived);
+void SocketIoClient::on(const QString &event, Handler handler)
+{
+    for (HandlerEntry &entry : m_handlers) {
+        if (entry.name == event) {
+            entry.handler = std::move(handler);
+            return;
+        }
+    }
+    m_handlers.append({event, std::move(handler)});
 }
 
 void SocketIoClient::connectToServer(const QString &url)
 {
-    m_targetUrl = url;
-
-    if (!m_targetUrl.endsWith("/")) m_targetUrl += "/";
-    if (!m_targetUrl.contains("socket.io")) m_targetUrl += "socket.io/?EIO=4&transport=websocket";
+    // 地址中的 EIO 参数作为首选版本，其余查询参数保留
+    QUrl target(url);
+    QUrlQuery query(target);
+    m_version = query.queryItemValue("EIO") == "3" ? EngineVersion::V3 : EngineVersion::V4;
+    query.removeAllQueryItems("EIO");
+    query.removeAllQueryItems("transport");
+    target.setQuery(query);
+    if (!target.path().contains("socket.io")) {
+        QString path = target.path();
+        if (!path.endsWith('/')) path += '/';
+        target.setPath(path + "socket.io/");
+    }
+    m_targetUrl = target.toString();
 
     m_isManualClose = false;
+    m_reconnectAttempt = 0;
     doConnect();
 }
 
+void SocketIoClient::close()
+{
+    m_isManualClose = true;
+    m_reconnectTimer->stop();
+    m_pingTimer->stop();
+    m_livenessTimer->stop();
+    m_probe->abort();
+    m_webSocket->close();
+}
+
+QUrl SocketIoClient::urlFor(EngineVersion version) const
+{
+    QUrl url(m_targetUrl);
+    QUrlQuery query(url);
+    query.addQueryItem("EIO", QString::number(int(version)));
+    query.addQueryItem("transport", "websocket");
+    url.setQuery(query);
+    return url;
+}
+
 void SocketIoClient::doConnect()
 {
     // 如果已经连接或正在连接，就不操作
@@ -61,8 +146,11 @@ void SocketIoClient::doConnect()
         return;
     }
 
-    qDebug() << "[SocketIO] 尝试连接..." << m_targetUrl;
-    m_webSocket->open(QUrl(m_targetUrl));
+    QUrl url = urlFor(m_version);
+    m_upgradeSent = false;
+    m_attemptOpened = false;
+    qDebug() << QString("[%1] 尝试连接...").arg(m_name) << url;
+    m_webSocket->open(url);
 }
 
 void SocketIoClient::onReconnectTimerOut()
@@ -70,54 +158,314 @@ void SocketIoClient::onReconnectTimerOut()
     doConnect();
 }
 
+// 等待时间 = min(reconnectMinMs * 2^n, reconnectMaxMs)，实际取其 [1/2, 1] 区间的随机值，
+// 避免多个客户端在服务端恢复的同一时刻集中重连
+void SocketIoClient::scheduleReconnect(bool probe)
+{
+    if (m_isManualClose) return;
+
+    if (!m_reconnectTimer->isActive()) {
+        int shift = qMin(m_reconnectAttempt, 16);
+        qint64 ceiling = qMin<qint64>(qint64(m_options.reconnectMinMs) << shift, m_options.reconnectMaxMs);
+        int half = int(ceiling / 2);
+        int delay = half + int(QRandomGenerator::global()->bounded(quint32(ceiling - half + 1)));
+        ++m_reconnectAttempt;
+        ++m_linkStats.attempts;
+        m_reconnectTimer->start(delay);
+    }
+
+    // 只在服务端不可达时探测 (握手被拒绝等情况端口本就可达，探测会绕过退避)；
+    // 探测仍在进行 (例如上一轮的 TCP 握手未超时) 则不重复发起
+    if (probe && m_probe->state() == QAbstractSocket::UnconnectedState) {
+        QUrl url(m_targetUrl);
+        int port = url.port(url.scheme() == "wss" ? 443 : 80);
+        m_probe->connectToHost(url.host(), quint16(port));
+    }
+}
+
+// 端口已可达：不再等待退避定时器，立即连接
+void SocketIoClient::onProbeConnected()
+{
+    m_probe->abort();
+    // 上一轮 WebSocket 已连通过 TCP (握手被拒绝)，端口可达不代表能连上，继续按退避等待
+    if (m_reconnectTimer->isActive() && !m_upgradeSent) {
+        m_reconnectTimer->stop();
+        doConnect();
+    }
+}
+
+void SocketIoClient::onSocketConnected()
+{
+    m_reconnectTimer->stop();
+    m_probe->abort();
+    qDebug() << QString("[%1] 物理连接建立").arg(m_name);
+    // 等待 open (0) 包；期间服务端无响应同样按链路超时处理
+    m_livenessTimer->start(m_pingIntervalMs + m_pingTimeoutMs);
+}
+
+void SocketIoClient::onSocketDisconnected()
+{
+    bool hadSession = m_opened;
+    m_opened = false;
+    m_namespaceConnected = false;
+    m_pingTimer->stop();
+    m_livenessTimer->stop();
+    m_binary = BinaryEvent();
+    m_pendingBytes = 0;
+
+    if (hadSession) {
+        // 恢复耗时从会话中断算起 (首次连接前的失败不计)
+        ++m_linkStats.drops;
+        if (!m_downClock.isValid()) m_downClock.start();
+        // 会话保持足够久才从最短间隔重新开始，服务端反复接受后立即断开时仍按退避放缓
+        if (m_sessionClock.isValid() && m_sessionClock.elapsed() >= m_options.reconnectMaxMs) {
+            m_reconnectAttempt = 0;
+        }
+        m_sessionClock.invalidate();
+        emit disconnected();
+    }
+
+    // 连接断开 -> 启动重连
+    scheduleReconnect();
+}
+
+// ============================================================================
+// 收包
+// Engine.IO: 0 open / 1 close / 2 ping / 3 pong / 4 message / 6 noop
+// Socket.IO (message 内): 0 connect / 1 disconnect / 2 event / 4 error / 5 binary event
+// ============================================================================
 void SocketIoClient::onTextMessageReceived(const QString &message)
 {
-    // --- 协议解析核心 ---
-    // Socket.IO 协议代码：
-    // '0' => Open (握手包)
-    // '40' => Connect (连接成功)
-    // '42' => Event (收到数据)
+    qint64 ingestNs = LatencyClock::nowNs();
+    touch();
+    if (m_textTap) m_textTap(message);
+    handlePacket(message, ingestNs, true);
+}
 
-    // qDebug() << "[DEBUG] 收到原始包:" << message; // 调试用
+void SocketIoClient::injectText(const QString &message)
+{
+    handlePacket(message, LatencyClock::nowNs(), false);
+}
 
-    // 心跳保持 ===
-    // 协议定义: '2' 是服务器发的 Ping
-    if (message == "2") {
-        // 我们必须回一个 '3' (Pong)
-        m_webSocket->sendTextMessage("3");
-        // qDebug() << "[SocketIO] 心跳回应 (Pong)"; // 嫌刷屏可以注释掉
+void SocketIoClient::handlePacket(const QString &message, qint64 ingestNs, bool live)
+{
+    if (message.isEmpty()) return;
+    QStringView packet(message);
+    const QChar engineType = packet[0];
+
+    if (engineType != u'4') {
+        if (!live) return;
+        if (engineType == u'0') {
+            handleOpen(packet.mid(1));
+        } else if (engineType == u'2') {
+            sendControl("3"); // 服务端 ping (EIO4)，回 pong
+        } else if (engineType == u'1') {
+            m_webSocket->abort();
+        }
+        // '3' pong / '6' noop：touch() 已刷新链路超时
         return;
     }
 
-    if (message.startsWith("0")) {
-        // 收到服务端握手包(0)后，必须回复连接指令(40)
-        // 否则服务器不知道你要连哪个命名空间（默认是 /）
-        m_webSocket->sendTextMessage("40");
-        qDebug() << "[SocketIO] 发送握手响应 (40)";
+    if (packet.size() < 2) return;
+    const QChar socketType = packet[1];
+
+    if (socketType == u'2') {
+        qsizetype start = arrayStart(packet, 2);
+        if (start >= 0) dispatch(packet, start, ingestNs);
+        return;
     }
-    else if (message.startsWith("40")) {
-        // 收到 40 代表真正连上了
-        qDebug() << "[SocketIO] 握手成功 (Connected)";
-        emit connected();
+
+    if (socketType == u'5') {
+        // 45<附件数>-[...]，随后是附件数个二进制帧
+        qsizetype dash = packet.indexOf(u'-', 2);
+        if (dash < 0) return;
+        int count = packet.mid(2, dash - 2).toInt();
+        qsizetype start = arrayStart(packet, dash + 1);
+        if (start < 0) return;
+        if (count <= 0) {
+            dispatch(packet, start, ingestNs);
+        } else {
+            BinaryEvent &binary = live ? m_binary : m_injected;
+            binary.header = message;
+            binary.expected = count;
+            binary.ingestNs = ingestNs;
+            binary.attachments.clear();
+        }
+        return;
     }
-    else if (message.startsWith("42")) {
-        // 处理事件数据: 42["event", data]
-        QString jsonPart = message.mid(2);
-        parseSocketIoMessage(jsonPart);
+
+    if (!live) return;
+    if (socketType == u'0') {
+        m_namespaceConnected = true;
+        if (m_downClock.isValid()) {
+            qint64 downMs = m_downClock.elapsed();
+            m_downClock.invalidate();
+            ++m_linkStats.recoveries;
+            m_linkStats.lastRecoverMs = downMs;
+            m_linkStats.maxRecoverMs = qMax(m_linkStats.maxRecoverMs, downMs);
+            m_linkStats.totalRecoverMs += downMs;
+            emit sigLog(QString("[%1] 握手成功 (EIO=%2)，中断 %3 ms 后恢复，重试 %4 次")
+                            .arg(m_name).arg(int(m_version)).arg(downMs).arg(m_reconnectAttempt));
+        } else {
+            emit sigLog(QString("[%1] 握手成功 (EIO=%2)").arg(m_name).arg(int(m_version)));
+        }
+        m_sessionClock.start();
+        emit connected();
+        flushOutbox();
+    } else if (socketType == u'1') {
+        m_namespaceConnected = false;
+    } else if (socketType == u'4') {
+        emit sigLog(QString("[%1] 服务端错误: %2").arg(m_name, message.mid(2)));
     }
 }
 
-void SocketIoClient::parseSocketIoMessage(const QString &msg)
+void SocketIoClient::onBinaryMessageReceived(const QByteArray &message)
+{
+    touch();
+    // EIO3 的二进制帧带 1 字节消息类型 (4) 前缀
+    QByteArray attachment = (m_version == EngineVersion::V3 && !message.isEmpty() && message.at(0) == 4)
+                                ? message.mid(1) : message;
+    if (m_binaryTap) m_binaryTap(attachment);
+    addAttachment(m_binary, attachment);
+}
+
+void SocketIoClient::injectBinary(const QByteArray &attachment)
 {
-    QJsonDocument doc = QJsonDocument::fromJson(msg.toUtf8());
-    if (doc.isArray()) {
+    addAttachment(m_injected, attachment);
+}
+
+// 收齐附件数个附件后连同头部一起分发
+void SocketIoClient::addAttachment(BinaryEvent &binary, const QByteArray &attachment)
+{
+    if (binary.expected <= 0) return;
+    binary.attachments.append(attachment);
+    if (binary.attachments.size() < binary.expected) return;
+
+    binary.expected = 0;
+    QStringView header(binary.header);
+    qsizetype dash = header.indexOf(u'-', 2);
+    qsizetype start = arrayStart(header, dash + 1);
+    if (start >= 0) dispatch(header, start, binary.ingestNs, &binary.attachments);
+    binary.attachments.clear();
+}
+
+// 按事件名查表分发：[ "name" , data ]
+void SocketIoClient::dispatch(QStringView packet, qsizetype start, qint64 ingestNs,
+                              const QList<QByteArray> *attachments)
+{
+    qsizetype pos = skipSpace(packet, start + 1);
+    if (pos >= packet.size() || packet[pos] != u'"') return;
+    qsizetype nameStart = ++pos;
+    while (pos < packet.size() && packet[pos] != u'"') {
+        pos += (packet[pos] == u'\\') ? 2 : 1;
+    }
+    if (pos >= packet.size()) return;
+
+    Event event;
+    event.name = packet.mid(nameStart, pos - nameStart);
+    event.packet = packet;
+    event.ingestNs = ingestNs;
+    event.attachments = attachments;
+    pos = skipSpace(packet, pos + 1);
+    if (pos < packet.size() && packet[pos] == u',') event.data = packet.mid(pos + 1);
+
+    // 注册的事件只有几个：直接拿包内的名字视图逐个比较，分发路径不构造 QString
+    for (const HandlerEntry &entry : std::as_const(m_handlers)) {
+        if (entry.name == event.name) {
+            entry.handler(event);
+            return;
+        }
+    }
+
+    // 未注册的事件：兼容旧接口，有接收者时才构建 JSON
+    static const QMetaMethod fallback = QMetaMethod::fromSignal(&SocketIoClient::eventReceived);
+    if (isSignalConnected(fallback)) {
+        QJsonDocument doc = QJsonDocument::fromJson(packet.mid(start).toUtf8());
         QJsonArray arr = doc.array();
-        if (arr.size() >= 2) {
-            QString eventName = arr[0].toString();
-            QJsonValue data = arr[1];
+        if (arr.size() >= 2) emit eventReceived(arr.at(0).toString(), arr.at(1));
+    }
+}
+
+// 握手：0{"sid":"...","pingInterval":25000,"pingTimeout":20000}
+void SocketIoClient::handleOpen(QStringView payload)
+{
+    QJsonObject obj = QJsonDocument::fromJson(payload.toUtf8()).object();
+    m_pingIntervalMs = obj.value("pingInterval").toInt(m_pingIntervalMs);
+    m_pingTimeoutMs = obj.value("pingTimeout").toInt(m_pingTimeoutMs);
+    m_opened = true;
+    m_attemptOpened = true;
+    m_pendingBytes = 0;
+
+    if (m_version == EngineVersion::V4) {
+        // EIO4 须由客户端发起默认命名空间连接
+        sendControl("40");
+    } else {
+        // EIO3 由客户端发 ping，比服务端要求的间隔提前 5 秒，确保不超时
+        int interval = (m_pingIntervalMs > 5000) ? (m_pingIntervalMs - 5000) : m_pingIntervalMs;
+        m_pingTimer->start(interval);
+    }
+    touch();
+
+    emit sigLog(QString("[%1] Engine.IO 已打开 (EIO=%2)，心跳间隔: %3ms")
+                    .arg(m_name).arg(int(m_version)).arg(m_pingIntervalMs));
+}
 
-            // qDebug() << "[SocketIO Event]" << eventName;
-            emit eventReceived(eventName, data);
+void SocketIoClient::onPingTimeout()
+{
+    sendControl("2");
+}
+
+void SocketIoClient::touch()
+{
+    if (m_opened || m_livenessTimer->isActive()) {
+        m_livenessTimer->start(m_pingIntervalMs + m_pingTimeoutMs);
+    }
+}
+
+void SocketIoClient::onLivenessTimeout()
+{
+    emit sigLog(QString("[%1] %2ms 内未收到数据，链路失效，重新连接")
+                    .arg(m_name).arg(m_pingIntervalMs + m_pingTimeoutMs));
+    m_webSocket->abort();
+}
+
+// ============================================================================
+// 发送：控制包直接写出；事件经发送缓冲，受高水位限制
+// ============================================================================
+void SocketIoClient::sendControl(const QString &packet)
+{
+    if (!m_webSocket->isValid()) return;
+    m_pendingBytes += m_webSocket->sendTextMessage(packet);
+}
+
+void SocketIoClient::emitEvent(const QString &event, const QJsonValue &data)
+{
+    QJsonArray arr;
+    arr.append(event);
+    arr.append(data);
+    m_outbox.append("42" + QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact)));
+
+    if (m_outbox.size() > m_options.maxQueued) {
+        m_outbox.removeFirst();
+        if (++m_dropped % 100 == 1) {
+            emit sigLog(QString("[%1] 发送积压，已丢弃 %2 条旧事件").arg(m_name).arg(m_dropped));
         }
     }
+    flushOutbox();
+}
+
+void SocketIoClient::onBytesWritten(qint64 bytes)
+{
+    // 会话打开前写出的只有 HTTP 升级请求：TCP 已连通
+    if (!m_opened) m_upgradeSent = true;
+    m_pendingBytes = qMax<qint64>(0, m_pendingBytes - bytes);
+    flushOutbox();
+}
+
+void SocketIoClient::flushOutbox()
+{
+    if (!m_namespaceConnected) return;
+    while (!m_outbox.isEmpty() && m_pendingBytes < m_options.highWaterBytes) {
+        m_pendingBytes += m_webSocket->sendTextMessage(m_outbox.takeFirst());
+    }
 }
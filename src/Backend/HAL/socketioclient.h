@@ -4,35 +4,170 @@
 #include <QObject>
 #include <QWebSocket>
 #include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
 #include <QTimer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <functional>
 
+// ============================================================================
+// Socket.IO 客户端 (WebSocket 传输)
+//
+// 所有 Socket.IO 事件源共用：
+//   - Engine.IO 版本协商：按 URL 中的 EIO 参数连接，TCP 已连通但握手被拒绝则下次改用另一版本；
+//     EIO3 由客户端发 ping，EIO4 由服务端 ping、客户端回 pong；
+//     超过 pingInterval + pingTimeout 未收到任何数据视为链路失效，主动断开重连
+//   - 事件分发：按事件名在处理函数表中查找 (哈希)，处理函数直接拿到事件数据的
+//     文本视图，自行流式解析，不经过 QJsonDocument
+//   - 二进制事件 (45x-)：收齐 x 个二进制附件后一起分发
+//   - 发送缓冲：未连接或 WebSocket 待写字节超过高水位时排队，写出后再继续；
+//     排队超过上限丢弃最旧的事件
+//   - 重连：指数退避 (从几十毫秒起，封顶 reconnectMaxMs) 加随机抖动；服务端不可达时
+//     等待期间并行做 DNS/TCP 预连接探测，端口一旦可达立即发起 WebSocket 连接
+// ============================================================================
 class SocketIoClient : public QObject
 {
     Q_OBJECT
 public:
-    explicit SocketIoClient(QObject *parent = nullptr);
+    enum class EngineVersion { V3 = 3, V4 = 4 };
+
+    // 分发给处理函数的事件，视图只在回调期间有效
+    struct Event {
+        QStringView name;
+        QStringView data;   // 事件名之后的 JSON 文本 (到包尾)
+        QStringView packet; // 完整 Socket.IO 包 (含 "42" 前缀)
+        const QList<QByteArray> *attachments = nullptr; // 二进制事件的附件，普通事件为空
+        qint64 ingestNs = 0; // 帧到达时刻 (LatencyClock)
+    };
+    using Handler = std::function<void(const Event &event)>;
+
+    struct Options {
+        int reconnectMinMs = 50;            // 首次重连等待 (之后每次翻倍)
+        int reconnectMaxMs = 3000;          // 重连等待上限
+        qint64 highWaterBytes = 256 * 1024; // WebSocket 待写字节高水位
+        int maxQueued = 256;                // 发送排队上限
+    };
+
+    explicit SocketIoClient(const QString &name = "SocketIO", QObject *parent = nullptr);
+
+    void setOptions(const Options &options) { m_options = options; }
+
+    // 注册事件处理函数 (同名覆盖)
+    void on(const QString &event, Handler handler);
+    // 原始文本帧旁路 (录制用，可为空)
+    void setTextTap(std::function<void(const QString &)> tap) { m_textTap = std::move(tap); }
+    // 二进制附件旁路 (录制用，可为空)，拿到的是去掉 EIO3 类型前缀后的附件内容
+    void setBinaryTap(std::function<void(const QByteArray &)> tap) { m_binaryTap = std::move(tap); }
+
     void connectToServer(const QString &url);
+    void close();
+
+    bool isConnected() const { return m_namespaceConnected; }
+    EngineVersion version() const { return m_version; }
+
+    // 发送事件 42["name", data]
+    void emitEvent(const QString &event, const QJsonValue &data);
+    int queuedCount() const { return m_outbox.size(); }
+    quint64 droppedCount() const { return m_dropped; }
+
+    // 链路统计：会话中断 -> 重新握手成功 的恢复耗时
+    struct LinkStats {
+        quint64 drops = 0;       // 会话中断次数
+        quint64 attempts = 0;    // 重连尝试次数
+        quint64 recoveries = 0;  // 恢复次数
+        qint64 lastRecoverMs = 0;
+        qint64 maxRecoverMs = 0;
+        qint64 totalRecoverMs = 0;
+    };
+    const LinkStats &linkStats() const { return m_linkStats; }
+
+public slots:
+    // 回放/合成数据注入：只分发业务事件，不处理握手与心跳；
+    // 二进制事件的附件随后经 injectBinary 注入 (与线上收包分开拼装)
+    void injectText(const QString &message);
+    void injectBinary(const QByteArray &attachment);
 
 signals:
     void connected();
     void disconnected();
-    // 收到事件信号：eventName (如 "droneStatus"), data (JSON数据)
+    // 未注册处理函数的事件 (有连接时才构建 JSON)
     void eventReceived(const QString &eventName, const QJsonValue &data);
+    void sigLog(const QString &msg);
 
 private slots:
+    void onSocketConnected();
+    void onSocketDisconnected();
     void onTextMessageReceived(const QString &message);
+    void onBinaryMessageReceived(const QByteArray &message);
+    void onBytesWritten(qint64 bytes);
     void onReconnectTimerOut();
+    void onPingTimeout();
+    void onLivenessTimeout();
+    void onProbeConnected();
 
 private:
+    void doConnect();
+    // 按退避间隔启动重连定时器；probe = 服务端不可达，同时开始预连接探测
+    void scheduleReconnect(bool probe = false);
+    QUrl urlFor(EngineVersion version) const;
+    void handleOpen(QStringView payload);
+    void handlePacket(const QString &message, qint64 ingestNs, bool live);
+    // 二进制事件 (45x-) 等待附件的拼装状态
+    struct BinaryEvent {
+        QString header;
+        int expected = 0;
+        qint64 ingestNs = 0;
+        QList<QByteArray> attachments;
+    };
+    void addAttachment(BinaryEvent &binary, const QByteArray &attachment);
+    void dispatch(QStringView packet, qsizetype arrayStart, qint64 ingestNs,
+                  const QList<QByteArray> *attachments = nullptr);
+    void sendControl(const QString &packet);
+    void flushOutbox();
+    void touch(); // 收到任何数据，重置链路超时
+
+    QString m_name;
+    Options m_options;
     QWebSocket *m_webSocket;
-    void parseSocketIoMessage(const QString &msg);
 
     // 重连机制变量
     QTimer *m_reconnectTimer;
-    QString m_targetUrl;      // 保存目标地址
+    QString m_targetUrl;      // 保存目标地址 (不含 EIO 参数)
     bool m_isManualClose;     // 标记是否是用户手动关闭
+    int m_reconnectAttempt = 0; // 连续重连次数 (会话稳定保持 reconnectMaxMs 以上才清零)
+    QElapsedTimer m_sessionClock; // 本次会话握手成功时刻
+    QTcpSocket *m_probe;      // 预连接探测 (解析主机名 + TCP 握手)
+    QElapsedTimer m_downClock; // 会话中断起点，恢复后失效
+    LinkStats m_linkStats;
+
+    // Engine.IO 会话
+    EngineVersion m_version = EngineVersion::V4;
+    bool m_upgradeSent = false;        // 本次连接的 HTTP 升级请求已写出 (TCP 已连通)
+    bool m_attemptOpened = false;      // 本次连接曾打开会话 (之后的错误不再视为握手被拒绝)
+    bool m_opened = false;             // 已收到 open (0) 包
+    bool m_namespaceConnected = false; // 已收到 connect (40) 包
+    QTimer *m_pingTimer;     // EIO3 客户端心跳
+    QTimer *m_livenessTimer; // 链路超时
+    int m_pingIntervalMs = 25000;
+    int m_pingTimeoutMs = 20000;
+
+    struct HandlerEntry {
+        QString name;
+        Handler handler;
+    };
+    QList<HandlerEntry> m_handlers; // 按注册顺序，事件名与包内视图直接比较
+    std::function<void(const QString &)> m_textTap;
+    std::function<void(const QByteArray &)> m_binaryTap;
+
+    // 二进制事件：等待附件 (线上 / 回放注入)
+    BinaryEvent m_binary;
+    BinaryEvent m_injected;
 
-    void doConnect();         // 内部连接执行函数
+    // 发送缓冲
+    QList<QString> m_outbox;
+    qint64 m_pendingBytes = 0;
+    quint64 m_dropped = 0;
 };
 
 #endif // SOCKETIOCLIENT_H
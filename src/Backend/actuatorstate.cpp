@@ -0,0 +1,66 @@
+#include "actuatorstate.h"
+
+ActuatorState::ActuatorState(quint32 validMask, qint64 settleMs)
+    : m_valid(validMask), m_settleMs(settleMs)
+{
+    m_writtenMs.fill(-1);
+}
+
+void ActuatorState::setDesired(quint32 mask, quint32 value)
+{
+    mask &= m_valid;
+    m_desired = (m_desired & ~mask) | (value & mask);
+    m_commanded |= mask;
+}
+
+void ActuatorState::setActual(quint32 mask, quint32 value, qint64 nowMs)
+{
+    mask &= m_valid;
+    m_actual = (m_actual & ~mask) | (value & mask);
+    m_known |= mask;
+
+    // 刚写出的位保留预期 (回复可能早于指令生效)，其余以设备回复为准
+    quint32 settled = mask & ~settlingBits(nowMs);
+    m_expected = (m_expected & ~settled) | (value & settled);
+    m_expectedKnown |= settled;
+}
+
+void ActuatorState::invalidate()
+{
+    m_known = 0;
+    m_expectedKnown = 0;
+}
+
+quint32 ActuatorState::delta() const
+{
+    return m_commanded & (~m_expectedKnown | (m_desired ^ m_expected));
+}
+
+void ActuatorState::markWritten(quint32 mask, qint64 nowMs)
+{
+    mask &= m_valid;
+    m_expected = (m_expected & ~mask) | (m_desired & mask);
+    m_expectedKnown |= mask;
+    for (int bit = 0; bit < 32; ++bit) {
+        if (mask & (1u << bit)) m_writtenMs[bit] = nowMs;
+    }
+}
+
+quint32 ActuatorState::settlingBits(qint64 nowMs) const
+{
+    quint32 settling = 0;
+    for (int bit = 0; bit < 32; ++bit) {
+        if (m_writtenMs[bit] >= 0 && nowMs - m_writtenMs[bit] < m_settleMs) settling |= 1u << bit;
+    }
+    return settling;
+}
+
+quint32 ActuatorState::stuckBits(qint64 nowMs) const
+{
+    quint32 written = 0;
+    for (int bit = 0; bit < 32; ++bit) {
+        if (m_writtenMs[bit] >= 0) written |= 1u << bit;
+    }
+    quint32 mismatch = m_commanded & m_known & (m_desired ^ m_actual);
+    return mismatch & written & ~settlingBits(nowMs);
+}
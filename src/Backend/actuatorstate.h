@@ -0,0 +1,61 @@
+#ifndef ACTUATORSTATE_H
+#define ACTUATORSTATE_H
+
+#include <QtGlobal>
+#include <array>
+
+// ============================================================================
+// 执行设备 期望状态 / 实际状态 (位掩码，最多 32 路)
+//
+// 业务层只设置期望状态；驱动根据设备回复 (回显、状态上报、读回) 更新实际
+// 状态，并只下发两者不一致的位 (delta)。已下发但尚未确认的位记为“预期”，
+// 避免同一变更在确认前被重复发送；写出后 settleMs 内到达的旧状态不覆盖预期
+// (指令还在途或设备尚未动作)。
+// 写出超过 settleMs 后实际状态仍与期望不符，即判定为卡滞 (stuckBits)，
+// 此时预期回落为实际状态，delta 会再次包含该位以便重发。
+// ============================================================================
+class ActuatorState
+{
+public:
+    explicit ActuatorState(quint32 validMask = 0xFFFFFFFFu, qint64 settleMs = 500);
+
+    // 设置 mask 内各位的期望值
+    void setDesired(quint32 mask, quint32 value);
+    quint32 desired() const { return m_desired; }
+    bool isCommanded(quint32 mask) const { return (m_commanded & mask) == mask; }
+
+    // 设备回复的实际状态 (mask 内各位)；读回整组时 mask 传 validMask
+    void setActual(quint32 mask, quint32 value, qint64 nowMs);
+    quint32 actual() const { return m_actual; }
+    bool isKnown() const { return (m_known & m_valid) == m_valid; }
+
+    // 链路断开后实际状态未知，下次需整组下发
+    void invalidate();
+
+    // 需要下发的位：已设置期望，且 (实际未知 或 预期状态与期望不符)
+    quint32 delta() const;
+
+    // 整组写出时的目标值：设置过期望的位取期望，其余位保持预期状态
+    quint32 target() const { return ((m_desired & m_commanded) | (m_expected & ~m_commanded)) & m_valid; }
+
+    // 写出 mask 内各位 (值为当前期望) 的时刻
+    void markWritten(quint32 mask, qint64 nowMs);
+
+    // 写出已超过 settleMs、实际状态仍与期望不符的位
+    quint32 stuckBits(qint64 nowMs) const;
+
+private:
+    quint32 settlingBits(qint64 nowMs) const; // 写出不足 settleMs 的位
+
+    quint32 m_valid;
+    qint64 m_settleMs;
+    quint32 m_desired = 0;
+    quint32 m_commanded = 0; // 业务层设置过期望的位
+    quint32 m_actual = 0;
+    quint32 m_known = 0;     // 实际状态已知的位
+    quint32 m_expected = 0;  // 实际状态叠加已写出未确认的值
+    quint32 m_expectedKnown = 0;
+    std::array<qint64, 32> m_writtenMs; // 各位最近一次写出时刻，-1 = 未写出
+};
+
+#endif // ACTUATORSTATE_H
@@ -0,0 +1,127 @@
+#include "commandscheduler.h"
+
+CommandScheduler::CommandScheduler(const QString &name, const Options &options, QObject *parent)
+    : QObject(parent), m_name(name), m_options(options)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &CommandScheduler::onTimer);
+}
+
+void CommandScheduler::submit(const QString &setting, Transmit transmit, Priority priority)
+{
+    bool background = priority == Priority::Background;
+
+    // 普通指令不等后台指令的确认：放弃在途的后台指令 (其回复晚到时由驱动按内容处理)
+    if (!background && m_inFlight && m_queue.first().background) {
+        m_queue.removeFirst();
+        m_inFlight = false;
+        m_timer->stop();
+        ++m_preempted;
+    }
+
+    // 在途指令 (队首且已发出) 不能撤回，只合并还在排队的
+    int first = m_inFlight ? 1 : 0;
+    for (int i = first; i < m_queue.size(); ++i) {
+        if (m_queue.at(i).setting == setting) {
+            m_queue.removeAt(i);
+            ++m_coalesced;
+            break; // 同一设置项最多排队一条
+        }
+    }
+
+    Command cmd;
+    cmd.setting = setting;
+    cmd.transmit = std::move(transmit);
+    cmd.background = background;
+
+    // 普通指令插在排队的后台指令之前
+    int pos = m_queue.size();
+    if (!background) {
+        for (int i = first; i < m_queue.size(); ++i) {
+            if (m_queue.at(i).background) {
+                pos = i;
+                break;
+            }
+        }
+    }
+    m_queue.insert(pos, std::move(cmd));
+    pump();
+}
+
+void CommandScheduler::acknowledge()
+{
+    if (!m_inFlight) return;
+    m_inFlight = false;
+    m_timer->stop();
+    if (!m_queue.isEmpty()) m_queue.removeFirst();
+    pump();
+}
+
+void CommandScheduler::clear()
+{
+    m_queue.clear();
+    m_inFlight = false;
+    m_timer->stop();
+}
+
+// ============================================================================
+// 发送下一条：限速未到则定时等待；写出失败或确认超时都按重试处理
+// ============================================================================
+void CommandScheduler::pump()
+{
+    if (m_inFlight || m_queue.isEmpty()) return;
+
+    if (m_lastSend.isValid()) {
+        qint64 wait = m_options.minIntervalMs - m_lastSend.elapsed();
+        if (wait > 0) {
+            if (!m_timer->isActive()) m_timer->start(int(wait));
+            return;
+        }
+    }
+
+    Command &cmd = m_queue.first();
+    if (cmd.attempts > 0) ++m_retries;
+    ++cmd.attempts;
+    m_lastSend.restart();
+
+    if (!cmd.transmit()) {
+        if (cmd.attempts > m_options.maxRetries) {
+            dropFront("写出失败");
+        } else {
+            m_timer->start(qMax(m_options.minIntervalMs, m_options.ackTimeoutMs));
+        }
+        return;
+    }
+
+    ++m_sent;
+    if (m_options.requireAck) {
+        m_inFlight = true;
+        m_timer->start(m_options.ackTimeoutMs);
+        return;
+    }
+
+    m_queue.removeFirst();
+    if (!m_queue.isEmpty()) m_timer->start(m_options.minIntervalMs);
+}
+
+void CommandScheduler::onTimer()
+{
+    if (m_inFlight) {
+        // 确认超时
+        m_inFlight = false;
+        if (!m_queue.isEmpty() && m_queue.first().attempts > m_options.maxRetries) {
+            dropFront("确认超时");
+        }
+    }
+    pump();
+}
+
+void CommandScheduler::dropFront(const QString &reason)
+{
+    Command cmd = m_queue.takeFirst();
+    ++m_dropped;
+    emit sigLog(QString("[%1] 指令 %2 %3，已重试 %4 次，放弃")
+                    .arg(m_name, cmd.setting, reason).arg(cmd.attempts - 1));
+    if (!m_queue.isEmpty()) m_timer->start(m_options.minIntervalMs);
+}
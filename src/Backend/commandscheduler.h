@@ -0,0 +1,92 @@
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+
+// ============================================================================
+// 单设备指令调度
+//
+// 每个设备驱动持有一个调度器，所有下发指令按设置项 (如 "switch"、"mode"、
+// "ch3") 提交：
+//   - 合并：同一设置项尚未发出的旧指令被新指令取代 (后写者胜)，新指令排到队尾，
+//     保证最终状态与最后一次调用一致；侦测抖动时队列长度不超过设置项个数
+//   - 限速：两次写出之间至少间隔 minIntervalMs
+//   - 确认：requireAck 时每条指令等待设备确认 (acknowledge) 后才发下一条，
+//     超时重发，超过 maxRetries 后丢弃并记日志
+//   - 优先级：后台指令 (如周期读回) 排在所有普通指令之后；普通指令到达时
+//     正在等待确认的后台指令被放弃 (不重发)，不让处置指令等后台指令的确认
+// 队列空闲且不受限速时指令在 submit() 内同步写出，不增加处置延迟。
+// ============================================================================
+class CommandScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    // 写出一条指令；返回 false 表示未能写出 (如链路未连接)，稍后重试
+    using Transmit = std::function<bool()>;
+
+    enum class Priority { Normal, Background };
+
+    struct Options {
+        int minIntervalMs = 50;
+        bool requireAck = false;
+        int ackTimeoutMs = 500;
+        int maxRetries = 2;
+    };
+
+    CommandScheduler(const QString &name, const Options &options, QObject *parent = nullptr);
+
+    void submit(const QString &setting, Transmit transmit, Priority priority = Priority::Normal);
+
+    // 设备确认当前在途指令
+    void acknowledge();
+    // 在途 (已发出、等待确认) 指令的设置项，没有时为空
+    QString inFlightSetting() const { return m_inFlight ? m_queue.first().setting : QString(); }
+
+    // 丢弃所有排队指令 (在途指令的确认仍可到达，但不再重发)
+    void clear();
+
+    bool isIdle() const { return m_queue.isEmpty(); }
+    int pendingCount() const { return m_queue.size(); }
+    quint64 sentCount() const { return m_sent; }
+    quint64 coalescedCount() const { return m_coalesced; }
+    quint64 retryCount() const { return m_retries; }
+    quint64 droppedCount() const { return m_dropped; }
+    quint64 preemptedCount() const { return m_preempted; }
+
+signals:
+    void sigLog(const QString &msg);
+
+private slots:
+    void onTimer();
+
+private:
+    struct Command {
+        QString setting;
+        Transmit transmit;
+        int attempts = 0;
+        bool background = false;
+    };
+
+    void pump();
+    void dropFront(const QString &reason);
+
+    QString m_name;
+    Options m_options;
+    QList<Command> m_queue; // 队首为下一条 (或在途) 指令
+    bool m_inFlight = false;
+    QElapsedTimer m_lastSend;
+    QTimer *m_timer;
+
+    quint64 m_sent = 0;
+    quint64 m_coalesced = 0;
+    quint64 m_retries = 0;
+    quint64 m_dropped = 0;
+    quint64 m_preempted = 0;
+};
+
+#endif // COMMANDSCHEDULER_H
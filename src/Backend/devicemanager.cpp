@@ -1,6 +1,14 @@
 #include "devicemanager.h"
 #include "../Utils/configloader.h"
 #include "Consts.h"
+#include <QDir>
+#include <QDateTime>
+#include <QtMath>
+
+namespace {
+const double REORIGIN_DISTANCE_M = 200.0; // 基站位移超过此值才重建本地坐标系
+const qint64 TRACK_EXPIRY_MS = 4000;      // 航迹超时 (侦测链路正常时)
+}
 
 // ============================================================================
 // 1. 初始化
@@ -17,19 +25,40 @@ DeviceManager::DeviceManager(QObject *parent) : QObject(parent)
     m_baseLat = Config::BASE_LAT;
     m_baseLng = Config::BASE_LON;
 
-    // 防抖定时器 (3秒)
+    // 航迹超时清理 (没有新帧到达时也要移除消失的目标)
+    m_trackClock.start();
+    m_trackExpiryTimer = new QTimer(this);
+    m_trackExpiryTimer->setInterval(500);
+    connect(m_trackExpiryTimer, &QTimer::timeout, this, &DeviceManager::onTrackExpiryTimeout);
+    m_trackExpiryTimer->start();
+    m_droneTracks.setExpiry(TRACK_EXPIRY_MS);
+    m_imageTracks.setExpiry(TRACK_EXPIRY_MS);
+
+    ConfigLoader config;
+
+    // 威胁评估策略 + 防抖定时器 (默认 3 秒)
+    m_threats.setPolicy(config.threatPolicy());
     m_stopDefenseTimer = new QTimer(this);
-    m_stopDefenseTimer->setInterval(3000);
+    m_stopDefenseTimer->setInterval(m_threats.policy().stopDelayMs);
     m_stopDefenseTimer->setSingleShot(true);
     connect(m_stopDefenseTimer, &QTimer::timeout, this, &DeviceManager::onStopDefenseTimeout);
 
-    ConfigLoader config;
+    // 围栏与威胁评估共用以基站为原点的本地坐标系
+    Geodesy::LocalProjection localFrame(m_baseLat, m_baseLng);
+    m_geofence.setZones(config.geofenceZones(), config.geofenceCellM());
+    m_geofence.setProjection(localFrame);
+    m_threats.setGeofence(&m_geofence);
+    m_threats.setProjection(localFrame);
+    if (!m_geofence.isEmpty()) {
+        log(QString("[围栏] 已加载 %1 个区域").arg(m_geofence.zoneCount()));
+    }
 
     // 1. 诱骗 (UDP)
     QString spoofTargetIp = "192.168.10.230";
     int spoofTargetPort = 9099;
     m_spoofDriver = new SpoofDriver(spoofTargetIp, spoofTargetPort, this);
-    connect(m_spoofDriver, &SpoofDriver::sigSpoofLog, this, &DeviceManager::sigLogMessage);
+    m_spoofDriver->setLatencyTracer(&m_latency);
+    connect(m_spoofDriver, &SpoofDriver::sigSpoofLog, this, &DeviceManager::log);
 
     // 【连接诱骗坐标】这是主要且准确的坐标源
     connect(m_spoofDriver, &SpoofDriver::sigDevicePosition, this, &DeviceManager::onDevicePositionUpdated);
@@ -37,46 +66,171 @@ DeviceManager::DeviceManager(QObject *parent) : QObject(parent)
     // 2. 干扰 (HTTP)
     m_jammerDriver = new JammerDriver(this);
     m_jammerDriver->setTarget("192.178.1.12", 8090);
-    connect(m_jammerDriver, &JammerDriver::sigLog, this, &DeviceManager::sigLogMessage);
-
-    // 3. 侦测 (WebSocket)
-    m_detectionDriver = new DetectionDriver(this);
+    connect(m_jammerDriver, &JammerDriver::sigLog, this, &DeviceManager::log);
+
+    // 3. 侦测 (按配置接入一个或多个数据源，上报经融合后进入航迹库)
+    DetectionSource::Settings detectionSettings = config.detectionSettings();
+    TrackFusion::Options fusionOptions;
+    fusionOptions.windowMs = config.fusionWindowMs();
+    m_fusion.setOptions(fusionOptions);
+    for (const DetectionSource::Config &source : config.detectionSources()) {
+        addDetectionSource(createDetectionSource(source, detectionSettings));
+    }
+    if (m_detectionSources.size() > 1) {
+        log(QString("[侦测] 已配置 %1 个数据源，目标按序列号/追踪 ID 融合").arg(m_detectionSources.size()));
+    }
 
-    // 连接信号
-    connect(m_detectionDriver, &DetectionDriver::sigDroneListUpdated,
-            this, &DeviceManager::onDroneListUpdated);
-    connect(m_detectionDriver, &DetectionDriver::sigImageListUpdated,
-            this, &DeviceManager::onImageListUpdated);
+    // 回放/合成数据注入第一个 Socket.IO 数据源 (没有则单独创建一个，不主动连接)
+    for (DetectionSource *source : std::as_const(m_detectionSources)) {
+        m_detectionDriver = qobject_cast<DetectionDriver *>(source);
+        if (m_detectionDriver) break;
+    }
+    if (!m_detectionDriver) {
+        m_detectionDriver = new DetectionDriver(DetectionSource::Config(), detectionSettings, this);
+        addDetectionSource(m_detectionDriver);
+    }
 
     // ==========================================================================
     // 【关键修改 1】已删除侦测系统的坐标连接！
     // 之前这里连了 sigDevicePositionUpdated，导致侦测发来的 0.0 会覆盖诱骗的正确坐标
     // ==========================================================================
 
-    connect(m_detectionDriver, &DetectionDriver::sigLog,
-            this, &DeviceManager::sigLogMessage);
-
-    // 启动 WebSocket 连接
-    QString wsUrl = "ws://192.178.1.12:8090/socket.io/?EIO=3&transport=websocket";
-    m_detectionDriver->startWork(wsUrl);
+    // 断线宽限期：保留最后已知目标，超时仍未恢复才清除
+    m_staleGraceTimer = new QTimer(this);
+    m_staleGraceTimer->setSingleShot(true);
+    m_staleGraceTimer->setInterval(detectionSettings.staleGraceMs);
+    connect(m_staleGraceTimer, &QTimer::timeout, this, &DeviceManager::onStaleGraceTimeout);
 
     // 4. 压制 (Relay TCP)
-    m_relayDriver = new RelayDriver(this);
+    m_relayDriver = new RelayDriver(config.relaySettings(), this);
+    m_relayDriver->setLatencyTracer(&m_latency);
 
     // 连接日志，这样你就能看到 "[压制] TCP 连接成功" 了
-    connect(m_relayDriver, &RelayDriver::sigLog, this, &DeviceManager::sigLogMessage);
+    connect(m_relayDriver, &RelayDriver::sigLog, this, &DeviceManager::log);
+
+    // 5. 录制 / 回放
+    if (config.isCaptureEnabled()) {
+        QDir().mkpath(config.captureDir());
+        QString path = QString("%1/capture_%2.dsrec")
+                           .arg(config.captureDir(), QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+        m_recorder = new StreamRecorder;
+        if (m_recorder->open(path)) {
+            m_detectionDriver->setRecorder(m_recorder);
+            m_spoofDriver->setRecorder(m_recorder);
+            m_relayDriver->setRecorder(m_recorder);
+            // 数据流中断时不再有 record() 触发写盘，定时把缓冲落盘
+            m_recordFlushTimer = new QTimer(this);
+            connect(m_recordFlushTimer, &QTimer::timeout, this, [this]() { m_recorder->flush(); });
+            m_recordFlushTimer->start(StreamRecorder::FLUSH_INTERVAL_MS);
+            log(QString("[录制] 原始数据流写入: %1").arg(path));
+        } else {
+            log(QString("[录制] 无法创建录制文件: %1").arg(path));
+            delete m_recorder;
+            m_recorder = nullptr;
+        }
+    }
+
+    if (!config.replayFile().isEmpty()) {
+        m_replayDriver = new ReplayDriver(this);
+        m_replayDriver->setSpeed(config.replaySpeed());
+        m_replayDriver->setLoop(config.isReplayLoop());
+        connect(m_replayDriver, &ReplayDriver::sigLog, this, &DeviceManager::log);
+        connect(m_replayDriver, &ReplayDriver::sigDetectionFrame,
+                m_detectionDriver, &DetectionDriver::injectTextFrame);
+        connect(m_replayDriver, &ReplayDriver::sigDetectionBinary,
+                m_detectionDriver, &DetectionDriver::injectBinaryFrame);
+        connect(m_replayDriver, &ReplayDriver::sigSpoofDatagram,
+                m_spoofDriver, &SpoofDriver::injectDatagram);
+        connect(m_replayDriver, &ReplayDriver::sigFinished, this, &DeviceManager::reportLatency);
+        if (!m_replayDriver->open(config.replayFile())) {
+            delete m_replayDriver;
+            m_replayDriver = nullptr;
+        }
+    }
+
+    // 合成数据源 (回放优先)
+    if (!m_replayDriver && config.isSyntheticEnabled()) {
+        SyntheticDriver::Settings synthetic = config.syntheticSettings();
+        synthetic.centerLat = m_baseLat;
+        synthetic.centerLng = m_baseLng;
+        m_syntheticDriver = new SyntheticDriver(synthetic, this);
+        connect(m_syntheticDriver, &SyntheticDriver::sigLog, this, &DeviceManager::log);
+        connect(m_syntheticDriver, &SyntheticDriver::sigFrame,
+                m_detectionDriver, &DetectionDriver::injectTextFrame);
+    }
+
+    // 负载统计：处理帧率 + 后端线程事件循环利用率
+    m_eventLoopReportSec = config.eventLoopReportSec();
+    m_loadReportTimer = new QTimer(this);
+    connect(m_loadReportTimer, &QTimer::timeout, this, &DeviceManager::onLoadReportTimeout);
+
+    // 6. 延迟统计定期输出
+    m_latencyReportFile = config.latencyReportFile();
+    m_latencyReportTimer = new QTimer(this);
+    connect(m_latencyReportTimer, &QTimer::timeout, this, &DeviceManager::reportLatency);
+    if (config.latencyReportSec() > 0) {
+        m_latencyReportTimer->start(config.latencyReportSec() * 1000);
+    }
+}
+
+DeviceManager::~DeviceManager()
+{
+    // 退出时保存最终统计
+    if (m_latency.totalSamples() > 0 && !m_latencyReportFile.isEmpty()) {
+        m_latency.dumpToFile(m_latencyReportFile);
+    }
+
+    // 驱动 (子对象) 在此之后才析构，先解除录制指针
+    if (m_recorder) {
+        m_recordFlushTimer->stop();
+        m_detectionDriver->setRecorder(nullptr);
+        m_spoofDriver->setRecorder(nullptr);
+        m_relayDriver->setRecorder(nullptr);
+        delete m_recorder;
+    }
+}
+
+// ============================================================================
+// 启动所有链路
+// 构造函数只创建对象；网络连接在此处发起，保证 socket 在所属线程中创建/绑定
+// (线程模式下通过 QThread::started 排队调用)
+// ============================================================================
+void DeviceManager::start()
+{
+    if (m_replayDriver) {
+        // 回放模式：侦测帧与诱骗上报来自录制文件，指令仍发往配置的设备
+        m_replayDriver->start();
+    } else if (m_syntheticDriver) {
+        // 压测模式：合成数据直接注入解析入口，或经本机 WebSocket 回环
+        m_spoofDriver->startWork();
+        QString loopbackUrl = m_syntheticDriver->start();
+        if (!loopbackUrl.isEmpty()) m_detectionDriver->startWork(loopbackUrl);
+    } else {
+        m_spoofDriver->startWork();
+
+        // 连接所有侦测数据源
+        for (DetectionSource *source : std::as_const(m_detectionSources)) source->start();
+    }
 
     // 使用你提供的 IP 和 端口
     // 192.168.10.221 : 4196
     m_relayDriver->connectToDevice("192.168.10.221", 4196);
 
+    // 监视器须在本线程 (后端线程) 中创建
+    if (m_eventLoopReportSec > 0) {
+        m_eventLoopMonitor = new EventLoopMonitor("后端线程", this);
+        connect(m_eventLoopMonitor, &EventLoopMonitor::sigReport, this, &DeviceManager::onEventLoopReport);
+        m_eventLoopMonitor->start(m_eventLoopReportSec * 1000);
+        m_loadClock.start();
+        m_loadReportTimer->start(m_eventLoopReportSec * 1000);
+    }
+
     log("[DeviceManager] 就绪 (诱骗目标: 192.168.10.230)");
 }
 
-DeviceManager::~DeviceManager() {}
-
+// 各驱动的日志也经此输出：控制台 (qDebug，无界面程序由消息处理函数统一加时间戳) + 界面日志信号
 void DeviceManager::log(const QString &msg) {
-    qDebug() << msg;
+    qDebug().noquote() << msg;
     emit sigLogMessage(msg);
 }
 
@@ -84,49 +238,167 @@ void DeviceManager::log(const QString &msg) {
 // 2. 侦测数据处理
 // ============================================================================
 
-void DeviceManager::onDroneListUpdated(const QList<DroneInfo> &drones)
+DetectionSource *DeviceManager::createDetectionSource(const DetectionSource::Config &config,
+                                                      const DetectionSource::Settings &settings)
 {
-    emit sigDroneList(drones);
-    emit sigTargetsUpdated(drones);
+    switch (config.type) {
+    case DetectionSource::Type::SocketIo:
+        return new DetectionDriver(config, settings, this);
+    case DetectionSource::Type::LegacyTcp:
+        return new LegacyDetectionDriver(config, settings, this);
+    }
+    return nullptr;
+}
 
-    bool hasDroneThreat = false;
-    double minDistance = 999999.0;
+// 各数据源的一帧先经融合 (跨数据源关联/去重/位置合并)，再按单一数据流处理
+void DeviceManager::addDetectionSource(DetectionSource *source)
+{
+    int index = m_detectionSources.size();
+    m_detectionSources.append(source);
+    m_sourceDown.append(false);
+    m_sourceHasImages.append(false);
+
+    connect(source, &DetectionSource::sigDroneListUpdated, this,
+            [this, index](const QList<DroneInfo> &drones, const FrameTrace &trace) {
+        onDroneListUpdated(m_fusion.ingest(index, drones, m_trackClock.elapsed()), trace);
+    });
+    connect(source, &DetectionSource::sigImageListUpdated, this,
+            [this, index](const QList<ImageInfo> &images, const FrameTrace &trace) {
+        bool any = !images.isEmpty();
+        if (any != m_sourceHasImages.at(index)) {
+            m_sourceHasImages[index] = any;
+            m_imageSourceCount += any ? 1 : -1;
+        }
+        onImageListUpdated(images, trace);
+    });
+    connect(source, &DetectionSource::sigLinkStateChanged, this,
+            [this, index](bool online) { onDetectionLinkChanged(index, online); });
+    connect(source, &DetectionSource::sigLog, this, &DeviceManager::log);
+}
 
-    if (!drones.isEmpty()) {
-        for (const auto &d : drones) {
-            if (d.whiteList) continue;
-            hasDroneThreat = true;
+void DeviceManager::onDroneListUpdated(const QList<DroneInfo> &drones, const FrameTrace &trace)
+{
+    // 本帧处置期间驱动写出的指令都计入该帧的延迟
+    LatencyTracer::ActionScope latencyScope(m_latency, trace);
+    ++m_framesProcessed;
 
-            // 距离清洗逻辑
-            double realDist = d.distance;
-            if ((d.uav_lat == 0.0 && d.uav_lng == 0.0) || realDist <= 0.1) {
-                realDist = 999999.0;
-            }
+    // 断线恢复后的首帧：恢复正常超时，未再出现的旧目标随本帧移除
+    if (m_trackExpiryExtended && !m_detectionStale) setTrackExpiryExtended(false);
 
-            if (realDist < minDistance) {
-                minDistance = realDist;
-            }
-        }
-    }
+    // 合并进航迹库，只把变化部分推给界面
+    DroneTrackDiff diff;
+    qint64 now = m_trackClock.elapsed();
+    m_droneTracks.apply(drones, now, diff);
+    m_droneTracks.expire(now, diff);
+    if (!diff.isEmpty()) emit sigDroneTracks(diff);
 
-    bool finalThreat = hasDroneThreat || m_hasImageThreat;
-    double finalDistance = hasDroneThreat ? minDistance : 999999.0;
+    emit sigTargetsUpdated(drones);
 
-    processDecision(finalThreat, finalDistance);
+    // 只对变化的航迹重新评分
+    m_threats.apply(diff, m_droneTracks, now);
+    processDecision();
 }
 
-void DeviceManager::onImageListUpdated(const QList<ImageInfo> &images)
+void DeviceManager::onImageListUpdated(const QList<ImageInfo> &images, const FrameTrace &trace)
 {
-    emit sigImageList(images);
-    m_hasImageThreat = !images.isEmpty();
+    LatencyTracer::ActionScope latencyScope(m_latency, trace);
+    ++m_framesProcessed;
+
+    ImageTrackDiff diff;
+    qint64 now = m_trackClock.elapsed();
+    m_imageTracks.apply(images, now, diff);
+    m_imageTracks.expire(now, diff);
+    if (!diff.isEmpty()) emit sigImageTracks(diff);
+
+    // 任一数据源当前上报图传即视为有图传威胁 (各数据源状态在 addDetectionSource 中维护)
+    m_hasImageThreat = m_imageSourceCount > 0;
 
     if (m_hasImageThreat) {
-        processDecision(true, 999999.0);
+        // 图传只触发诱骗；压制仍按当前无人机评估结论，不因图传帧被关闭
+        processDecision();
     }
 }
 
 void DeviceManager::onAlertCountUpdated(int count) { emit sigAlertCount(count); }
 
+void DeviceManager::onTrackExpiryTimeout()
+{
+    qint64 now = m_trackClock.elapsed();
+    m_fusion.expire(now);
+
+    DroneTrackDiff droneDiff;
+    m_droneTracks.expire(now, droneDiff);
+    if (!droneDiff.isEmpty()) emit sigDroneTracks(droneDiff);
+    // 侦测断流时目标只会在这里超时消失 (须重新决策才能进入停止防抖)，
+    // 未再上报的运动目标也在这里继续外推
+    int coasted = m_threats.expire(droneDiff, now);
+    if (!droneDiff.isEmpty() || coasted > 0) processDecision();
+
+    ImageTrackDiff imageDiff;
+    m_imageTracks.expire(now, imageDiff);
+    if (!imageDiff.isEmpty()) emit sigImageTracks(imageDiff);
+}
+
+// ============================================================================
+// 侦测断线宽限期
+// 断线时不清空目标：延长航迹超时并通知界面标记为过时；链路恢复后的首帧
+// 恢复正常超时；宽限期内未恢复 (或恢复后始终无数据) 则按正常超时清除。
+// 宽限期只覆盖断线后的一段时间，某块板长期离线时其余数据源照常工作，
+// 离线的数据源单独通知界面显示
+// ============================================================================
+void DeviceManager::onDetectionLinkChanged(int source, bool online)
+{
+    if (m_sourceDown.at(source) == !online) return;
+    m_sourceDown[source] = !online;
+    m_sourcesDown += online ? -1 : 1;
+    emit sigDetectionSourcesDown(downSourceNames());
+
+    if (!online) {
+        // 任一数据源断开即 (重新) 开始宽限期 (其独占覆盖区的目标无法更新)
+        setTrackExpiryExtended(true);
+        m_staleGraceTimer->start();
+        setDetectionStale(true);
+    } else if (m_sourcesDown == 0) {
+        setDetectionStale(false);
+    }
+}
+
+void DeviceManager::onStaleGraceTimeout()
+{
+    if (m_detectionStale) {
+        log(QString("[侦测] 链路中断超过 %1 ms，清除最后已知目标").arg(m_staleGraceTimer->interval()));
+    }
+    setDetectionStale(false);
+    setTrackExpiryExtended(false);
+    onTrackExpiryTimeout();
+}
+
+void DeviceManager::setDetectionStale(bool stale)
+{
+    if (stale == m_detectionStale) return;
+    m_detectionStale = stale;
+    emit sigDetectionStale(m_detectionStale);
+}
+
+QStringList DeviceManager::downSourceNames() const
+{
+    QStringList names;
+    for (int i = 0; i < m_detectionSources.size(); ++i) {
+        if (!m_sourceDown.at(i)) continue;
+        QString name = m_detectionSources.at(i)->name();
+        names.append(name.isEmpty() ? QString("侦测%1").arg(i + 1) : name);
+    }
+    return names;
+}
+
+void DeviceManager::setTrackExpiryExtended(bool extended)
+{
+    m_trackExpiryExtended = extended;
+    qint64 expiry = extended ? qMax<qint64>(TRACK_EXPIRY_MS, m_staleGraceTimer->interval()) : TRACK_EXPIRY_MS;
+    m_droneTracks.setExpiry(expiry);
+    m_imageTracks.setExpiry(expiry);
+}
+
 // ============================================================================
 // 【关键修改 2】坐标更新函数
 // ============================================================================
@@ -141,6 +413,14 @@ void DeviceManager::onDevicePositionUpdated(double lat, double lng)
     m_baseLat = lat;
     m_baseLng = lng;
 
+    // 基站明显移动后才重建本地坐标系 (定位抖动不触发重建)
+    QPointF offset = m_geofence.projection().toLocal(lat, lng);
+    if (qHypot(offset.x(), offset.y()) > REORIGIN_DISTANCE_M) {
+        Geodesy::LocalProjection localFrame(lat, lng);
+        m_geofence.setProjection(localFrame);
+        m_threats.setProjection(localFrame);
+    }
+
     // 转发给 UI 显示
     emit sigSelfPosition(lat, lng);
 }
@@ -182,7 +462,7 @@ void DeviceManager::stopAllBusiness()
 void DeviceManager::onStopDefenseTimeout()
 {
     if (m_currentMode != SystemMode::Auto) return;
-    log("[自动决策] 信号丢失超过3秒 -> 停止防御");
+    log(QString("[自动决策] 信号丢失超过%1秒 -> 停止防御").arg(m_stopDefenseTimer->interval() / 1000.0));
     stopAllBusiness();
 }
 
@@ -190,14 +470,18 @@ void DeviceManager::onStopDefenseTimeout()
 // 4. 自动模式决策
 // ============================================================================
 
-void DeviceManager::processDecision(bool hasThreat, double distance)
+void DeviceManager::processDecision()
 {
     if (m_currentMode != SystemMode::Auto) return;
 
+    const ThreatEngine::Assessment threat = m_threats.assess(m_isRelaySuppressionRunning);
+
+    bool hasThreat = threat.spoof || threat.suppress || m_hasImageThreat;
+
     // 目标消失
     if (!hasThreat) {
         if ((m_isAutoSpoofingRunning || m_isRelaySuppressionRunning) && !m_stopDefenseTimer->isActive()) {
-            log("[自动决策] 目标消失 -> 启动3秒防抖延时...");
+            log(QString("[自动决策] 目标消失 -> 启动%1秒防抖延时...").arg(m_stopDefenseTimer->interval() / 1000.0));
             m_stopDefenseTimer->start();
         }
         return;
@@ -210,7 +494,13 @@ void DeviceManager::processDecision(bool hasThreat, double distance)
 
     // 触发诱骗
     if (!m_isAutoSpoofingRunning) {
-        log("[自动决策] 发现威胁 -> 启动诱骗(圆周)");
+        if (threat.threats > 0) {
+            log(QString("[自动决策] 发现威胁 (%1 个目标，首要: %2 %3 评分 %4) -> 启动诱骗(圆周)")
+                    .arg(threat.threats).arg(threat.top.model, threat.top.key)
+                    .arg(threat.top.score, 0, 'f', 2));
+        } else {
+            log("[自动决策] 发现图传威胁 -> 启动诱骗(圆周)");
+        }
 
         double targetLat = m_baseLat;
         double targetLng = m_baseLng;
@@ -231,15 +521,29 @@ void DeviceManager::processDecision(bool hasThreat, double distance)
     }
 
     // 触发压制
-    if (distance <= 1000.0) {
+    if (threat.suppress) {
         if (!m_isRelaySuppressionRunning) {
-            log(QString("[自动决策] 进入红区 (%1m) -> 开启压制").arg(distance));
+            if (threat.breaches > 0) {
+                log(QString("[自动决策] 围栏告警 (%1 预计 %2 s 进入 %3) -> 开启压制")
+                        .arg(threat.breach.key).arg(threat.breach.timeToBreachS, 0, 'f', 1).arg(threat.breach.zone));
+            } else {
+                log(QString("[自动决策] 进入红区 (最近 %1m，首要 %2 评分 %3) -> 开启压制")
+                        .arg(threat.nearestM, 0, 'f', 1).arg(threat.top.key).arg(threat.top.score, 0, 'f', 2));
+            }
             if (m_relayDriver) m_relayDriver->setAll(true);
             m_isRelaySuppressionRunning = true;
+            m_relayOnClock.start();
+
+            // 只报本帧内实际写出的样本；指令排队时由调度器稍后写出并计入统计
+            qint64 reactionNs = m_latency.activeSample(LatencyTracer::StageRelayTx);
+            if (reactionNs >= 0) {
+                log(QString("[自动决策] 侦测->压制指令 延迟: %1 ms").arg(reactionNs / 1e6, 0, 'f', 3));
+            }
         }
     }
     else {
-        if (m_isRelaySuppressionRunning) {
+        // 开启后至少保持 relayMinHoldMs，避免刚开就关
+        if (m_isRelaySuppressionRunning && m_relayOnClock.elapsed() >= m_threats.policy().relayMinHoldMs) {
             log("[自动决策] 离开红区 -> 停止压制");
             if (m_relayDriver) m_relayDriver->setAll(false);
             m_isRelaySuppressionRunning = false;
@@ -247,6 +551,55 @@ void DeviceManager::processDecision(bool hasThreat, double distance)
     }
 }
 
+// ============================================================================
+// 5. 延迟统计
+// ============================================================================
+void DeviceManager::reportLatency()
+{
+    // 没有新样本时不刷屏
+    quint64 samples = m_latency.totalSamples();
+    if (samples == m_latencyReportedSamples) return;
+    m_latencyReportedSamples = samples;
+
+    log("[延迟] 侦测->处置 各阶段统计:\n" + m_latency.report().trimmed());
+    if (!m_latencyReportFile.isEmpty() && !m_latency.dumpToFile(m_latencyReportFile)) {
+        log(QString("[延迟] 统计导出失败: %1").arg(m_latencyReportFile));
+    }
+}
+
+// 负载统计：每个周期输出 生成/处理 帧率与当前航迹数
+void DeviceManager::onLoadReportTimeout()
+{
+    double seconds = m_loadClock.restart() / 1000.0;
+    if (seconds <= 0) return;
+
+    double processed = (m_framesProcessed - m_lastFramesProcessed) / seconds;
+    m_lastFramesProcessed = m_framesProcessed;
+
+    QString msg = QString("[负载] 处理 %1 帧/s").arg(processed, 0, 'f', 1);
+    if (m_syntheticDriver) {
+        quint64 generated = m_syntheticDriver->framesGenerated();
+        msg += QString("  生成 %1 帧/s").arg((generated - m_lastFramesGenerated) / seconds, 0, 'f', 1);
+        m_lastFramesGenerated = generated;
+    }
+    msg += QString("  航迹: 无人机 %1  图传 %2").arg(m_droneTracks.size()).arg(m_imageTracks.size());
+    for (DetectionSource *source : std::as_const(m_detectionSources)) {
+        QString name = source->name().isEmpty() ? QString() : source->name() + " ";
+        QString payload = source->payloadReport();
+        if (!payload.isEmpty()) msg += "  载荷: " + name + payload;
+        QString link = source->linkReport();
+        if (!link.isEmpty()) msg += "  链路: " + name + link;
+    }
+    if (m_detectionSources.size() > 1) msg += QString("  融合目标 %1").arg(m_fusion.size());
+    log(msg);
+}
+
+void DeviceManager::onEventLoopReport(const QString &name, double utilization, double maxLagMs)
+{
+    log(QString("[负载] %1 利用率 %2%  最大事件延迟 %3 ms")
+            .arg(name).arg(utilization * 100.0, 0, 'f', 1).arg(maxLagMs, 0, 'f', 1));
+}
+
 // (手动模式代码)
 void DeviceManager::setManualSpoofSwitch(bool enable) { if(m_spoofDriver) m_spoofDriver->setSwitch(enable); }
 void DeviceManager::setManualCircular() { m_spoofDriver->setPosition(Config::BASE_LON, Config::BASE_LAT, 0); m_spoofDriver->setSwitch(true); m_spoofDriver->startCircular(100, 50); }
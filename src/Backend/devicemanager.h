@@ -4,12 +4,23 @@
 #include <QObject>
 #include <QDebug>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
 
 #include "DataStructs.h"
+#include "trackstore.h"
+#include "trackfusion.h"
+#include "threatengine.h"
+#include "latencytracer.h"
 #include "Drivers/spoofdriver.h"
 #include "Drivers/detectiondriver.h"
+#include "Drivers/legacydetectiondriver.h"
 #include "Drivers/jammerdriver.h"
 #include "Drivers/relaydriver.h"
+#include "Drivers/replaydriver.h"
+#include "Drivers/syntheticdriver.h"
+#include "../Utils/eventloopmonitor.h"
+#include "streamlog.h"
 
 enum class SystemMode {
     Manual,
@@ -23,6 +34,15 @@ public:
     explicit DeviceManager(QObject *parent = nullptr);
     ~DeviceManager();
 
+public slots:
+    // 发起所有设备连接 (须在 DeviceManager 所属线程中调用)
+    void start();
+
+    // 输出 侦测->处置 各阶段延迟统计 (日志 + 导出文件)
+    void reportLatency();
+
+public:
+
     void setSystemMode(SystemMode mode);
     void stopAllBusiness();
 
@@ -37,28 +57,76 @@ public:
 
 private slots:
     // 数据接收槽
-    void onDroneListUpdated(const QList<DroneInfo> &drones);
-    void onImageListUpdated(const QList<ImageInfo> &images); // 【新增】图传也能触发
+    void onDroneListUpdated(const QList<DroneInfo> &drones, const FrameTrace &trace);
+    void onImageListUpdated(const QList<ImageInfo> &images, const FrameTrace &trace); // 【新增】图传也能触发
     void onAlertCountUpdated(int count);
     void onDevicePositionUpdated(double lat, double lng);
     void onStopDefenseTimeout();
+    void onTrackExpiryTimeout();
+    void onDetectionLinkChanged(int source, bool online);
+    void onStaleGraceTimeout();
+    void onLoadReportTimeout();
+    void onEventLoopReport(const QString &name, double utilization, double maxLagMs);
 
 private:
-    // 核心决策函数
-    void processDecision(bool hasThreat, double minDistance);
+    // 核心决策函数：根据威胁评估结论 (及图传威胁) 启停诱骗/压制
+    void processDecision();
     void log(const QString &msg);
+    DetectionSource *createDetectionSource(const DetectionSource::Config &config,
+                                           const DetectionSource::Settings &settings);
+    void addDetectionSource(DetectionSource *source);
+    // 侦测断线期间延长航迹超时，使最后已知目标在宽限期内不被移除
+    void setTrackExpiryExtended(bool extended);
+    void setDetectionStale(bool stale);
+    QStringList downSourceNames() const;
 
     SpoofDriver *m_spoofDriver;
-    DetectionDriver *m_detectionDriver;
+    QList<DetectionSource *> m_detectionSources; // 按配置顺序，下标即融合中的数据源编号
+    DetectionDriver *m_detectionDriver = nullptr; // 回放/合成/录制使用的 Socket.IO 数据源
+    TrackFusion m_fusion;
+    QList<bool> m_sourceDown;       // 各数据源链路已断开
+    int m_sourcesDown = 0;
+    QList<bool> m_sourceHasImages;  // 各数据源最近一帧是否有图传
+    int m_imageSourceCount = 0;
     JammerDriver *m_jammerDriver;
     RelayDriver *m_relayDriver;
+    ReplayDriver *m_replayDriver = nullptr; // 回放模式下代替侦测 WebSocket
+    StreamRecorder *m_recorder = nullptr;   // 录制模式下记录原始数据流
+    QTimer *m_recordFlushTimer = nullptr;   // 定时把录制缓冲写盘
+    SyntheticDriver *m_syntheticDriver = nullptr; // 压测模式下代替侦测 WebSocket
+
+    // 负载统计 (处理帧率 / 后端线程利用率)
+    QTimer *m_loadReportTimer;
+    QElapsedTimer m_loadClock;
+    quint64 m_framesProcessed = 0;
+    quint64 m_lastFramesProcessed = 0;
+    quint64 m_lastFramesGenerated = 0;
+    int m_eventLoopReportSec = 0;
+    EventLoopMonitor *m_eventLoopMonitor = nullptr;
 
     SystemMode m_currentMode;
     QTimer *m_stopDefenseTimer;
 
-    // 状态标志位
+    // 目标航迹库 (超时 4 秒移除)，向界面只推送增量
+    TrackStore<DroneInfo> m_droneTracks;
+    TrackStore<ImageInfo> m_imageTracks;
+    QTimer *m_trackExpiryTimer;
+    QElapsedTimer m_trackClock;
+
+    // 侦测断线宽限期：期间保留最后已知目标并标记为过时
+    QTimer *m_staleGraceTimer;
+    bool m_detectionStale = false;
+    bool m_trackExpiryExtended = false;
+
+    // 威胁评估 (按航迹增量更新排序队列) 与电子围栏 (以基站为原点)
+    Geofence m_geofence;
+    ThreatEngine m_threats;
+
+    // 状态标志位：自动决策的处置意图 (期望状态)
+    // 设备实际状态由驱动根据回复/读回维护，并只下发与期望不一致的部分
     bool m_isAutoSpoofingRunning;
     bool m_isRelaySuppressionRunning;
+    QElapsedTimer m_relayOnClock; // 压制开启时刻 (最短保持时间)
 
     // 辅助：记录上一次是否有图传威胁（用于合并判断）
     bool m_hasImageThreat;
@@ -66,13 +134,21 @@ private:
     double m_baseLat = 0.0; // 动态获取的基站纬度
     double m_baseLng = 0.0; // 动态获取的基站经度
 
+    // 侦测 -> 处置 延迟统计
+    LatencyTracer m_latency;
+    QTimer *m_latencyReportTimer;
+    QString m_latencyReportFile;
+    quint64 m_latencyReportedSamples = 0;
+
 signals:
     void sigLogMessage(const QString &msg);
-    void sigDroneList(const QList<DroneInfo> &drones);
-    void sigImageList(const QList<ImageInfo> &images);
+    void sigDroneTracks(const DroneTrackDiff &diff);
+    void sigImageTracks(const ImageTrackDiff &diff);
     void sigAlertCount(int count);
     void sigSelfPosition(double lat, double lng);
     void sigTargetsUpdated(const QList<DroneInfo> &drones);
+    void sigDetectionStale(bool stale); // 侦测断线宽限期内，当前目标含最后已知状态
+    void sigDetectionSourcesDown(const QStringList &names); // 当前断开的侦测数据源 (空 = 全部在线)
 };
 
 #endif // DEVICEMANAGER_H
@@ -0,0 +1,256 @@
+#include "geofence.h"
+#include <QtMath>
+#include <limits>
+
+namespace {
+const int MAX_GRID_CELLS = 1 << 18;  // 区域分布过散时放大格子，限制索引内存
+const double MIN_MOVING_SPEED = 0.5; // 米/秒，低于此速度只做点查询
+
+double cross(const QPointF &a, const QPointF &b) { return a.x() * b.y() - a.y() * b.x(); }
+}
+
+void Geofence::setZones(const QList<Zone> &zones, double cellSizeM)
+{
+    m_zones.clear();
+    for (const Zone &z : zones) {
+        if (z.points.size() >= 3) m_zones.append(z); // 少于 3 个点的区域无意义
+    }
+    m_cellSize = cellSizeM > 0 ? cellSizeM : 250.0;
+    if (hasOrigin()) rebuild();
+}
+
+void Geofence::setProjection(const Geodesy::LocalProjection &projection)
+{
+    m_projection = projection;
+    rebuild();
+}
+
+Geofence::ZoneType Geofence::typeFromString(const QString &name)
+{
+    QString n = name.trimmed().toLower();
+    if (n == "protected") return ZoneType::Protected;
+    if (n == "exclusion") return ZoneType::Exclusion;
+    return ZoneType::NoFly;
+}
+
+// ============================================================================
+// 索引构建：区域转本地坐标，按外包矩形登记到格子 (两遍：计数 + 填充)
+// ============================================================================
+void Geofence::rebuild()
+{
+    m_local.clear();
+    m_cellStart.clear();
+    m_cellZones.clear();
+    m_cols = m_rows = 0;
+    m_seen.fill(0, m_zones.size());
+    if (m_zones.isEmpty()) return;
+
+    for (const Zone &z : std::as_const(m_zones)) {
+        LocalZone local;
+        double minX = std::numeric_limits<double>::max(), minY = minX;
+        double maxX = std::numeric_limits<double>::lowest(), maxY = maxX;
+        for (const QPointF &ll : z.points) {
+            QPointF p = m_projection.toLocal(ll.y(), ll.x());
+            local.points.append(p);
+            minX = qMin(minX, p.x()); maxX = qMax(maxX, p.x());
+            minY = qMin(minY, p.y()); maxY = qMax(maxY, p.y());
+        }
+        local.bounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+        m_gridBounds = m_local.isEmpty() ? local.bounds : m_gridBounds.united(local.bounds);
+        m_local.append(local);
+    }
+
+    double cell = m_cellSize;
+    auto cellsFor = [this](double size) {
+        return qMax(1, int(qCeil(m_gridBounds.width() / size))) * qMax(1, int(qCeil(m_gridBounds.height() / size)));
+    };
+    while (cellsFor(cell) > MAX_GRID_CELLS) cell *= 2;
+    m_cellSize = cell;
+    m_cols = qMax(1, int(qCeil(m_gridBounds.width() / cell)));
+    m_rows = qMax(1, int(qCeil(m_gridBounds.height() / cell)));
+
+    auto forEachCell = [this](const QRectF &r, auto fn) {
+        int c0 = qBound(0, int((r.left() - m_gridBounds.left()) / m_cellSize), m_cols - 1);
+        int c1 = qBound(0, int((r.right() - m_gridBounds.left()) / m_cellSize), m_cols - 1);
+        int r0 = qBound(0, int((r.top() - m_gridBounds.top()) / m_cellSize), m_rows - 1);
+        int r1 = qBound(0, int((r.bottom() - m_gridBounds.top()) / m_cellSize), m_rows - 1);
+        for (int row = r0; row <= r1; ++row) {
+            for (int col = c0; col <= c1; ++col) fn(row * m_cols + col);
+        }
+    };
+
+    m_cellStart.fill(0, m_cols * m_rows + 1);
+    for (const LocalZone &z : std::as_const(m_local)) {
+        forEachCell(z.bounds, [this](int cellIdx) { ++m_cellStart[cellIdx + 1]; });
+    }
+    for (int i = 1; i < m_cellStart.size(); ++i) m_cellStart[i] += m_cellStart[i - 1];
+
+    m_cellZones.resize(m_cellStart.last());
+    QList<int> fill = m_cellStart;
+    for (int zi = 0; zi < m_local.size(); ++zi) {
+        forEachCell(m_local.at(zi).bounds, [&](int cellIdx) { m_cellZones[fill[cellIdx]++] = zi; });
+    }
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+bool Geofence::cellIndex(const QPointF &p, int &col, int &row) const
+{
+    if (m_cols == 0) return false;
+    double x = p.x() - m_gridBounds.left();
+    double y = p.y() - m_gridBounds.top();
+    if (x < 0 || y < 0 || x > m_gridBounds.width() || y > m_gridBounds.height()) return false;
+    col = qMin(int(x / m_cellSize), m_cols - 1);
+    row = qMin(int(y / m_cellSize), m_rows - 1);
+    return true;
+}
+
+void Geofence::collectCell(int col, int row, QList<int> &out) const
+{
+    int cellIdx = row * m_cols + col;
+    for (int i = m_cellStart.at(cellIdx); i < m_cellStart.at(cellIdx + 1); ++i) {
+        int zi = m_cellZones.at(i);
+        if (m_seen.at(zi) == m_seenStamp) continue;
+        m_seen[zi] = m_seenStamp;
+        out.append(zi);
+    }
+}
+
+// 线段先裁剪到网格范围 (Liang-Barsky)，再按格子逐个步进 (Amanatides-Woo)
+void Geofence::collectSegment(const QPointF &a, const QPointF &b, QList<int> &out) const
+{
+    if (m_cols == 0) return;
+
+    double dx = b.x() - a.x(), dy = b.y() - a.y();
+    double t0 = 0.0, t1 = 1.0;
+    auto clip = [&](double p, double q) {
+        if (p == 0) return q >= 0;
+        double r = q / p;
+        if (p < 0) {
+            if (r > t1) return false;
+            t0 = qMax(t0, r);
+        } else {
+            if (r < t0) return false;
+            t1 = qMin(t1, r);
+        }
+        return true;
+    };
+    if (!clip(-dx, a.x() - m_gridBounds.left()) || !clip(dx, m_gridBounds.right() - a.x())
+        || !clip(-dy, a.y() - m_gridBounds.top()) || !clip(dy, m_gridBounds.bottom() - a.y())) {
+        return;
+    }
+
+    QPointF s(a.x() + dx * t0, a.y() + dy * t0);
+    QPointF e(a.x() + dx * t1, a.y() + dy * t1);
+    auto colOf = [this](double x) { return qBound(0, int((x - m_gridBounds.left()) / m_cellSize), m_cols - 1); };
+    auto rowOf = [this](double y) { return qBound(0, int((y - m_gridBounds.top()) / m_cellSize), m_rows - 1); };
+
+    int col = colOf(s.x()), row = rowOf(s.y());
+    int endCol = colOf(e.x()), endRow = rowOf(e.y());
+    double sx = e.x() - s.x(), sy = e.y() - s.y();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    int stepX = sx > 0 ? 1 : -1;
+    int stepY = sy > 0 ? 1 : -1;
+    double tDeltaX = sx != 0 ? m_cellSize / qAbs(sx) : inf;
+    double tDeltaY = sy != 0 ? m_cellSize / qAbs(sy) : inf;
+    double tMaxX = sx != 0 ? (m_gridBounds.left() + (col + (sx > 0 ? 1 : 0)) * m_cellSize - s.x()) / sx : inf;
+    double tMaxY = sy != 0 ? (m_gridBounds.top() + (row + (sy > 0 ? 1 : 0)) * m_cellSize - s.y()) / sy : inf;
+
+    for (int guard = m_cols + m_rows + 2; guard > 0; --guard) {
+        collectCell(col, row, out);
+        if (col == endCol && row == endRow) break;
+        if (tMaxX < tMaxY) {
+            col += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            row += stepY;
+            tMaxY += tDeltaY;
+        }
+        if (col < 0 || col >= m_cols || row < 0 || row >= m_rows) break;
+    }
+}
+
+Geofence::Hit Geofence::evaluate(const QPointF &pos, const QPointF &velocity, double horizonS) const
+{
+    Hit hit;
+    if (m_cols == 0) return hit;
+
+    if (++m_seenStamp == 0) { // 计数回绕
+        m_seen.fill(0);
+        m_seenStamp = 1;
+    }
+
+    QList<int> candidates;
+    int col, row;
+    if (cellIndex(pos, col, row)) collectCell(col, row, candidates);
+
+    bool moving = horizonS > 0
+        && velocity.x() * velocity.x() + velocity.y() * velocity.y() >= MIN_MOVING_SPEED * MIN_MOVING_SPEED;
+    QPointF end = pos + velocity * horizonS;
+    if (moving) collectSegment(pos, end, candidates);
+
+    double best = std::numeric_limits<double>::infinity();
+    for (int zi : std::as_const(candidates)) {
+        const Zone &z = m_zones.at(zi);
+        const LocalZone &local = m_local.at(zi);
+        bool inside = local.bounds.contains(pos) && contains(local.points, pos);
+
+        if (z.type == ZoneType::Exclusion) {
+            if (inside && hit.exclusionZone < 0) hit.exclusionZone = zi;
+            continue;
+        }
+
+        double t;
+        if (inside) {
+            t = 0.0;
+        } else if (moving) {
+            double u = firstCrossing(local.points, pos, end);
+            if (u < 0) continue;
+            t = u * horizonS;
+        } else {
+            continue;
+        }
+
+        if (t <= z.warnSec && t < best) {
+            best = t;
+            hit.alertZone = zi;
+            hit.timeToBreachS = t;
+        }
+    }
+    return hit;
+}
+
+// 射线法 (奇偶规则)
+bool Geofence::contains(const QList<QPointF> &poly, const QPointF &p)
+{
+    bool inside = false;
+    for (int i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        const QPointF &a = poly.at(i);
+        const QPointF &b = poly.at(j);
+        if ((a.y() > p.y()) != (b.y() > p.y())
+            && p.x() < (b.x() - a.x()) * (p.y() - a.y()) / (b.y() - a.y()) + a.x()) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// 线段 a->b 与多边形边界的第一个交点参数 (0~1)，不相交返回 -1
+double Geofence::firstCrossing(const QList<QPointF> &poly, const QPointF &a, const QPointF &b)
+{
+    QPointF r = b - a;
+    double best = -1.0;
+    for (int i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        QPointF q = poly.at(j);
+        QPointF s = poly.at(i) - q;
+        double denom = cross(r, s);
+        if (qFuzzyIsNull(denom)) continue; // 平行
+        QPointF qa = q - a;
+        double u = cross(qa, s) / denom;
+        double v = cross(qa, r) / denom;
+        if (u >= 0 && u <= 1 && v >= 0 && v <= 1 && (best < 0 || u < best)) best = u;
+    }
+    return best;
+}
@@ -0,0 +1,89 @@
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include "../Utils/geodesy.h"
+
+// ============================================================================
+// 电子围栏 / 保护区索引
+//
+// 区域以经纬度多边形配置，按基站为原点转换到本地 ENU 平面 (东, 北，单位米)，
+// 再按区域外包矩形登记到均匀网格。查询时只取目标所在格子 (或速度矢量
+// 扫过的格子) 登记的区域做多边形判断，开销与区域总数无关。
+// ============================================================================
+class Geofence
+{
+public:
+    enum class ZoneType {
+        NoFly,      // 禁飞区：目标进入 (或预计在 warnSec 内进入) 即告警
+        Protected,  // 保护目标：同上，通常配置较长的预警时间
+        Exclusion   // 排除区：目标位于其中时不对其压制 (如跑道方向)
+    };
+
+    struct Zone {
+        QString name;
+        ZoneType type = ZoneType::NoFly;
+        QList<QPointF> points; // x = 经度, y = 纬度
+        double warnSec = 0.0;  // 预计进入时间不超过此值即告警 (0 = 仅在区内告警)
+    };
+
+    // 单个目标的查询结果
+    struct Hit {
+        int alertZone = -1;        // 触发告警的区域 (最早进入的那个)，没有为 -1
+        double timeToBreachS = 0.0; // 预计进入 alertZone 的时间 (已在区内为 0)
+        int exclusionZone = -1;    // 目标所在排除区，没有为 -1
+    };
+
+    Geofence() = default;
+
+    void setZones(const QList<Zone> &zones, double cellSizeM = 250.0);
+    // 设置本地坐标系 (与 ThreatEngine 共用同一原点)，重建本地多边形与网格
+    void setProjection(const Geodesy::LocalProjection &projection);
+    const Geodesy::LocalProjection &projection() const { return m_projection; }
+
+    bool isEmpty() const { return m_zones.isEmpty(); }
+    bool hasOrigin() const { return m_projection.isValid(); }
+    int zoneCount() const { return m_zones.size(); }
+    const Zone &zone(int index) const { return m_zones.at(index); }
+
+    // pos / velocity 为本地坐标 (米, 米/秒)，只预测 horizonS 秒内的进入
+    Hit evaluate(const QPointF &pos, const QPointF &velocity, double horizonS) const;
+
+    static ZoneType typeFromString(const QString &name);
+
+private:
+    struct LocalZone {
+        QList<QPointF> points; // 本地坐标
+        QRectF bounds;
+    };
+
+    void rebuild();
+    bool cellIndex(const QPointF &p, int &col, int &row) const;
+    void collectCell(int col, int row, QList<int> &out) const;
+    void collectSegment(const QPointF &a, const QPointF &b, QList<int> &out) const;
+
+    static bool contains(const QList<QPointF> &poly, const QPointF &p);
+    static double firstCrossing(const QList<QPointF> &poly, const QPointF &a, const QPointF &b);
+
+    QList<Zone> m_zones;
+    QList<LocalZone> m_local;
+
+    Geodesy::LocalProjection m_projection;
+
+    // 均匀网格 (CSR 存储：格子 i 的区域为 m_cellZones[m_cellStart[i] .. m_cellStart[i+1]))
+    double m_cellSize = 250.0;
+    QRectF m_gridBounds;
+    int m_cols = 0;
+    int m_rows = 0;
+    QList<int> m_cellStart;
+    QList<int> m_cellZones;
+
+    // 查询去重 (同一区域可能登记在多个格子)
+    mutable QList<quint32> m_seen;
+    mutable quint32 m_seenStamp = 0;
+};
+
+#endif // GEOFENCE_H
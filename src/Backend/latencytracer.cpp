@@ -0,0 +1,167 @@
+#include "latencytracer.h"
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+qint64 LatencyClock::nowNs()
+{
+    // 函数内静态对象的初始化是线程安全的；QElapsedTimer 使用单调时钟
+    static const QElapsedTimer clock = []() { QElapsedTimer t; t.start(); return t; }();
+    return clock.nsecsElapsed();
+}
+
+// ============================================================================
+// 直方图
+// ============================================================================
+int LatencyHistogram::bucketOf(quint64 ns)
+{
+    if (ns < quint64(SUB_BUCKETS)) return int(ns);
+    int exp = 63 - qCountLeadingZeroBits(ns);               // 最高位位置 (>= SUB_BITS)
+    int sub = int((ns >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+qint64 LatencyHistogram::upperBoundOf(int bucket)
+{
+    if (bucket < SUB_BUCKETS) return bucket;
+    int exp = bucket / SUB_BUCKETS + SUB_BITS - 1;
+    int sub = bucket % SUB_BUCKETS;
+    return (qint64(SUB_BUCKETS + sub + 1) << (exp - SUB_BITS)) - 1;
+}
+
+void LatencyHistogram::record(qint64 ns)
+{
+    if (ns < 0) ns = 0;
+    ++m_buckets[bucketOf(quint64(ns))];
+    ++m_count;
+    if (ns > m_max) m_max = ns;
+}
+
+void LatencyHistogram::clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    if (m_count == 0) return 0;
+    quint64 rank = quint64(p / 100.0 * double(m_count) + 0.5);
+    if (rank < 1) rank = 1;
+
+    quint64 seen = 0;
+    for (int i = 0; i < int(m_buckets.size()); ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) return qMin(upperBoundOf(i), m_max);
+    }
+    return m_max;
+}
+
+// ============================================================================
+// 追踪器
+// ============================================================================
+LatencyTracer::ActionScope::ActionScope(LatencyTracer &tracer, const FrameTrace &trace)
+    : m_tracer(tracer), m_beginNs(LatencyClock::nowNs())
+{
+    if (trace.isValid()) {
+        m_tracer.record(StageParse, trace.parsedNs - trace.ingestNs);
+        m_tracer.record(StageDispatch, m_beginNs - trace.parsedNs);
+    }
+    m_tracer.m_active = trace;
+    m_tracer.m_activeSample.fill(-1);
+}
+
+LatencyTracer::ActionScope::~ActionScope()
+{
+    if (m_tracer.m_active.isValid()) {
+        m_tracer.record(StageDecision, LatencyClock::nowNs() - m_beginNs);
+    }
+    m_tracer.m_active = FrameTrace();
+    m_tracer.m_activeSample.fill(-1);
+}
+
+void LatencyTracer::record(Stage stage, qint64 ns)
+{
+    QMutexLocker locker(&m_mutex);
+    m_hist[stage].record(ns);
+    m_last[stage] = ns;
+}
+
+qint64 LatencyTracer::markTransmit(Stage stage, const FrameTrace &trace)
+{
+    if (!trace.isValid()) return -1;
+
+    // 序号按数据源各自计数，连同到达时刻一起区分帧
+    Stamp &last = m_stamped[stage];
+    if (last.seq == trace.seq && last.ingestNs == trace.ingestNs) return -1;
+    last.seq = trace.seq;
+    last.ingestNs = trace.ingestNs;
+
+    qint64 ns = LatencyClock::nowNs() - trace.ingestNs;
+    record(stage, ns);
+    if (trace.seq == m_active.seq && trace.ingestNs == m_active.ingestNs) m_activeSample[stage] = ns;
+    return ns;
+}
+
+qint64 LatencyTracer::lastSample(Stage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_last[stage];
+}
+
+quint64 LatencyTracer::totalSamples() const
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 total = 0;
+    for (const LatencyHistogram &h : m_hist) total += h.count();
+    return total;
+}
+
+void LatencyTracer::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (LatencyHistogram &h : m_hist) h.clear();
+    m_last.fill(-1);
+}
+
+QString LatencyTracer::stageName(Stage stage)
+{
+    switch (stage) {
+    case StageParse:    return "接收->解析";
+    case StageDispatch: return "解析->决策";
+    case StageDecision: return "决策耗时";
+    case StageRelayTx:  return "接收->压制写出";
+    case StageSpoofTx:  return "接收->诱骗写出";
+    default:            return "未知";
+    }
+}
+
+QString LatencyTracer::report() const
+{
+    QMutexLocker locker(&m_mutex);
+    QString text;
+    for (int i = 0; i < StageCount; ++i) {
+        const LatencyHistogram &h = m_hist[i];
+        text += QString("%1  次数 %2  p50 %3 ms  p99 %4 ms  max %5 ms\n")
+                    .arg(stageName(Stage(i)), -16)
+                    .arg(h.count(), 8)
+                    .arg(h.percentile(50) / 1e6, 9, 'f', 3)
+                    .arg(h.percentile(99) / 1e6, 9, 'f', 3)
+                    .arg(h.max() / 1e6, 9, 'f', 3);
+    }
+    return text;
+}
+
+bool LatencyTracer::dumpToFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    QString text = QString("# DroneShield 侦测->处置 延迟统计  %1\n")
+                       .arg(QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    text += report();
+    file.write(text.toUtf8());
+    return file.commit();
+}
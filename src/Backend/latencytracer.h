@@ -0,0 +1,121 @@
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QMetaType>
+#include <QMutex>
+#include <QString>
+#include <array>
+
+// ============================================================================
+// 侦测 -> 处置 全链路延迟追踪
+//
+// DetectionDriver 在帧到达、解析完成时打时间戳 (FrameTrace)，随信号一起传到
+// DeviceManager；决策期间 DeviceManager 把该帧设为"当前处置帧"，
+// 驱动真正写出字节时 (RelayDriver/SpoofDriver::transmit) 打发送时间戳。
+// 各阶段耗时计入对数分桶直方图，可随时读取 p50/p99/max 并导出到文件。
+// ============================================================================
+
+// 单调时钟 (纳秒)，进程内所有线程共用同一起点
+namespace LatencyClock {
+qint64 nowNs();
+}
+
+// 随侦测帧传递的时间戳
+struct FrameTrace {
+    quint64 seq = 0;       // 帧序号
+    qint64 ingestNs = 0;   // 帧到达 DetectionDriver
+    qint64 parsedNs = 0;   // 解析完成、信号发出前
+
+    bool isValid() const { return ingestNs > 0; }
+};
+Q_DECLARE_METATYPE(FrameTrace)
+
+// 对数分桶直方图：每个 2 的幂区间再均分 8 档，相对误差 < 12.5%，记录为 O(1)
+class LatencyHistogram
+{
+public:
+    void record(qint64 ns);
+    void clear();
+
+    quint64 count() const { return m_count; }
+    qint64 max() const { return m_max; }
+    qint64 percentile(double p) const; // 返回所在档的上界 (ns)
+
+private:
+    static const int SUB_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static int bucketOf(quint64 ns);
+    static qint64 upperBoundOf(int bucket);
+
+    std::array<quint64, 64 * SUB_BUCKETS> m_buckets{};
+    quint64 m_count = 0;
+    qint64 m_max = 0;
+};
+
+class LatencyTracer
+{
+public:
+    enum Stage {
+        StageParse,     // 帧到达 -> 解析完成
+        StageDispatch,  // 解析完成 -> 进入决策 (信号排队)
+        StageDecision,  // 决策本身耗时
+        StageRelayTx,   // 帧到达 -> 压制指令写出
+        StageSpoofTx,   // 帧到达 -> 诱骗指令写出
+        StageCount
+    };
+
+    // 决策作用域：构造时把该帧设为当前处置帧，析构时记录决策耗时并清除
+    class ActionScope
+    {
+    public:
+        ActionScope(LatencyTracer &tracer, const FrameTrace &trace);
+        ~ActionScope();
+    private:
+        Q_DISABLE_COPY(ActionScope)
+        LatencyTracer &m_tracer;
+        qint64 m_beginNs;
+    };
+
+    LatencyTracer() = default;
+
+    void record(Stage stage, qint64 ns);
+
+    // 由驱动在字节写出后调用，记录 "帧到达 -> 写出"：trace 为提交该指令的帧
+    // (指令经调度器排队、稍后由定时器写出时作用域已结束，须由指令自带)；
+    // 同一帧同一阶段只记第一次 (首个字节写出的时刻)，返回记录的延迟，未记录返回 -1
+    qint64 markTransmit(Stage stage, const FrameTrace &trace);
+    qint64 markTransmit(Stage stage) { return markTransmit(stage, m_active); }
+
+    // 当前处置帧 (决策作用域外无效)，驱动提交指令时随指令保存
+    const FrameTrace &activeTrace() const { return m_active; }
+    // 当前处置帧在本作用域内已写出的样本；指令仍在排队 (限速/等待确认) 时返回 -1
+    qint64 activeSample(Stage stage) const { return m_activeSample[stage]; }
+
+    // 最近一次记录的样本 (ns)，没有时返回 -1
+    qint64 lastSample(Stage stage) const;
+
+    quint64 totalSamples() const;
+    QString report() const;                    // 多行文本：各阶段 次数/p50/p99/max
+    bool dumpToFile(const QString &path) const; // 覆盖写入统计报告
+    void reset();
+
+    static QString stageName(Stage stage);
+
+private:
+    Q_DISABLE_COPY(LatencyTracer)
+
+    mutable QMutex m_mutex; // 后端线程记录，界面线程可能读取
+    std::array<LatencyHistogram, StageCount> m_hist;
+    std::array<qint64, StageCount> m_last{-1, -1, -1, -1, -1};
+
+    // 当前处置帧与各发送阶段最近记录的帧 (只在后端线程访问)
+    struct Stamp {
+        quint64 seq = 0;
+        qint64 ingestNs = 0;
+    };
+    FrameTrace m_active;
+    std::array<qint64, StageCount> m_activeSample{-1, -1, -1, -1, -1};
+    std::array<Stamp, StageCount> m_stamped{};
+};
+
+#endif // LATENCYTRACER_H
@@ -0,0 +1,161 @@
+#include "streamlog.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+const char STREAM_MAGIC[8] = {'D', 'S', 'R', 'E', 'C', '0', '0', '1'};
+const quint32 STREAM_VERSION = 1;
+const int HEADER_SIZE = 24;
+const int RECORD_HEADER_SIZE = 14;
+
+const int FLUSH_BYTES = 64 * 1024; // 缓冲超过 64KB 写盘
+const qint64 FLUSH_INTERVAL_NS = StreamRecorder::FLUSH_INTERVAL_MS * 1000000LL; // 或距上次写盘超过此间隔
+}
+
+QString StreamLog::channelName(quint8 channel)
+{
+    switch (channel) {
+    case DetectionText:   return "侦测帧";
+    case DetectionBinary: return "侦测附件";
+    case SpoofRx:         return "诱骗上报";
+    case SpoofTx:         return "诱骗指令";
+    case RelayRx:         return "继电器回复";
+    case RelayTx:         return "继电器指令";
+    default:              return QString("未知(%1)").arg(channel);
+    }
+}
+
+// ============================================================================
+// 录制
+// ============================================================================
+StreamRecorder::~StreamRecorder()
+{
+    close();
+}
+
+bool StreamRecorder::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    uchar header[HEADER_SIZE];
+    std::memset(header, 0, HEADER_SIZE);
+    std::memcpy(header, STREAM_MAGIC, sizeof(STREAM_MAGIC));
+    qToLittleEndian<quint32>(STREAM_VERSION, header + 8);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 16);
+    m_file.write(reinterpret_cast<const char *>(header), HEADER_SIZE);
+
+    m_buffer.reserve(FLUSH_BYTES + 4096);
+    m_clock.start();
+    m_lastFlushNs = 0;
+    m_records = 0;
+    m_bytes = HEADER_SIZE;
+    return true;
+}
+
+void StreamRecorder::close()
+{
+    if (!m_file.isOpen()) return;
+    flush();
+    m_file.close();
+}
+
+void StreamRecorder::record(StreamLog::Channel channel, QByteArrayView payload)
+{
+    if (!m_file.isOpen()) return;
+
+    qint64 now = m_clock.nsecsElapsed();
+    uchar head[RECORD_HEADER_SIZE];
+    qToLittleEndian<quint64>(quint64(now), head);
+    head[8] = channel;
+    head[9] = 0;
+    qToLittleEndian<quint32>(quint32(payload.size()), head + 10);
+
+    m_buffer.append(reinterpret_cast<const char *>(head), RECORD_HEADER_SIZE);
+    m_buffer.append(payload.data(), payload.size());
+    ++m_records;
+
+    if (m_buffer.size() >= FLUSH_BYTES || now - m_lastFlushNs >= FLUSH_INTERVAL_NS) {
+        flush();
+    }
+}
+
+void StreamRecorder::recordText(StreamLog::Channel channel, const QString &text)
+{
+    record(channel, QByteArrayView(reinterpret_cast<const char *>(text.utf16()),
+                                   text.size() * qsizetype(sizeof(char16_t))));
+}
+
+// 持有者按 FLUSH_INTERVAL_MS 定时调用：数据流中断时 (断线、崩溃前) 缓冲也能落盘
+void StreamRecorder::flush()
+{
+    m_lastFlushNs = m_clock.nsecsElapsed();
+    if (m_buffer.isEmpty()) return;
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_bytes += quint64(m_buffer.size());
+    m_buffer.resize(0); // 保留容量，下一轮不再分配
+}
+
+// ============================================================================
+// 读取
+// ============================================================================
+StreamReader::~StreamReader()
+{
+    close();
+}
+
+bool StreamReader::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    m_size = m_file.size();
+    uchar *base = m_size >= HEADER_SIZE ? m_file.map(0, m_size) : nullptr;
+    if (!base || std::memcmp(base, STREAM_MAGIC, sizeof(STREAM_MAGIC)) != 0
+        || qFromLittleEndian<quint32>(base + 8) != STREAM_VERSION) {
+        qWarning() << "[StreamLog] 无效的录制文件:" << path;
+        close();
+        return false;
+    }
+
+    m_base = base;
+    m_startUtcMs = qFromLittleEndian<qint64>(base + 16);
+    m_pos = HEADER_SIZE;
+    return true;
+}
+
+void StreamReader::close()
+{
+    if (m_base) m_file.unmap(const_cast<uchar *>(m_base));
+    m_file.close();
+    m_base = nullptr;
+    m_size = 0;
+    m_pos = 0;
+}
+
+bool StreamReader::next(StreamLog::Record &record)
+{
+    if (!m_base || m_pos + RECORD_HEADER_SIZE > m_size) return false;
+
+    const uchar *p = m_base + m_pos;
+    quint32 length = qFromLittleEndian<quint32>(p + 10);
+    if (m_pos + RECORD_HEADER_SIZE + qint64(length) > m_size) return false; // 录制中途退出导致的截断
+
+    record.tNs = qint64(qFromLittleEndian<quint64>(p));
+    record.channel = p[8];
+    record.payload = QByteArrayView(p + RECORD_HEADER_SIZE, qsizetype(length));
+    m_pos += RECORD_HEADER_SIZE + length;
+    return true;
+}
+
+void StreamReader::rewind()
+{
+    m_pos = HEADER_SIZE;
+}
@@ -0,0 +1,100 @@
+#ifndef STREAMLOG_H
+#define STREAMLOG_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QElapsedTimer>
+
+// ============================================================================
+// 原始数据流录制文件 (*.dsrec)
+//
+// 文件布局 (小端):
+//   [Header 24B] magic "DSREC001" | version u32 | reserved u32 | 录制开始时间 (UTC ms) i64
+//   [Record]     tNs u64 (相对录制开始，单调时钟) | channel u8 | reserved u8 | length u32 | payload
+//
+// 侦测文本帧按 UTF-16 原样写入 (QString 内部格式，录制时只有一次 memcpy)，
+// 回放时直接还原成 QString，不做编码转换；二进制事件的附件 (UTF-8 / 压缩 JSON)
+// 按收到顺序另记一条，回放时重新拼装
+// ============================================================================
+namespace StreamLog {
+
+enum Channel : quint8 {
+    DetectionText = 1,  // 侦测 Socket.IO 文本帧 (UTF-16)
+    SpoofRx = 2,        // 诱骗设备上报的 UDP 数据报
+    SpoofTx = 3,        // 发往诱骗设备的 UDP 数据报
+    RelayRx = 4,        // 继电器回复
+    RelayTx = 5,        // 发往继电器的指令
+    DetectionBinary = 6 // 侦测二进制附件 (跟在对应的 45x- 文本帧之后)
+};
+
+struct Record {
+    qint64 tNs = 0;
+    quint8 channel = 0;
+    QByteArrayView payload; // 指向 Reader 的映射内存，Reader 关闭前有效
+};
+
+QString channelName(quint8 channel);
+
+} // namespace StreamLog
+
+// 录制：数据先攒在内存缓冲，超过阈值或间隔一段时间才写盘，热路径上不做系统调用。
+// record() 只在有新数据时检查间隔，持有者须每 FLUSH_INTERVAL_MS 调用一次 flush()
+class StreamRecorder
+{
+public:
+    static constexpr int FLUSH_INTERVAL_MS = 500;
+
+    StreamRecorder() = default;
+    ~StreamRecorder();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString path() const { return m_file.fileName(); }
+
+    void record(StreamLog::Channel channel, QByteArrayView payload);
+    void recordText(StreamLog::Channel channel, const QString &text);
+    void flush();
+
+    quint64 recordCount() const { return m_records; }
+    quint64 bytesWritten() const { return m_bytes; }
+
+private:
+    Q_DISABLE_COPY(StreamRecorder)
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_clock;
+    qint64 m_lastFlushNs = 0;
+    quint64 m_records = 0;
+    quint64 m_bytes = 0;
+};
+
+// 读取：整个文件映射到内存，顺序遍历
+class StreamReader
+{
+public:
+    StreamReader() = default;
+    ~StreamReader();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+
+    qint64 startTimeUtcMs() const { return m_startUtcMs; }
+    bool next(StreamLog::Record &record); // 到达末尾或遇到截断记录时返回 false
+    void rewind();
+
+private:
+    Q_DISABLE_COPY(StreamReader)
+
+    QFile m_file;
+    const uchar *m_base = nullptr;
+    qint64 m_size = 0;
+    qint64 m_pos = 0;
+    qint64 m_startUtcMs = 0;
+};
+
+#endif // STREAMLOG_H
@@ -0,0 +1,334 @@
+#include "threatengine.h"
+#include <QtGlobal>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double INVALID_DISTANCE = std::numeric_limits<double>::infinity();
+const double NO_MEASUREMENT = std::numeric_limits<double>::quiet_NaN();
+
+double clamp01(double v) { return qBound(0.0, v, 1.0); }
+
+bool hasPosition(const DroneInfo &d) { return !(d.uav_lat == 0.0 && d.uav_lng == 0.0); }
+}
+
+double ThreatPolicy::modelWeight(const QString &modelName) const
+{
+    for (const auto &rule : modelWeights) {
+        if (modelName.contains(rule.first, Qt::CaseInsensitive)) return rule.second;
+    }
+    return defaultModelWeight;
+}
+
+ThreatEngine::ThreatEngine(const ThreatPolicy &policy) : m_policy(policy)
+{
+}
+
+void ThreatEngine::setPolicy(const ThreatPolicy &policy)
+{
+    m_policy = policy;
+    m_modelCache.clear();
+    m_filter.setParams(policy.filter);
+    relocalize();
+}
+
+void ThreatEngine::setProjection(const Geodesy::LocalProjection &projection)
+{
+    // 原点平移：滤波器里的位置整体平移，速度历史保留
+    if (m_projection.isValid()) {
+        m_filter.translate(projection.toLocal(m_projection.originLat(), m_projection.originLng()));
+    } else {
+        for (int slot = 0; slot < m_entries.size(); ++slot) m_filter.reset(slot);
+    }
+    m_projection = projection;
+    relocalize();
+}
+
+void ThreatEngine::setGeofence(const Geofence *geofence)
+{
+    m_geofence = geofence;
+    relocalize();
+}
+
+// 坐标系或围栏变化后重新判断所有航迹
+void ThreatEngine::relocalize()
+{
+    for (int slot = 0; slot < m_entries.size(); ++slot) {
+        Entry &e = m_entries[slot];
+        if (!e.used) continue;
+        unrank(slot);
+        Threat &t = e.threat;
+        if (t.hasPosition) {
+            t.local = m_filter.position(slot);
+            t.velocity = m_filter.velocity(slot);
+        }
+        updateGeofence(e);
+        t.score = scoreOf(e);
+        rank(slot);
+    }
+}
+
+void ThreatEngine::clear()
+{
+    m_entries.clear();
+    m_slotOfKey.clear();
+    m_byScore.clear();
+    m_byDistance.clear();
+    m_byBreach.clear();
+    m_coastQueue.clear();
+    m_filter.clear();
+}
+
+// ============================================================================
+// 逐帧更新：先处理移除 (槽位可能被本帧新目标复用)，再处理本帧出现的全部目标
+// (内容未变的重复上报同样是一次测量，悬停目标的速度据此收敛到 0)。
+// 坐标一次性批量换算到本地坐标并批量滤波，之后距离/接近速度/围栏都复用滤波后的状态
+// ============================================================================
+void ThreatEngine::apply(const DroneTrackDiff &diff, const TrackStore<DroneInfo> &store, qint64 nowMs)
+{
+    for (const QString &key : diff.removed) remove(key);
+
+    m_batchSlots.clear();
+    m_batchInfo.clear();
+    m_batchLat.clear();
+    m_batchLng.clear();
+    m_batchRange.clear();
+    for (int slot : store.seenSlots()) {
+        const TrackStore<DroneInfo>::Track &track = store.track(slot);
+        const DroneInfo &d = track.info;
+        claim(slot, track.key);
+        m_batchSlots.append(slot);
+        m_batchInfo.append(&d);
+        m_batchLat.append(d.uav_lat);
+        m_batchLng.append(d.uav_lng);
+        // 无坐标的目标测距也不可信 (与原距离清洗逻辑一致)
+        m_batchRange.append(hasPosition(d) && d.distance > 0.1 ? d.distance : NO_MEASUREMENT);
+    }
+
+    qsizetype count = m_batchSlots.size();
+    m_batchEast.resize(count);
+    m_batchNorth.resize(count);
+    m_projection.toLocal(m_batchLat.constData(), m_batchLng.constData(),
+                         m_batchEast.data(), m_batchNorth.data(), count);
+    for (qsizetype i = 0; i < count; ++i) {
+        if (!hasPosition(*m_batchInfo.at(i)) || !m_projection.isValid()) {
+            m_batchEast[i] = m_batchNorth[i] = NO_MEASUREMENT;
+        }
+    }
+
+    m_filter.update(m_batchSlots.constData(), m_batchEast.constData(), m_batchNorth.constData(),
+                    m_batchRange.constData(), count, nowMs);
+
+    for (qsizetype i = 0; i < count; ++i) refresh(m_batchSlots.at(i), *m_batchInfo.at(i), nowMs);
+    coast(nowMs);
+}
+
+int ThreatEngine::expire(const DroneTrackDiff &diff, qint64 nowMs)
+{
+    for (const QString &key : diff.removed) remove(key);
+    return coast(nowMs);
+}
+
+// 外推队列：有坐标的航迹每次测量后排入 (测量时刻 + coastIntervalMs)。
+// 到期仍未再测量的运动目标按滤波速度外推到当前时刻，重新判断距离/围栏并打分，
+// 外推到 maxGapMs 为止；只弹出到期的队首，不扫描全部航迹
+int ThreatEngine::coast(qint64 nowMs)
+{
+    const qint64 interval = qMax(1, m_policy.coastIntervalMs);
+    int coasted = 0;
+    while (!m_coastQueue.empty() && m_coastQueue.begin()->first <= nowMs) {
+        int slot = m_coastQueue.begin()->second;
+        m_coastQueue.erase(m_coastQueue.begin());
+        Entry &e = m_entries[slot];
+        Threat &t = e.threat;
+        e.coastDueMs = -1;
+        if (t.velocity.isNull() || !m_filter.hasPosition(slot)) continue; // 静止目标外推不改变任何结论
+
+        unrank(slot);
+        t.local = m_filter.predict(slot, nowMs);
+        if (!m_filter.hasRange(slot)) updateLocalDistance(t);
+        updateGeofence(e);
+        t.score = scoreOf(e);
+        rank(slot);
+        ++coasted;
+
+        if (nowMs - m_filter.positionMs(slot) < m_policy.filter.maxGapMs) schedule(slot, nowMs + interval);
+    }
+    return coasted;
+}
+
+void ThreatEngine::schedule(int slot, qint64 dueMs)
+{
+    Entry &e = m_entries[slot];
+    if (e.coastDueMs >= 0) m_coastQueue.erase(qMakePair(e.coastDueMs, slot));
+    e.coastDueMs = dueMs;
+    if (dueMs >= 0) m_coastQueue.insert(qMakePair(dueMs, slot));
+}
+
+// 槽位归属：新目标 (或槽位换了主人) 清空历史，否则先移出排序集合等待重新评分
+void ThreatEngine::claim(int slot, const QString &key)
+{
+    if (slot >= m_entries.size()) m_entries.resize(slot + 1);
+    Entry &e = m_entries[slot];
+
+    if (!e.used || e.threat.key != key) {
+        if (e.used) remove(e.threat.key);
+        e = Entry();
+        e.used = true;
+        e.threat.key = key;
+        m_slotOfKey.insert(key, slot);
+        m_filter.reset(slot);
+    } else {
+        unrank(slot);
+    }
+}
+
+void ThreatEngine::refresh(int slot, const DroneInfo &info, qint64 nowMs)
+{
+    Entry &e = m_entries[slot];
+    Threat &t = e.threat;
+    t.model = info.model_name;
+    t.height = info.height;
+    t.lat = info.uav_lat;
+    t.lng = info.uav_lng;
+    e.whiteList = info.whiteList;
+
+    t.hasPosition = m_filter.hasPosition(slot);
+    t.local = t.hasPosition ? m_filter.position(slot) : QPointF();
+    t.velocity = t.hasPosition ? m_filter.velocity(slot) : QPointF();
+
+    // 距离 / 接近速度：优先用侦测设备测距 (滤波后)，没有测距时用基站到目标的本地距离
+    if (m_filter.hasRange(slot)) {
+        t.distanceM = m_filter.range(slot);
+        t.closingMps = -m_filter.rangeRate(slot);
+    } else if (t.hasPosition) {
+        updateLocalDistance(t);
+    } else {
+        t.distanceM = INVALID_DISTANCE;
+        t.closingMps = 0.0;
+    }
+
+    updateGeofence(e);
+    t.score = scoreOf(e);
+    rank(slot);
+    schedule(slot, t.hasPosition ? nowMs + qMax(1, m_policy.coastIntervalMs) : -1);
+}
+
+// 没有测距时用基站到目标的本地距离，接近速度取速度在径向上的分量
+void ThreatEngine::updateLocalDistance(Threat &t)
+{
+    t.distanceM = std::hypot(t.local.x(), t.local.y());
+    t.closingMps = t.distanceM > 1.0
+        ? -(t.local.x() * t.velocity.x() + t.local.y() * t.velocity.y()) / t.distanceM : 0.0;
+}
+
+// 围栏判断：滤波后的本地坐标与速度矢量 -> 所在排除区 / 最早进入的告警区域
+void ThreatEngine::updateGeofence(Entry &e)
+{
+    Threat &t = e.threat;
+    e.alert = false;
+    t.zone.clear();
+    t.timeToBreachS = -1;
+    t.excluded = false;
+
+    if (!m_geofence || m_geofence->isEmpty() || !m_geofence->hasOrigin() || !t.hasPosition) return;
+
+    Geofence::Hit hit = m_geofence->evaluate(t.local, t.velocity, m_policy.breachHorizonSec);
+    t.excluded = hit.exclusionZone >= 0;
+    if (hit.alertZone >= 0) {
+        e.alert = true;
+        t.zone = m_geofence->zone(hit.alertZone).name;
+        t.timeToBreachS = hit.timeToBreachS;
+    }
+}
+
+void ThreatEngine::remove(const QString &key)
+{
+    auto it = m_slotOfKey.find(key);
+    if (it == m_slotOfKey.end()) return;
+    int slot = it.value();
+    m_slotOfKey.erase(it);
+
+    unrank(slot);
+    schedule(slot, -1);
+    m_entries[slot] = Entry();
+    m_filter.reset(slot);
+}
+
+void ThreatEngine::unrank(int slot)
+{
+    Entry &e = m_entries[slot];
+    if (!e.ranked) return;
+    m_byScore.erase(qMakePair(e.threat.score, slot));
+    if (!e.threat.excluded) {
+        if (e.threat.distanceM != INVALID_DISTANCE) m_byDistance.erase(qMakePair(e.threat.distanceM, slot));
+        if (e.alert) m_byBreach.erase(qMakePair(e.threat.timeToBreachS, slot));
+    }
+    e.ranked = false;
+}
+
+void ThreatEngine::rank(int slot)
+{
+    Entry &e = m_entries[slot];
+    if (e.whiteList) return; // 白名单不参与排序
+    m_byScore.insert(qMakePair(e.threat.score, slot));
+    if (!e.threat.excluded) {
+        if (e.threat.distanceM != INVALID_DISTANCE) m_byDistance.insert(qMakePair(e.threat.distanceM, slot));
+        if (e.alert) m_byBreach.insert(qMakePair(e.threat.timeToBreachS, slot));
+    }
+    e.ranked = true;
+}
+
+double ThreatEngine::scoreOf(const Entry &e)
+{
+    const Threat &t = e.threat;
+    auto cached = m_modelCache.constFind(t.model);
+    if (cached == m_modelCache.constEnd()) {
+        cached = m_modelCache.insert(t.model, m_policy.modelWeight(t.model));
+    }
+
+    double distance = 0.0;
+    if (t.distanceM != INVALID_DISTANCE && m_policy.maxRangeM > 0) {
+        distance = clamp01(1.0 - t.distanceM / m_policy.maxRangeM);
+    }
+    double closing = m_policy.closingRefMps > 0 ? clamp01(t.closingMps / m_policy.closingRefMps) : 0.0;
+    double altitude = m_policy.altitudeRefM > 0 ? clamp01(1.0 - t.height / m_policy.altitudeRefM) : 0.0;
+
+    return m_policy.weightDistance * distance
+         + m_policy.weightClosing * closing
+         + m_policy.weightAltitude * altitude
+         + m_policy.weightModel * cached.value()
+         + (e.alert ? m_policy.weightBreach : 0.0);
+}
+
+// ============================================================================
+// 处置结论：只读取各有序集合的首元素，O(1)
+// ============================================================================
+ThreatEngine::Assessment ThreatEngine::assess(bool suppressing) const
+{
+    Assessment a;
+    a.threats = int(m_byScore.size());
+    a.nearestM = m_byDistance.empty() ? INVALID_DISTANCE : m_byDistance.begin()->first;
+    a.breaches = int(m_byBreach.size());
+    if (a.threats == 0) return a;
+
+    a.top = m_entries.at(m_byScore.begin()->second).threat;
+    if (a.breaches > 0) a.breach = m_entries.at(m_byBreach.begin()->second).threat;
+    a.spoof = a.top.score >= m_policy.spoofScore;
+
+    // 滞回：压制中的门限放宽，目标在边界附近抖动时不反复启停
+    double relayDistance = m_policy.relayDistanceM + (suppressing ? m_policy.relayHysteresisM : 0.0);
+    double relayScore = m_policy.relayScore - (suppressing ? m_policy.relayScoreHysteresis : 0.0);
+    a.suppress = a.nearestM <= relayDistance || a.breaches > 0
+              || (m_policy.relayScore > 0 && !a.top.excluded && a.top.score >= relayScore);
+    return a;
+}
+
+QList<ThreatEngine::Threat> ThreatEngine::ranked(int limit) const
+{
+    QList<Threat> result;
+    for (auto it = m_byScore.begin(); it != m_byScore.end() && result.size() < limit; ++it) {
+        result.append(m_entries.at(it->second).threat);
+    }
+    return result;
+}
@@ -0,0 +1,161 @@
+#ifndef THREATENGINE_H
+#define THREATENGINE_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QString>
+#include <set>
+#include "DataStructs.h"
+#include "trackstore.h"
+#include "geofence.h"
+#include "trackfilter.h"
+#include "../Utils/geodesy.h"
+
+// ============================================================================
+// 多目标威胁评估
+//
+// 每条无人机航迹按 距离 / 接近速度 / 高度 / 机型 / 围栏告警 打分 (白名单不参与)，
+// 维护按分数排序的处置队列、按距离排序的最近目标和按预计进入时间排序的围栏告警。
+// 只对本帧上报的航迹 (含内容未变的重复上报) 按测量重新打分，每帧开销 O(上报数 · log n)；
+// 未再上报的运动目标按外推队列每 coastIntervalMs 外推一次、重新判断围栏与距离，
+// 只处理到期的队首，与在场目标总数无关。静止目标保持原分数。
+// 距离/速度取自 alpha-beta 滤波后的状态，单帧噪声不会直接触发启停。
+// ============================================================================
+
+// 决策策略 (config.ini [ThreatPolicy])，各分项得分归一化到 0~1 后加权求和
+struct ThreatPolicy {
+    double maxRangeM = 5000.0;    // 距离分：0 m 为 1，超过此距离为 0
+    double closingRefMps = 15.0;  // 接近速度分：达到此速度为 1，远离为 0
+    double altitudeRefM = 500.0;  // 高度分：贴地为 1，高于此高度为 0
+    double weightDistance = 0.5;
+    double weightClosing = 0.25;
+    double weightAltitude = 0.1;
+    double weightModel = 0.15;
+    double weightBreach = 1.0;    // 进入 (或预计进入) 禁飞区/保护区时加分
+    double breachHorizonSec = 120.0; // 围栏进入时间只预测这么远
+
+    // 机型系数：按顺序匹配机型名中包含的关键字 (不区分大小写)，都不匹配时用默认值
+    QList<QPair<QString, double>> modelWeights;
+    double defaultModelWeight = 0.5;
+
+    double spoofScore = 0.0;       // 最高分 >= 此值启动诱骗 (0 = 任一非白名单目标)
+    double relayDistanceM = 1000.0; // 任一非白名单目标进入此距离 -> 压制 (围栏告警同样压制)
+    double relayScore = 0.0;        // > 0 时最高分达到此值也压制
+    double relayHysteresisM = 100.0;    // 压制中时距离门限放宽
+    double relayScoreHysteresis = 0.1;  // 压制中时分数门限放宽
+    int relayMinHoldMs = 2000;          // 压制开启后至少保持的时间
+    int stopDelayMs = 3000;         // 威胁消失后延时停止防御
+    int coastIntervalMs = 500;      // 未再上报的运动目标每隔此时间外推一次 (最多外推 filter.maxGapMs)
+
+    TrackFilter::Params filter;     // 航迹滤波参数
+
+    double modelWeight(const QString &modelName) const;
+};
+
+class ThreatEngine
+{
+public:
+    struct Threat {
+        QString key;
+        QString model;
+        double score = 0.0;
+        double distanceM = 0.0;   // 无效坐标/距离时为无穷大
+        double closingMps = 0.0;  // 正值表示正在接近
+        double height = 0.0;
+        double lat = 0.0;
+        double lng = 0.0;
+        bool hasPosition = false;  // 坐标有效且已换算到本地坐标
+        QPointF local;             // 滤波后的本地坐标 (东, 北，米)
+        QPointF velocity;          // 滤波后的本地速度 (米/秒)
+        QString zone;              // 触发告警的围栏区域，没有为空
+        double timeToBreachS = -1; // 预计进入该区域的时间 (已在区内为 0)，没有为 -1
+        bool excluded = false;     // 位于排除区：不因该目标压制
+    };
+
+    // 本帧的处置结论
+    struct Assessment {
+        int threats = 0;           // 非白名单航迹数
+        bool spoof = false;
+        bool suppress = false;
+        double nearestM = 0.0;     // 最近目标距离 (没有有效距离时为无穷大)
+        int breaches = 0;          // 围栏告警目标数
+        Threat top;                // 最高分目标 (threats == 0 时无效)
+        Threat breach;             // 最早进入围栏的目标 (breaches == 0 时无效)
+    };
+
+    explicit ThreatEngine(const ThreatPolicy &policy = ThreatPolicy());
+
+    void setPolicy(const ThreatPolicy &policy); // 会对全部航迹重新判断、打分
+    const ThreatPolicy &policy() const { return m_policy; }
+
+    // 本地坐标系 (以基站为原点，须与围栏一致)；设置后对全部航迹重新换算
+    void setProjection(const Geodesy::LocalProjection &projection);
+    // 围栏为空或未设置时不做区域判断
+    void setGeofence(const Geofence *geofence);
+
+    // 按一帧更新：diff 为该帧的增量，store 为刚合并该帧的航迹库 (取本帧出现的全部槽位)
+    void apply(const DroneTrackDiff &diff, const TrackStore<DroneInfo> &store, qint64 nowMs);
+    // 无新帧时 (超时清理定时器)：处理移除并外推到期目标，返回外推的目标数
+    int expire(const DroneTrackDiff &diff, qint64 nowMs);
+    void clear();
+
+    // suppressing：当前是否处于压制状态 (决定使用哪一侧的滞回门限)
+    Assessment assess(bool suppressing = false) const;
+
+    // 按分数从高到低取前 limit 个目标
+    QList<Threat> ranked(int limit) const;
+    int threatCount() const { return int(m_byScore.size()); }
+
+private:
+    struct Entry {
+        bool used = false;
+        bool whiteList = false;
+        bool ranked = false;      // 是否在排序集合中
+        bool alert = false;       // 围栏告警
+        qint64 coastDueMs = -1;   // 外推队列中的到期时刻，-1 = 不在队列
+        Threat threat;
+    };
+
+    // (分数降序, 槽位) / (距离或时间升序, 槽位)；槽位保证键唯一
+    struct ScoreOrder {
+        bool operator()(const QPair<double, int> &a, const QPair<double, int> &b) const
+        {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+    using ScoreSet = std::set<QPair<double, int>, ScoreOrder>;
+    using AscendingSet = std::set<QPair<double, int>>;
+
+    void claim(int slot, const QString &key);
+    void refresh(int slot, const DroneInfo &info, qint64 nowMs);
+    int coast(qint64 nowMs);
+    void schedule(int slot, qint64 dueMs); // dueMs < 0 移出外推队列
+    void relocalize();
+    void remove(const QString &key);
+    void unrank(int slot);
+    void rank(int slot);
+    void updateGeofence(Entry &e);
+    static void updateLocalDistance(Threat &t);
+    double scoreOf(const Entry &e);
+
+    ThreatPolicy m_policy;
+    QList<Entry> m_entries;          // 按航迹库槽位索引
+    QHash<QString, int> m_slotOfKey; // 移除时航迹库已释放槽位，自行记录
+    QHash<QString, double> m_modelCache; // 机型名 -> 机型系数
+    const Geofence *m_geofence = nullptr;
+    Geodesy::LocalProjection m_projection;
+    TrackFilter m_filter;            // 按航迹库槽位索引的滤波状态 (SoA)
+
+    // 批量坐标换算的暂存区 (跨帧复用，避免每帧分配)
+    QList<int> m_batchSlots;
+    QList<const DroneInfo *> m_batchInfo;
+    QList<double> m_batchLat, m_batchLng, m_batchEast, m_batchNorth, m_batchRange;
+    ScoreSet m_byScore;
+    AscendingSet m_byDistance; // 不含排除区目标
+    AscendingSet m_byBreach;   // 围栏告警目标，按预计进入时间
+    std::set<QPair<qint64, int>> m_coastQueue; // (外推到期时刻, 槽位)
+};
+
+#endif // THREATENGINE_H
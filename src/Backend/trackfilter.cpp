@@ -0,0 +1,122 @@
+#include "trackfilter.h"
+#include <cmath>
+
+namespace {
+// 单维 alpha-beta (测距)：预测 + 修正；跳变或间隔过长时直接以测量重新起始
+inline void step(double &x, double &v, double z, double dt, double alpha, double beta, double gate)
+{
+    double predicted = x + v * dt;
+    double residual = z - predicted;
+    if (std::abs(residual) > gate) {
+        x = z;
+        v = 0.0;
+        return;
+    }
+    x = predicted + alpha * residual;
+    v += (beta / dt) * residual;
+}
+}
+
+void TrackFilter::ensure(int slot)
+{
+    if (slot < m_x.size()) return;
+    int n = slot + 1;
+    m_x.resize(n);
+    m_y.resize(n);
+    m_vx.resize(n);
+    m_vy.resize(n);
+    m_r.resize(n);
+    m_rv.resize(n);
+    m_posMs.resize(n, -1);
+    m_rangeMs.resize(n, -1);
+}
+
+void TrackFilter::reset(int slot)
+{
+    ensure(slot);
+    m_vx[slot] = m_vy[slot] = m_rv[slot] = 0.0;
+    m_posMs[slot] = -1;
+    m_rangeMs[slot] = -1;
+}
+
+void TrackFilter::clear()
+{
+    m_x.clear(); m_y.clear(); m_vx.clear(); m_vy.clear();
+    m_r.clear(); m_rv.clear();
+    m_posMs.clear(); m_rangeMs.clear();
+}
+
+void TrackFilter::update(const int *slots, const double *east, const double *north, const double *range,
+                         qsizetype count, qint64 nowMs)
+{
+    const double alpha = m_params.alpha;
+    const double beta = m_params.beta;
+    const double gate = m_params.gateM;
+
+    for (qsizetype i = 0; i < count; ++i) {
+        int s = slots[i];
+        ensure(s);
+
+        // --- 位置 ---
+        if (std::isnan(east[i]) || std::isnan(north[i])) {
+            m_posMs[s] = -1;
+        } else {
+            qint64 gap = nowMs - m_posMs[s];
+            if (m_posMs[s] < 0 || gap > m_params.maxGapMs) {
+                m_x[s] = east[i];
+                m_y[s] = north[i];
+                m_vx[s] = m_vy[s] = 0.0;
+                m_posMs[s] = nowMs;
+            } else if (gap > 0) {
+                // 两轴共用一个门限：按平面残差判断跳变，跳变时两轴一起重新起始
+                double dt = gap / 1000.0;
+                double px = m_x[s] + m_vx[s] * dt;
+                double py = m_y[s] + m_vy[s] * dt;
+                double rx = east[i] - px;
+                double ry = north[i] - py;
+                if (std::hypot(rx, ry) > gate) {
+                    m_x[s] = east[i];
+                    m_y[s] = north[i];
+                    m_vx[s] = m_vy[s] = 0.0;
+                } else {
+                    m_x[s] = px + alpha * rx;
+                    m_y[s] = py + alpha * ry;
+                    m_vx[s] += (beta / dt) * rx;
+                    m_vy[s] += (beta / dt) * ry;
+                }
+                m_posMs[s] = nowMs;
+            }
+        }
+
+        // --- 测距 ---
+        if (std::isnan(range[i])) {
+            m_rangeMs[s] = -1;
+        } else {
+            qint64 gap = nowMs - m_rangeMs[s];
+            if (m_rangeMs[s] < 0 || gap > m_params.maxGapMs) {
+                m_r[s] = range[i];
+                m_rv[s] = 0.0;
+                m_rangeMs[s] = nowMs;
+            } else if (gap > 0) {
+                step(m_r[s], m_rv[s], range[i], gap / 1000.0, alpha, beta, gate);
+                m_rangeMs[s] = nowMs;
+            }
+        }
+    }
+}
+
+void TrackFilter::translate(const QPointF &offset)
+{
+    for (qsizetype i = 0; i < m_x.size(); ++i) {
+        m_x[i] += offset.x();
+        m_y[i] += offset.y();
+    }
+}
+
+QPointF TrackFilter::predict(int slot, qint64 nowMs) const
+{
+    if (!hasPosition(slot)) return QPointF();
+    // 外推不超过 maxGapMs，再久的测量下次到来时本来也会重新起始
+    double dt = qBound<qint64>(0, nowMs - m_posMs.at(slot), m_params.maxGapMs) / 1000.0;
+    return QPointF(m_x.at(slot) + m_vx.at(slot) * dt, m_y.at(slot) + m_vy.at(slot) * dt);
+}
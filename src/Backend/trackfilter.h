@@ -0,0 +1,64 @@
+#ifndef TRACKFILTER_H
+#define TRACKFILTER_H
+
+#include <QList>
+#include <QPointF>
+#include <QtGlobal>
+
+// ============================================================================
+// 航迹滤波 (alpha-beta，匀速模型)
+//
+// 每条航迹维护本地坐标 位置/速度 与侦测测距 距离/距离变化率 两组状态，
+// 新测量到来时先按上次速度外推到当前时刻 (预测)，再按残差修正。
+// 状态按 TrackStore 槽位下标存放在平行数组 (SoA) 中，批量更新只顺序访问
+// 几个 double 数组，数百条航迹一帧在微秒级完成。
+// ============================================================================
+class TrackFilter
+{
+public:
+    struct Params {
+        double alpha = 0.5;      // 位置修正系数 (越大越相信测量)
+        double beta = 0.15;      // 速度修正系数
+        double gateM = 300.0;    // 残差 (位置取平面距离) 超过此值视为跳变，重新起始
+        qint64 maxGapMs = 5000;  // 两次测量间隔超过此值重新起始
+    };
+
+    void setParams(const Params &params) { m_params = params; }
+    const Params &params() const { return m_params; }
+
+    // 槽位重新分配给新目标时清空状态
+    void reset(int slot);
+    void clear();
+
+    // 批量更新：slots[i] 的测量为 (east[i], north[i]) 与 range[i]，无测量的分量传 NaN
+    void update(const int *slots, const double *east, const double *north, const double *range,
+                qsizetype count, qint64 nowMs);
+
+    // 本地坐标系原点平移后，已有位置整体平移 offset (速度不变)
+    void translate(const QPointF &offset);
+
+    bool hasPosition(int slot) const { return slot < m_posMs.size() && m_posMs.at(slot) >= 0; }
+    qint64 positionMs(int slot) const { return m_posMs.at(slot); } // 上次位置测量时刻
+    bool hasRange(int slot) const { return slot < m_rangeMs.size() && m_rangeMs.at(slot) >= 0; }
+    QPointF position(int slot) const { return QPointF(m_x.at(slot), m_y.at(slot)); }
+    QPointF velocity(int slot) const { return QPointF(m_vx.at(slot), m_vy.at(slot)); }
+    double range(int slot) const { return m_r.at(slot); }
+    double rangeRate(int slot) const { return m_rv.at(slot); }
+
+    // 外推到 nowMs 时刻的位置 (本帧没有测量的航迹使用，最多外推 maxGapMs)
+    QPointF predict(int slot, qint64 nowMs) const;
+
+private:
+    void ensure(int slot);
+
+    Params m_params;
+
+    // 位置 / 速度 (本地坐标，米、米/秒)
+    QList<double> m_x, m_y, m_vx, m_vy;
+    QList<qint64> m_posMs;   // 上次位置测量时刻，-1 = 未起始
+    // 测距 / 距离变化率
+    QList<double> m_r, m_rv;
+    QList<qint64> m_rangeMs; // 上次测距时刻，-1 = 未起始
+};
+
+#endif // TRACKFILTER_H
@@ -0,0 +1,154 @@
+#include "trackfusion.h"
+#include <QtGlobal>
+
+const QList<DroneInfo> &TrackFusion::ingest(int source, const QList<DroneInfo> &reports, qint64 nowMs)
+{
+    ++m_frame;
+    m_output.clear();
+
+    for (const DroneInfo &report : reports) {
+        int slot = lookup(source, report);
+        if (slot < 0) {
+            if (report.uav_id.isEmpty() && report.uuid.isEmpty()) continue;
+            slot = allocate();
+        }
+        link(slot, source, report);
+
+        Target &t = m_targets[slot];
+        t.lastMs = nowMs;
+        if (t.frame != m_frame) {
+            // 本帧首次出现；同一数据源同帧重复上报时覆盖前一条
+            t.frame = m_frame;
+            t.outIndex = m_output.size();
+            m_output.append(DroneInfo());
+        }
+
+        Report r;
+        r.source = source;
+        r.atMs = nowMs;
+        if (!(report.uav_lat == 0.0 && report.uav_lng == 0.0)) {
+            r.lat = report.uav_lat;
+            r.lng = report.uav_lng;
+            r.height = report.height;
+            r.weight = 1.0 / qMax(report.distance, m_options.minWeightDistanceM);
+        }
+        r.distance = report.distance;
+        r.azimuth = report.azimuth;
+
+        bool replaced = false;
+        for (Report &existing : t.reports) {
+            if (existing.source == source) {
+                existing = r;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) t.reports.append(r);
+
+        merge(t, report, nowMs, m_output[t.outIndex]);
+    }
+    return m_output;
+}
+
+void TrackFusion::expire(qint64 nowMs)
+{
+    for (int slot = 0; slot < m_targets.size(); ++slot) {
+        const Target &t = m_targets.at(slot);
+        if (t.alive && nowMs - t.lastMs > m_options.windowMs) release(slot);
+    }
+}
+
+// 先按序列号 (跨数据源)，再按本数据源的追踪 ID；两者都有但序列号不同的视为不同目标
+int TrackFusion::lookup(int source, const DroneInfo &report) const
+{
+    if (!report.uav_id.isEmpty()) {
+        auto it = m_byUavId.constFind(report.uav_id);
+        if (it != m_byUavId.constEnd()) return it.value();
+    }
+    if (!report.uuid.isEmpty()) {
+        auto it = m_byUuid.constFind(UuidKey(source, report.uuid));
+        if (it != m_byUuid.constEnd()) {
+            const Target &t = m_targets.at(it.value());
+            if (report.uav_id.isEmpty() || t.uavId.isEmpty()) return it.value();
+        }
+    }
+    return -1;
+}
+
+void TrackFusion::link(int slot, int source, const DroneInfo &report)
+{
+    Target &t = m_targets[slot];
+    if (t.uavId.isEmpty() && !report.uav_id.isEmpty() && !m_byUavId.contains(report.uav_id)) {
+        t.uavId = report.uav_id;
+        m_byUavId.insert(t.uavId, slot);
+    }
+    if (report.uuid.isEmpty()) return;
+
+    // 追踪 ID 指向本目标 (按序列号关联后，该数据源之前只有追踪 ID 的目标随超时淘汰)
+    UuidKey key(source, report.uuid);
+    if (m_byUuid.value(key, -1) == slot) return;
+    m_byUuid.insert(key, slot);
+    t.uuidKeys.append(key);
+    if (t.uuid.isEmpty()) t.uuid = source == 0 ? report.uuid : QString("%1#%2").arg(report.uuid).arg(source);
+}
+
+int TrackFusion::allocate()
+{
+    int slot;
+    if (!m_free.isEmpty()) {
+        slot = m_free.takeLast();
+    } else {
+        slot = m_targets.size();
+        m_targets.emplaceBack();
+    }
+    m_targets[slot].alive = true;
+    return slot;
+}
+
+void TrackFusion::release(int slot)
+{
+    Target &t = m_targets[slot];
+    if (!t.uavId.isEmpty() && m_byUavId.value(t.uavId, -1) == slot) m_byUavId.remove(t.uavId);
+    for (const UuidKey &key : t.uuidKeys) {
+        if (m_byUuid.value(key, -1) == slot) m_byUuid.remove(key);
+    }
+    t = Target();
+    m_free.append(slot);
+}
+
+// 最新报告提供型号/频率等字段；位置为有效期内各数据源按 1/距离 加权平均
+void TrackFusion::merge(Target &t, const DroneInfo &report, qint64 nowMs, DroneInfo &out) const
+{
+    out = report;
+    // 关联后沿用首次记录的标识，保证航迹库主键不随上报的数据源变化；
+    // 无序列号的目标用带数据源后缀的追踪 ID，不同板的相同追踪 ID 不会在航迹库中合并
+    if (!t.uavId.isEmpty()) out.uav_id = t.uavId;
+    else if (!t.uuid.isEmpty()) out.uuid = t.uuid;
+
+    for (int i = t.reports.size() - 1; i >= 0; --i) {
+        if (nowMs - t.reports.at(i).atMs > m_options.windowMs) t.reports.remove(i);
+    }
+
+    double sumW = 0.0, lat = 0.0, lng = 0.0, height = 0.0;
+    int primary = -1;
+    for (int i = 0; i < t.reports.size(); ++i) {
+        const Report &r = t.reports.at(i);
+        if (r.weight > 0.0) {
+            sumW += r.weight;
+            lat += r.lat * r.weight;
+            lng += r.lng * r.weight;
+            height += r.height * r.weight;
+        }
+        if (primary < 0 || r.source < t.reports.at(primary).source) primary = i;
+    }
+
+    if (sumW > 0.0) {
+        out.uav_lat = lat / sumW;
+        out.uav_lng = lng / sumW;
+        out.height = height / sumW;
+    }
+    if (primary >= 0) {
+        out.distance = t.reports.at(primary).distance;
+        out.azimuth = t.reports.at(primary).azimuth;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef TRACKFUSION_H
+#define TRACKFUSION_H
+
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVarLengthArray>
+#include "DataStructs.h"
+
+// ============================================================================
+// 多数据源目标融合
+//
+// 覆盖范围重叠的多块侦测板会上报同一架无人机：只按序列号 (uav_id) 跨数据源关联。
+// 追踪 ID (uuid) 只在单板内唯一，按 (数据源, uuid) 索引，只用于关联同一数据源
+// 先后的报告；同一目标后来报出序列号时再与其他数据源的报告合并。
+// 每个目标保存各数据源最近一次报告 (只保留 windowMs 内的)，位置按距离
+// 反比加权合并 (离目标越近的侦测板定位越准)，其余字段取最新报告；
+// 距离/方位取编号最小的数据源 (主数据源与基站同址)。
+//
+// 一帧的代价只与该帧报告数及看到同一目标的数据源数有关 (哈希查找 +
+// 遍历该目标的少量报告)，与接入的数据源总数无关。
+// 输出只包含本帧涉及的目标，未出现的目标由航迹库按超时处理。
+// ============================================================================
+class TrackFusion
+{
+public:
+    struct Options {
+        qint64 windowMs = 3000;       // 报告参与合并的有效期
+        double minWeightDistanceM = 50.0; // 权重 1/距离 的距离下限，避免近距离权重发散
+    };
+
+    void setOptions(const Options &options) { m_options = options; }
+    const Options &options() const { return m_options; }
+
+    // 数据源 source 的一帧报告：关联、去重、合并；返回本帧涉及目标的融合结果
+    // (内部缓冲，下次调用前有效)
+    const QList<DroneInfo> &ingest(int source, const QList<DroneInfo> &reports, qint64 nowMs);
+
+    // 移除所有报告都已过期的目标 (由航迹超时定时器周期调用)
+    void expire(qint64 nowMs);
+
+    int size() const { return m_targets.size() - m_free.size(); }
+
+private:
+    struct Report {
+        int source = 0;
+        qint64 atMs = 0;
+        double lat = 0.0;
+        double lng = 0.0;
+        double height = 0.0;
+        double weight = 0.0; // 0 = 无有效坐标，不参与位置合并
+        double distance = 0.0;
+        double azimuth = 0.0;
+    };
+
+    using UuidKey = QPair<int, QString>; // (数据源, 追踪 ID)
+
+    struct Target {
+        QString uavId;
+        QString uuid; // 无序列号时对外的标识 (首个关联的追踪 ID，非 0 号数据源加后缀)
+        QVarLengthArray<UuidKey, 2> uuidKeys;
+        qint64 lastMs = 0;
+        QVarLengthArray<Report, 4> reports; // 每个数据源一条
+        quint32 frame = 0; // 最近一次出现的帧号 (同帧重复报告去重)
+        int outIndex = -1; // 本帧在输出列表中的位置
+        bool alive = false;
+    };
+
+    int lookup(int source, const DroneInfo &report) const;
+    int allocate();
+    void release(int slot);
+    void link(int slot, int source, const DroneInfo &report);
+    void merge(Target &t, const DroneInfo &report, qint64 nowMs, DroneInfo &out) const;
+
+    Options m_options;
+    QList<Target> m_targets;
+    QList<int> m_free;
+    QHash<QString, int> m_byUavId;
+    QHash<UuidKey, int> m_byUuid;
+    QList<DroneInfo> m_output;
+    quint32 m_frame = 0;
+};
+
+#endif // TRACKFUSION_H
@@ -0,0 +1,224 @@
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QMetaType>
+#include <utility>
+#include "DataStructs.h"
+
+// ==========================================
+// 1. 单帧增量 (新增 / 内容变化 / 超时移除)
+// ==========================================
+template <typename Info>
+struct TrackDiff {
+    QList<Info> added;
+    QList<Info> updated;
+    QStringList removed;  // 被移除目标的 key
+
+    bool isEmpty() const { return added.isEmpty() && updated.isEmpty() && removed.isEmpty(); }
+    void clear() { added.clear(); updated.clear(); removed.clear(); }
+};
+
+using DroneTrackDiff = TrackDiff<DroneInfo>;
+using ImageTrackDiff = TrackDiff<ImageInfo>;
+
+Q_DECLARE_METATYPE(DroneTrackDiff)
+Q_DECLARE_METATYPE(ImageTrackDiff)
+
+// ==========================================
+// 2. 目标主键与内容比较
+// ==========================================
+// 无人机优先用序列号，部分机型只有追踪 ID
+inline QString trackKey(const DroneInfo &d) { return d.uav_id.isEmpty() ? d.uuid : d.uav_id; }
+inline QString trackKey(const ImageInfo &i) { return i.id; }
+
+inline bool trackChanged(const DroneInfo &a, const DroneInfo &b)
+{
+    return a.distance != b.distance || a.azimuth != b.azimuth
+        || a.uav_lat != b.uav_lat || a.uav_lng != b.uav_lng
+        || a.height != b.height || a.freq != b.freq
+        || a.pilot_lat != b.pilot_lat || a.pilot_lng != b.pilot_lng
+        || a.pilot_distance != b.pilot_distance || a.whiteList != b.whiteList
+        || a.img != b.img || a.velocity != b.velocity
+        || a.model_name != b.model_name || a.uuid != b.uuid || a.type != b.type;
+}
+
+inline bool trackChanged(const ImageInfo &a, const ImageInfo &b)
+{
+    return a.freq != b.freq || a.amplitude != b.amplitude || a.type != b.type
+        || a.mes != b.mes || a.first != b.first;
+}
+
+// ==========================================
+// 3. 目标航迹库
+// 密集数组存储，槽位下标在目标存活期间保持不变 (可作为外部 SoA 数据的索引)；
+// 存活目标按最近出现时间串成双向链表，超时清理只从表头弹出过期目标，
+// 不再对整张表做全量扫描
+// ==========================================
+template <typename Info>
+class TrackStore
+{
+public:
+    struct Track {
+        Info info;
+        QString key;
+        qint64 lastSeenMs = 0;
+        bool alive = false;
+
+        // --- 内部：最近出现时间链表 / 本帧增量标记 ---
+        int prev = -1;
+        int next = -1;
+        quint32 diffFrame = 0;
+        quint32 seenFrame = 0;
+        bool addedInFrame = false;
+    };
+
+    explicit TrackStore(qint64 expiryMs = 4000) : m_expiryMs(expiryMs) {}
+
+    void setExpiry(qint64 expiryMs) { m_expiryMs = expiryMs; }
+    qint64 expiry() const { return m_expiryMs; }
+
+    // 合并一帧上报：新目标计入 added，已有目标仅在内容变化时计入 updated
+    // 帧内未出现的目标保留，直到超时由 expire() 移除
+    void apply(const QList<Info> &reports, qint64 nowMs, TrackDiff<Info> &diff)
+    {
+        ++m_frame;
+        m_touched.clear();
+        m_seen.clear();
+
+        for (const Info &report : reports) {
+            QString key = trackKey(report);
+            if (key.isEmpty()) continue;
+
+            auto it = m_index.constFind(key);
+            int slot;
+            if (it == m_index.constEnd()) {
+                slot = allocate(key);
+                m_tracks[slot].info = report;
+                mark(slot, true);
+            } else {
+                slot = it.value();
+                Track &t = m_tracks[slot];
+                if (trackChanged(t.info, report)) {
+                    t.info = report;
+                    mark(slot, false);
+                }
+                unlink(slot);
+            }
+            Track &t = m_tracks[slot];
+            t.lastSeenMs = nowMs;
+            if (t.seenFrame != m_frame) {
+                t.seenFrame = m_frame;
+                m_seen.append(slot);
+            }
+            pushBack(slot);
+        }
+
+        for (int slot : std::as_const(m_touched)) {
+            const Track &t = m_tracks.at(slot);
+            if (t.addedInFrame) diff.added.append(t.info);
+            else diff.updated.append(t.info);
+        }
+    }
+
+    // 移除超过 expiry 未出现的目标，只访问过期的表头部分
+    void expire(qint64 nowMs, TrackDiff<Info> &diff)
+    {
+        while (m_head >= 0 && nowMs - m_tracks.at(m_head).lastSeenMs > m_expiryMs) {
+            int slot = m_head;
+            diff.removed.append(m_tracks.at(slot).key);
+            unlink(slot);
+            release(slot);
+        }
+    }
+
+    int size() const { return m_index.size(); }
+    bool isEmpty() const { return m_index.isEmpty(); }
+
+    // 槽位查询，不存在返回 -1
+    int slotOf(const QString &key) const { return m_index.value(key, -1); }
+    int capacity() const { return m_tracks.size(); }
+    const Track &track(int slot) const { return m_tracks.at(slot); }
+    // 最近一次 apply() 中出现的槽位 (含内容未变、不计入增量的目标)，下一次 apply() 前有效
+    const QList<int> &seenSlots() const { return m_seen; }
+
+    // 按最近出现时间从旧到新遍历存活目标
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        for (int slot = m_head; slot >= 0; slot = m_tracks.at(slot).next) {
+            fn(slot, m_tracks.at(slot));
+        }
+    }
+
+private:
+    int allocate(const QString &key)
+    {
+        int slot;
+        if (!m_free.isEmpty()) {
+            slot = m_free.takeLast();
+        } else {
+            slot = m_tracks.size();
+            m_tracks.emplaceBack();
+        }
+        Track &t = m_tracks[slot];
+        t.key = key;
+        t.alive = true;
+        t.prev = t.next = -1;
+        m_index.insert(key, slot);
+        return slot;
+    }
+
+    void release(int slot)
+    {
+        Track &t = m_tracks[slot];
+        m_index.remove(t.key);
+        t = Track(); // 释放字符串等资源，槽位留待复用
+        m_free.append(slot);
+    }
+
+    void mark(int slot, bool added)
+    {
+        Track &t = m_tracks[slot];
+        if (t.diffFrame == m_frame) return; // 本帧已记录 (重复上报)
+        t.diffFrame = m_frame;
+        t.addedInFrame = added;
+        m_touched.append(slot);
+    }
+
+    void unlink(int slot)
+    {
+        Track &t = m_tracks[slot];
+        if (t.prev >= 0) m_tracks[t.prev].next = t.next;
+        else if (m_head == slot) m_head = t.next;
+        if (t.next >= 0) m_tracks[t.next].prev = t.prev;
+        else if (m_tail == slot) m_tail = t.prev;
+        t.prev = t.next = -1;
+    }
+
+    void pushBack(int slot)
+    {
+        Track &t = m_tracks[slot];
+        t.prev = m_tail;
+        t.next = -1;
+        if (m_tail >= 0) m_tracks[m_tail].next = slot;
+        m_tail = slot;
+        if (m_head < 0) m_head = slot;
+    }
+
+    QList<Track> m_tracks;       // 密集存储 (含空闲槽位)
+    QList<int> m_free;           // 空闲槽位
+    QHash<QString, int> m_index; // key -> 槽位
+    QList<int> m_touched;        // 本帧产生增量的槽位
+    QList<int> m_seen;           // 本帧出现的槽位
+
+    int m_head = -1;             // 最久未出现
+    int m_tail = -1;             // 最近出现
+    quint32 m_frame = 0;
+    qint64 m_expiryMs;
+};
+
+#endif // TRACKSTORE_H
@@ -1,12 +1,30 @@
 #include "radarview.h"
+#include "tileloader.h"
 #include <QPainter>
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QtMath>
 #include <QDebug>
 #include <QCoreApplication>
 
 const int TILE_SIZE = 256;
-const double PI = 3.14159265358979323846;
+
+// 缩放范围；缺瓦片时最多向上找几级顶替
+const int MIN_ZOOM = 1;
+const int MAX_ZOOM = 18;
+const int MAX_FALLBACK_LEVELS = 4;
+
+// 预取：视口外多取几圈；在途请求超过上限时暂停预取，把带宽留给可见瓦片
+const int PREFETCH_RING = 1;
+const int PREFETCH_MAX_PENDING = 12;
+const int PREFETCH_PER_ROUND = 16;
+const int PREFETCH_DELAY_MS = 200;
+
+// 下载失败的瓦片在此时间内不再重复请求 (避免每帧重绘都重新发起)
+const qint64 TILE_RETRY_MS = 30000;
+
+// 已解码瓦片的内存预算 (256x256 ARGB32 每张 256KB，约 384 张)
+const int TILE_CACHE_BUDGET_KB = 96 * 1024;
 
 RadarView::RadarView(QWidget *parent) : QWidget(parent)
 {
@@ -20,6 +38,7 @@ RadarView::RadarView(QWidget *parent) : QWidget(parent)
     m_zoomLevel = 15;
     m_centerLat = 34.218146;
     m_centerLng = 108.834316;
+    m_centerWorld = Geodesy::Mercator::toWorld(m_centerLat, m_centerLng);
     m_wheelAccumulator = 0;
     m_isDragging = false;
 
@@ -31,11 +50,28 @@ RadarView::RadarView(QWidget *parent) : QWidget(parent)
     connect(m_netManager, &QNetworkAccessManager::finished,
             this, &RadarView::onTileDownloaded);
 
-    // 5. 设置背景
-    QPalette pal = palette();
-    pal.setColor(QPalette::Window, QColor(20, 20, 20));
-    setPalette(pal);
-    setAutoFillBackground(true);
+    // 5. 内存缓存与后台加载
+    m_tileCache.setMaxCost(TILE_CACHE_BUDGET_KB);
+    m_stats.budgetKB = TILE_CACHE_BUDGET_KB;
+
+    m_clock.start();
+    m_tileLoader = new TileLoader(this);
+    connect(m_tileLoader, &TileLoader::sigTileDecoded, this, &RadarView::onTileDecoded);
+    connect(m_tileLoader, &TileLoader::sigTileMissing, this, &RadarView::onTileMissing);
+    connect(m_tileLoader, &TileLoader::sigTileFailed, this, &RadarView::onTileFailed);
+
+    // 预取在视图静止一段时间后进行 (每次重绘重新计时)
+    m_prefetchTimer = new QTimer(this);
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(PREFETCH_DELAY_MS);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &RadarView::onPrefetchTimeout);
+
+    // 离线瓦片包 (由 DroneShield_TileSeed 生成)，放在缓存目录下: <图层>.tiles
+    m_tileLoader->openArchive(QString("%1/%2.tiles").arg(m_diskCachePath, m_layerType));
+
+    // 6. 设置背景 (地图层已铺满整个控件，无需 Qt 先填充背景)
+    m_mapDirty = true;
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 RadarView::~RadarView() {}
@@ -90,52 +126,153 @@ QString RadarView::getTileFilePath(int x, int y, int z)
 
 // =========================================================
 // 绘图事件
+// 地图层 (瓦片 + 本机 + 版权) 预先合成到离屏 m_mapLayer，只在平移/缩放/瓦片到达/
+// 尺寸变化时重画；目标只是叠加层，按脏矩形局部刷新，
+// 所以每帧探测数据的重绘开销与视口大小无关
 // =========================================================
 void RadarView::paintEvent(QPaintEvent *event)
 {
+    if (m_mapDirty || m_mapLayer.size() != size() * devicePixelRatioF()) {
+        renderMapLayer();
+    }
+
     QPainter p(this);
+
+    // 1. 只拷贝需要重绘的那部分地图
+    const QRect dirty = event->rect();
+    const qreal dpr = m_mapLayer.devicePixelRatio();
+    p.drawPixmap(dirty, m_mapLayer,
+                 QRectF(dirty.x() * dpr, dirty.y() * dpr, dirty.width() * dpr, dirty.height() * dpr));
+
+    // 2. 目标叠加层
     p.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < m_targets.size(); ++i) {
+        const RadarTarget &target = m_targets.at(i);
+        QPointF sPos = worldToScreen(m_targetWorld.at(i));
+        if (!dirty.intersects(targetRect(target, sPos))) continue;
+
+        p.save();
+        p.translate(sPos);
+
+        // 绘制目标点 (红色)
+        p.setBrush(Qt::red);
+        p.setPen(Qt::white);
+        p.drawEllipse(QPoint(0,0), 6, 6);
+
+        // 绘制 ID
+        p.setPen(Qt::white);
+        p.drawText(10, 5, target.id);
+
+        p.restore();
+    }
+}
+
+void RadarView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    invalidateMap();
+}
+
+void RadarView::invalidateMap()
+{
+    m_mapDirty = true;
+    update();
+}
+
+QRect RadarView::visibleTiles() const
+{
+    QPointF centerTilePos = m_centerWorld * double(1 << m_zoomLevel);
+    double halfW = width() / 2.0 / TILE_SIZE;
+    double halfH = height() / 2.0 / TILE_SIZE;
+    return QRect(QPoint(int(floor(centerTilePos.x() - halfW)), int(floor(centerTilePos.y() - halfH))),
+                 QPoint(int(ceil(centerTilePos.x() + halfW)), int(ceil(centerTilePos.y() + halfH))));
+}
+
+// 上下级瓦片换算成本级瓦片范围 [x0, x1) × [y0, y1) 后与视口比较 (经度方向按回绕后的列号)
+bool RadarView::isTileVisible(const TileCoord &coord) const
+{
+    int dz = coord.z - m_zoomLevel;
+    if (dz > 1 || dz < -MAX_FALLBACK_LEVELS) return false; // 不参与当前地图的绘制
+
+    int x0, x1, y0, y1;
+    if (dz >= 0) {
+        x0 = coord.x >> dz;
+        y0 = coord.y >> dz;
+        x1 = x0 + 1;
+        y1 = y0 + 1;
+    } else {
+        x0 = coord.x << -dz;
+        y0 = coord.y << -dz;
+        x1 = (coord.x + 1) << -dz;
+        y1 = (coord.y + 1) << -dz;
+    }
+
+    const QRect tiles = visibleTiles();
+    if (y1 <= tiles.top() || y0 > tiles.bottom()) return false;
+
+    int maxTile = 1 << m_zoomLevel;
+    for (int x = tiles.left(); x <= tiles.right(); ++x) {
+        int validX = (x % maxTile + maxTile) % maxTile;
+        if (validX >= x0 && validX < x1) return true;
+    }
+    return false;
+}
+
+// 重画整张地图层 (背景 + 瓦片 + 本机 + 版权)
+void RadarView::renderMapLayer()
+{
+    const qreal dpr = devicePixelRatioF();
+    if (m_mapLayer.size() != size() * dpr) {
+        m_mapLayer = QPixmap(size() * dpr);
+        m_mapLayer.setDevicePixelRatio(dpr);
+    }
+    m_mapLayer.fill(QColor(20, 20, 20));
+    m_mapDirty = false;
+
+    QPainter p(&m_mapLayer);
+    p.setRenderHint(QPainter::SmoothPixmapTransform); // 顶替瓦片需要缩放
 
     // 1. 计算中心瓦片位置
-    QPointF centerTilePos = latLonToTile(m_centerLat, m_centerLng, m_zoomLevel);
+    QPointF centerTilePos = m_centerWorld * double(1 << m_zoomLevel);
 
     // 2. 计算屏幕覆盖范围
     int width = this->width();
     int height = this->height();
-
-    double halfW = width / 2.0 / TILE_SIZE;
-    double halfH = height / 2.0 / TILE_SIZE;
-
-    int startX = floor(centerTilePos.x() - halfW);
-    int endX = ceil(centerTilePos.x() + halfW);
-    int startY = floor(centerTilePos.y() - halfH);
-    int endY = ceil(centerTilePos.y() + halfH);
+    const QRect tiles = visibleTiles();
 
     // 3. 绘制瓦片
-    int maxTile = pow(2, m_zoomLevel);
+    int maxTile = 1 << m_zoomLevel;
 
-    for (int x = startX; x <= endX; ++x) {
-        for (int y = startY; y <= endY; ++y) {
+    for (int x = tiles.left(); x <= tiles.right(); ++x) {
+        for (int y = tiles.top(); y <= tiles.bottom(); ++y) {
             int validX = (x % maxTile + maxTile) % maxTile; // 经度循环
             if (y < 0 || y >= maxTile) continue;
 
             TileCoord coord = {validX, y, m_zoomLevel};
             QPointF screenPos = tileToScreen(QPointF(x, y), centerTilePos);
 
-            // 优先画内存缓存
-            if (m_tileCache.contains(coord)) {
-                p.drawPixmap(screenPos, m_tileCache[coord]);
+            // 优先画内存缓存 (object() 同时刷新 LRU 顺序)
+            if (const QPixmap *pix = m_tileCache.object(coord)) {
+                ++m_stats.hits;
+                p.drawPixmap(screenPos, *pix);
             } else {
-                // 画网格占位
-                p.setPen(QColor(60, 60, 60));
-                p.drawRect(screenPos.x(), screenPos.y(), TILE_SIZE, TILE_SIZE);
+                ++m_stats.misses;
+                // 用缓存中的上级/下级瓦片缩放顶替，都没有时才画网格占位
+                if (!drawFallbackTile(p, coord, QRectF(screenPos, QSizeF(TILE_SIZE, TILE_SIZE)))) {
+                    p.setPen(QColor(60, 60, 60));
+                    p.drawRect(screenPos.x(), screenPos.y(), TILE_SIZE, TILE_SIZE);
+                }
                 // 触发下载
                 fetchTile(validX, y, m_zoomLevel);
             }
         }
     }
 
+    // 可见瓦片请求完之后，空闲时再预取周边和相邻缩放级别
+    m_prefetchTimer->start();
+
     // 4. 绘制中心 (本机)
+    p.setRenderHint(QPainter::Antialiasing);
     QPoint centerScreen(width / 2, height / 2);
     p.setPen(Qt::NoPen);
     p.setBrush(QColor(0, 255, 0, 200));
@@ -143,60 +280,147 @@ void RadarView::paintEvent(QPaintEvent *event)
     p.setPen(Qt::white);
     p.drawText(centerScreen + QPoint(12, 5), "本机");
 
-    // 5. 绘制无人机目标
-    for (const auto &target : m_targets) {
-        QPointF tPos = latLonToTile(target.lat, target.lng, m_zoomLevel);
-        QPointF sPos = tileToScreen(tPos, centerTilePos);
+    // 版权信息
+    p.setPen(Qt::lightGray);
+    p.drawText(rect().bottomRight() - QPoint(120, 10), "天地图 Tianditu");
+}
 
-        p.save();
-        p.translate(sPos);
+// 目标在屏幕上占用的区域 (圆点 + ID 文字)，用于脏矩形刷新
+QRect RadarView::targetRect(const RadarTarget &target, const QPointF &screenPos) const
+{
+    // 圆点半径 6 (含描边约 7)，文字基线在 (10, 5)
+    const QFontMetrics fm = fontMetrics();
+    int left = -7;
+    int right = 10 + fm.horizontalAdvance(target.id);
+    int top = qMin(-7, 5 - fm.ascent());
+    int bottom = qMax(7, 5 + fm.descent());
+    return QRect(QPoint(left, top), QPoint(right, bottom))
+        .translated(screenPos.toPoint()).adjusted(-2, -2, 2, 2);
+}
 
-        // 绘制目标点 (红色)
-        p.setBrush(Qt::red);
-        p.setPen(Qt::white);
-        p.drawEllipse(QPoint(0,0), 6, 6);
+QRegion RadarView::targetRegion() const
+{
+    QRegion region;
+    for (int i = 0; i < m_targets.size(); ++i) {
+        region += targetRect(m_targets.at(i), worldToScreen(m_targetWorld.at(i)));
+    }
+    return region;
+}
 
-        // 绘制 ID
-        p.setPen(Qt::white);
-        p.drawText(10, 5, target.id);
+// =========================================================
+// 缺瓦片时的多分辨率顶替
+// 先画最近的上级瓦片 (取对应子区域放大)，再把已有的下一级子瓦片 (缩小) 叠上去，
+// 缩放切换时画面始终有底图，不会出现空白网格
+// =========================================================
+bool RadarView::drawFallbackTile(QPainter &p, const TileCoord &coord, const QRectF &target)
+{
+    bool drawn = false;
+
+    // 1. 上级瓦片：z-1 ... z-MAX_FALLBACK_LEVELS
+    for (int dz = 1; dz <= MAX_FALLBACK_LEVELS && coord.z - dz >= 0; ++dz) {
+        TileCoord parent = {coord.x >> dz, coord.y >> dz, coord.z - dz};
+        if (const QPixmap *pix = m_tileCache.object(parent)) {
+            int sub = TILE_SIZE >> dz;
+            int mask = (1 << dz) - 1;
+            QRectF source((coord.x & mask) * sub, (coord.y & mask) * sub, sub, sub);
+            p.drawPixmap(target, *pix, source);
+            drawn = true;
+            break;
+        }
+    }
 
-        p.restore();
+    // 2. 下一级子瓦片 (更清晰)，有几张画几张
+    if (coord.z + 1 <= MAX_ZOOM) {
+        double half = target.width() / 2.0;
+        for (int i = 0; i < 4; ++i) {
+            TileCoord child = {coord.x * 2 + (i & 1), coord.y * 2 + (i >> 1), coord.z + 1};
+            if (const QPixmap *pix = m_tileCache.object(child)) {
+                QRectF quarter(target.x() + (i & 1) * half, target.y() + (i >> 1) * half, half, half);
+                p.drawPixmap(quarter, *pix, pix->rect());
+                drawn = true;
+            }
+        }
     }
+    return drawn;
+}
 
-    // 版权信息
-    p.setPen(Qt::lightGray);
-    p.drawText(rect().bottomRight() - QPoint(120, 10), "天地图 Tianditu");
+// =========================================================
+// 预取 (低优先级)
+// 视口外一圈 + 相邻缩放级别的视口，只在可见瓦片的请求不多时才发出，
+// 并且磁盘/解码/网络都以低优先级排队
+// =========================================================
+void RadarView::onPrefetchTimeout()
+{
+    int budget = PREFETCH_PER_ROUND;
+    const int zooms[] = {m_zoomLevel, m_zoomLevel + 1, m_zoomLevel - 1};
+
+    for (int z : zooms) {
+        if (z < MIN_ZOOM || z > MAX_ZOOM) continue;
+
+        QPointF center = m_centerWorld * double(1 << z);
+        double halfW = width() / 2.0 / TILE_SIZE + (z == m_zoomLevel ? PREFETCH_RING : 0);
+        double halfH = height() / 2.0 / TILE_SIZE + (z == m_zoomLevel ? PREFETCH_RING : 0);
+        int maxTile = 1 << z;
+
+        for (int x = floor(center.x() - halfW); x <= ceil(center.x() + halfW); ++x) {
+            for (int y = floor(center.y() - halfH); y <= ceil(center.y() + halfH); ++y) {
+                if (y < 0 || y >= maxTile) continue;
+                if (m_pendingTiles.size() >= PREFETCH_MAX_PENDING || budget <= 0) return;
+
+                int validX = (x % maxTile + maxTile) % maxTile;
+                TileCoord coord = {validX, y, z};
+                if (m_tileCache.contains(coord)) continue; // contains() 不改变 LRU 顺序
+                if (fetchTile(validX, y, z, true)) --budget;
+            }
+        }
+    }
 }
 
 // =========================================================
-// 瓦片获取 (内存 -> 磁盘 -> 网络)
+// 瓦片获取 (内存 -> 离线瓦片包 -> 磁盘 -> 网络)
+// 磁盘读取与解码都在 TileLoader 线程池中进行，paintEvent 不再阻塞
 // =========================================================
-void RadarView::fetchTile(int x, int y, int z)
+bool RadarView::fetchTile(int x, int y, int z, bool prefetch)
 {
     TileCoord coord = {x, y, z};
-    if (m_pendingTiles.contains(coord)) return;
-
-    // A. 查本地磁盘
-    QString path = getTileFilePath(x, y, z);
-    if (QFile::exists(path)) {
-        QPixmap pix;
-        if (pix.load(path)) {
-            m_tileCache.insert(coord, pix);
-            update();
-            return;
-        }
+    quint64 key = coord.key();
+
+    // 同一瓦片只会有一个在途请求 (跨缩放级别切换也不会重复获取)；
+    // 预取中的瓦片变为可见时，后续的网络/解码阶段按正常优先级进行
+    if (m_pendingTiles.contains(key)) {
+        if (!prefetch) m_prefetchTiles.remove(key);
+        return false;
+    }
+
+    // 最近下载失败的瓦片，等到重试时刻再请求
+    auto failed = m_failedTiles.constFind(key);
+    if (failed != m_failedTiles.constEnd()) {
+        if (m_clock.elapsed() < failed.value()) return false;
+        m_failedTiles.erase(failed);
     }
 
-    // B. 发起网络请求
-    m_pendingTiles.append(coord);
-    QString url = getTileUrl(x, y, z);
+    m_pendingTiles.insert(key);
+    if (prefetch) m_prefetchTiles.insert(key);
+    int priority = prefetch ? TileLoader::PrefetchPriority : TileLoader::VisiblePriority;
+
+    // A. 离线瓦片包：一次索引查找，没有逐瓦片的 open()
+    if (m_tileLoader->loadFromArchive(coord, priority)) return true;
+
+    // B. 查本地磁盘 (后台)，不存在时回调 onTileMissing 再走网络
+    m_tileLoader->loadFromDisk(coord, getTileFilePath(x, y, z), priority);
+    return true;
+}
+
+void RadarView::requestTileFromNetwork(const TileCoord &coord)
+{
+    // C. 发起网络请求
+    QString url = getTileUrl(coord.x, coord.y, coord.z);
     QNetworkRequest request((QUrl(url)));
+    if (m_prefetchTiles.contains(coord.key())) request.setPriority(QNetworkRequest::LowPriority);
     request.setRawHeader("User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36");
 
     QNetworkReply *reply = m_netManager->get(request);
-    reply->setProperty("x", x);
-    reply->setProperty("y", y);
-    reply->setProperty("z", z);
+    reply->setProperty("tileKey", QVariant::fromValue(coord.key()));
 }
 
 QString RadarView::getTileUrl(int x, int y, int z)
@@ -210,54 +434,106 @@ QString RadarView::getTileUrl(int x, int y, int z)
 void RadarView::onTileDownloaded(QNetworkReply *reply)
 {
     reply->deleteLater();
-    int x = reply->property("x").toInt();
-    int y = reply->property("y").toInt();
-    int z = reply->property("z").toInt();
-    m_pendingTiles.removeOne({x, y, z});
+    TileCoord coord = TileCoord::fromKey(reply->property("tileKey").toULongLong());
 
     if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QPixmap pix;
-        if (pix.loadFromData(data)) {
-            // 存内存
-            m_tileCache.insert({x, y, z}, pix);
-            // 存磁盘
-            QString path = getTileFilePath(x, y, z);
-            QFile file(path);
-            if (file.open(QIODevice::WriteOnly)) {
-                file.write(data);
-                file.close();
-            }
-            update();
-        }
+        // 解码与落盘交给后台，仍保持 pending 直到解码完成
+        int priority = m_prefetchTiles.contains(coord.key()) ? TileLoader::PrefetchPriority
+                                                             : TileLoader::VisiblePriority;
+        m_tileLoader->decodeDownloaded(coord, reply->readAll(),
+                                       getTileFilePath(coord.x, coord.y, coord.z), priority);
+    } else {
+        onTileFailed(coord);
     }
 }
 
+void RadarView::onTileDecoded(const TileCoord &coord, const QImage &image, qint64 decodeNs)
+{
+    m_pendingTiles.remove(coord.key());
+    m_prefetchTiles.remove(coord.key());
+
+    ++m_stats.decodes;
+    m_stats.decodeNsTotal += decodeNs;
+    if (decodeNs > m_stats.decodeNsMax) m_stats.decodeNsMax = decodeNs;
+
+    // GUI 线程只做 QImage -> QPixmap 上传；按解码后大小计入预算，超出时淘汰最久未用的瓦片
+    QPixmap *pix = new QPixmap(QPixmap::fromImage(image));
+    qsizetype costKB = qMax<qsizetype>(1, image.sizeInBytes() / 1024);
+    m_tileCache.insert(coord, pix, costKB);
+
+    // 只有落在当前视口内的瓦片 (本级或可作为顶替的级别) 才需要重画地图层；
+    // 视口外的预取瓦片只进缓存，不触发重画 (重画又会重新启动预取)
+    if (isTileVisible(coord)) invalidateMap();
+}
+
+void RadarView::onTileMissing(const TileCoord &coord)
+{
+    requestTileFromNetwork(coord);
+}
+
+void RadarView::onTileFailed(const TileCoord &coord)
+{
+    quint64 key = coord.key();
+    m_pendingTiles.remove(key);
+    m_prefetchTiles.remove(key);
+    m_failedTiles.insert(key, m_clock.elapsed() + TILE_RETRY_MS);
+}
+
+TileCacheStats RadarView::tileCacheStats() const
+{
+    TileCacheStats stats = m_stats;
+    stats.memoryKB = m_tileCache.totalCost();
+    stats.tiles = m_tileCache.size();
+    return stats;
+}
+
 // =========================================================
 // 交互与数学计算
 // =========================================================
 void RadarView::updateTargets(const QList<RadarTarget> &targets) {
+    // 只刷新旧位置和新位置，地图层直接复用
+    QRegion dirty = targetRegion();
     m_targets = targets;
-    update();
+
+    // 经纬度 -> 墨卡托只在目标更新时批量算一次，绘制/脏区计算都复用
+    qsizetype n = m_targets.size();
+    QList<double> lat(n), lng(n), wx(n), wy(n);
+    for (qsizetype i = 0; i < n; ++i) {
+        lat[i] = m_targets.at(i).lat;
+        lng[i] = m_targets.at(i).lng;
+    }
+    Geodesy::Mercator::toWorld(lat.constData(), lng.constData(), wx.data(), wy.data(), n);
+    m_targetWorld.resize(n);
+    for (qsizetype i = 0; i < n; ++i) m_targetWorld[i] = QPointF(wx.at(i), wy.at(i));
+
+    dirty += targetRegion();
+    update(dirty);
 }
 
 void RadarView::setCenterPosition(double lat, double lng) {
-    if (lat != 0 && lng != 0) {
+    if (lat != 0 && lng != 0 && (lat != m_centerLat || lng != m_centerLng)) {
         m_centerLat = lat;
         m_centerLng = lng;
-        update();
+        m_centerWorld = Geodesy::Mercator::toWorld(lat, lng);
+        invalidateMap();
     }
 }
 
-QPointF RadarView::latLonToTile(double lat, double lng, int zoom) {
-    double n = pow(2.0, zoom);
-    double tileX = ((lng + 180.0) / 360.0) * n;
-    double latRad = lat * PI / 180.0;
-    double tileY = (1.0 - asinh(tan(latRad)) / PI) / 2.0 * n;
-    return QPointF(tileX, tileY);
+// 拖动时直接在墨卡托坐标上平移，再反算经纬度
+void RadarView::setCenterWorld(const QPointF &world) {
+    m_centerWorld = world;
+    QPointF geo = Geodesy::Mercator::toGeo(world.x(), world.y());
+    m_centerLng = geo.x();
+    m_centerLat = geo.y();
 }
 
-QPointF RadarView::tileToScreen(QPointF tilePos, QPointF centerTilePos) {
+QPointF RadarView::worldToScreen(const QPointF &world) const {
+    double scale = double(TILE_SIZE << m_zoomLevel);
+    return QPointF(width() / 2.0 + (world.x() - m_centerWorld.x()) * scale,
+                   height() / 2.0 + (world.y() - m_centerWorld.y()) * scale);
+}
+
+QPointF RadarView::tileToScreen(QPointF tilePos, QPointF centerTilePos) const {
     double cx = width() / 2.0;
     double cy = height() / 2.0;
     return QPointF(cx + (tilePos.x() - centerTilePos.x()) * TILE_SIZE,
@@ -276,18 +552,11 @@ void RadarView::mouseMoveEvent(QMouseEvent *event) {
         QPoint delta = event->pos() - m_lastMousePos;
         m_lastMousePos = event->pos();
 
-        // 像素 -> 经纬度反算
-        double n = pow(2.0, m_zoomLevel);
-        QPointF centerTile = latLonToTile(m_centerLat, m_centerLng, m_zoomLevel);
-
-        double newTileX = centerTile.x() - delta.x() / (double)TILE_SIZE;
-        double newTileY = centerTile.y() - delta.y() / (double)TILE_SIZE;
-
-        m_centerLng = (newTileX / n) * 360.0 - 180.0;
-        double latRad = atan(sinh(PI * (1 - 2 * newTileY / n)));
-        m_centerLat = latRad * 180.0 / PI;
+        // 像素 -> 墨卡托坐标平移
+        double scale = double(TILE_SIZE << m_zoomLevel);
+        setCenterWorld(m_centerWorld - QPointF(delta) / scale);
 
-        update();
+        invalidateMap();
     }
 }
 
@@ -298,10 +567,10 @@ void RadarView::wheelEvent(QWheelEvent *event) {
         int steps = m_wheelAccumulator / 120;
         int newZoom = m_zoomLevel + steps;
 
-        if (newZoom >= 1 && newZoom <= 18) {
+        if (newZoom >= MIN_ZOOM && newZoom <= MAX_ZOOM) {
             m_zoomLevel = newZoom;
             // 缩放时重置缓存可能会导致闪烁，不建议 m_tileCache.clear()
-            update();
+            invalidateMap();
         }
         m_wheelAccumulator = 0;
     }
@@ -5,29 +5,37 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QHash>
+#include <QCache>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QPixmap>
+#include <QImage>
 #include <QMap>
 #include <QDir>
 #include <QFile>
 #include <QStandardPaths>
-
-// --- 瓦片索引结构 ---
-struct TileCoord {
-    int x;
-    int y;
-    int z;
-
-    // 用于 QHash 的比较
-    bool operator==(const TileCoord &other) const {
-        return x == other.x && y == other.y && z == other.z;
-    }
+#include "tilecoord.h"
+#include "../Utils/geodesy.h"
+
+class TileLoader;
+class QPainter;
+
+// --- 瓦片缓存统计 ---
+struct TileCacheStats {
+    quint64 hits = 0;        // 绘制时命中内存缓存
+    quint64 misses = 0;      // 绘制时未命中 (画占位格并触发加载)
+    quint64 decodes = 0;     // 后台解码次数
+    qint64 decodeNsTotal = 0;
+    qint64 decodeNsMax = 0;
+    qint64 memoryKB = 0;     // 已解码瓦片占用内存
+    qint64 budgetKB = 0;     // 内存预算
+    int tiles = 0;           // 缓存中的瓦片数
+
+    double hitRate() const { return (hits + misses) ? double(hits) / double(hits + misses) : 0.0; }
+    double avgDecodeMs() const { return decodes ? decodeNsTotal / 1e6 / decodes : 0.0; }
 };
 
-// 全局哈希函数
-inline uint qHash(const TileCoord &key, uint seed = 0) {
-    return qHash(QString("%1-%2-%3").arg(key.x).arg(key.y).arg(key.z), seed);
-}
-
 // --- 雷达目标结构 ---
 struct RadarTarget {
     QString id;
@@ -48,14 +56,22 @@ public:
     // 设置本机中心点
     void setCenterPosition(double lat, double lng);
 
+    // 瓦片缓存统计 (命中率 / 解码耗时 / 内存占用)
+    TileCacheStats tileCacheStats() const;
+
 protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private slots:
     void onTileDownloaded(QNetworkReply *reply);
+    void onTileDecoded(const TileCoord &coord, const QImage &image, qint64 decodeNs);
+    void onTileMissing(const TileCoord &coord);
+    void onTileFailed(const TileCoord &coord);
+    void onPrefetchTimeout();
 
 private:
     // --- 配置 ---
@@ -70,12 +86,24 @@ private:
 
     // --- 缓存与网络 ---
     QNetworkAccessManager *m_netManager;
-    QHash<TileCoord, QPixmap> m_tileCache; // 内存缓存
-    QList<TileCoord> m_pendingTiles;       // 正在下载队列
+    TileLoader *m_tileLoader;              // 后台读盘/解码
+    QCache<TileCoord, QPixmap> m_tileCache; // 内存缓存 (LRU，按 KB 计预算)
+    QSet<quint64> m_pendingTiles;          // 正在加载 (读盘/下载/解码)，按打包键合并请求
+    QSet<quint64> m_prefetchTiles;         // 其中属于预取的 (低优先级)
+    QHash<quint64, qint64> m_failedTiles;  // 下载失败的瓦片 -> 允许重试的时刻 (ms)
+    QElapsedTimer m_clock;
+    QTimer *m_prefetchTimer;
     QString m_diskCachePath;               // 本地磁盘缓存目录
+    TileCacheStats m_stats;
 
     // --- 数据 ---
     QList<RadarTarget> m_targets;
+    QList<QPointF> m_targetWorld; // 目标的归一化墨卡托坐标，随目标更新批量换算一次
+    QPointF m_centerWorld;        // 中心点的归一化墨卡托坐标
+
+    // --- 绘制 ---
+    QPixmap m_mapLayer;  // 离屏地图层 (瓦片 + 本机 + 版权)
+    bool m_mapDirty;     // 平移/缩放/瓦片到达/尺寸变化后置位
 
     // --- 交互 ---
     QPoint m_lastMousePos;
@@ -85,11 +113,20 @@ private:
     void initCacheDirectory(); // 初始化缓存目录
     QString getTileFilePath(int x, int y, int z); // 获取本地文件路径
     QString getTileUrl(int x, int y, int z);      // 获取网络URL
-    void fetchTile(int x, int y, int z);          // 获取瓦片(本地->网络)
+    bool fetchTile(int x, int y, int z, bool prefetch = false); // 获取瓦片(本地->网络)，已在途时返回 false
+    void invalidateMap();                         // 标记地图层失效并重绘
+    QRect visibleTiles() const;                   // 当前缩放级别下视口覆盖的瓦片范围 (含两端，x 未回绕)
+    bool isTileVisible(const TileCoord &coord) const; // 瓦片 (本级或顶替级别) 是否落在视口内
+    void renderMapLayer();                        // 重画离屏地图层
+    QRect targetRect(const RadarTarget &target, const QPointF &screenPos) const;
+    QRegion targetRegion() const;                 // 当前所有目标占用的屏幕区域
+    bool drawFallbackTile(QPainter &p, const TileCoord &coord, const QRectF &target); // 用上/下级瓦片顶替
+    void requestTileFromNetwork(const TileCoord &coord);
 
     // --- 数学计算 ---
-    QPointF latLonToTile(double lat, double lng, int zoom);
-    QPointF tileToScreen(QPointF tilePos, QPointF centerTilePos);
+    QPointF tileToScreen(QPointF tilePos, QPointF centerTilePos) const;
+    QPointF worldToScreen(const QPointF &world) const; // 平移/缩放只影响这里的乘加
+    void setCenterWorld(const QPointF &world);
 };
 
 #endif // RADARVIEW_H
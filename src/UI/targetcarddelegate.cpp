@@ -0,0 +1,64 @@
+#include "targetcarddelegate.h"
+#include "targetlistmodel.h"
+#include <QPainter>
+#include <QFontMetrics>
+
+namespace {
+const int CARD_GAP = 5;      // 卡片之间的间距 (原布局 spacing)
+const int CARD_PADDING = 10; // 卡片内边距 (原布局 contentsMargins)
+const int LINE_SPACING = 4;  // 行间距 (原布局 spacing)
+}
+
+TargetCardDelegate::TargetCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+    m_titleFont.setBold(true);
+    m_titleFont.setPointSize(14);
+    m_lineFont.setPixelSize(12);
+
+    m_titleHeight = QFontMetrics(m_titleFont).height();
+    m_lineHeight = QFontMetrics(m_lineFont).height();
+}
+
+QSize TargetCardDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    int lines = index.data(TargetListModel::LinesRole).toStringList().size();
+    int h = CARD_PADDING * 2 + m_titleHeight + lines * (m_lineHeight + LINE_SPACING) + CARD_GAP;
+    return QSize(option.rect.width(), h);
+}
+
+void TargetCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                               const QModelIndex &index) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // 1. 卡片背景与边框
+    QRectF card = QRectF(option.rect).adjusted(0.5, 0.5, -0.5, -0.5 - CARD_GAP);
+    painter->setPen(QColor("#505050"));
+    painter->setBrush(QColor("#2D2D2D"));
+    painter->drawRoundedRect(card, 4, 4);
+
+    // 2. 标题
+    int x = option.rect.left() + CARD_PADDING;
+    int w = option.rect.width() - CARD_PADDING * 2;
+    int y = option.rect.top() + CARD_PADDING;
+
+    painter->setFont(m_titleFont);
+    painter->setPen(index.data(TargetListModel::TitleColorRole).value<QColor>());
+    painter->drawText(QRect(x, y, w, m_titleHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                      index.data(TargetListModel::TitleRole).toString());
+    y += m_titleHeight + LINE_SPACING;
+
+    // 3. 明细行
+    painter->setFont(m_lineFont);
+    painter->setPen(Qt::white);
+    const QStringList lines = index.data(TargetListModel::LinesRole).toStringList();
+    for (const QString &line : lines) {
+        painter->drawText(QRect(x, y, w, m_lineHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                          painter->fontMetrics().elidedText(line, Qt::ElideRight, w));
+        y += m_lineHeight + LINE_SPACING;
+    }
+
+    painter->restore();
+}
@@ -0,0 +1,29 @@
+#ifndef TARGETCARDDELEGATE_H
+#define TARGETCARDDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QFont>
+
+// ============================================================================
+// 目标卡片绘制代理
+// 直接用 QPainter 画出原先由 QFrame + 多个 QLabel 组成的卡片样式，
+// 没有子控件，也没有逐控件的样式表解析
+// ============================================================================
+class TargetCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit TargetCardDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    QFont m_titleFont;
+    QFont m_lineFont;
+    int m_titleHeight;
+    int m_lineHeight;
+};
+
+#endif // TARGETCARDDELEGATE_H
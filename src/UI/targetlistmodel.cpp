@@ -0,0 +1,102 @@
+#include "targetlistmodel.h"
+#include <QDateTime>
+
+TargetListModel::TargetListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int TargetListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_cards.size();
+}
+
+QVariant TargetListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_cards.size()) return QVariant();
+
+    const Card &card = m_cards.at(index.row());
+    switch (role) {
+    case KeyRole: return card.key;
+    case Qt::DisplayRole:
+    case TitleRole: return card.title;
+    case TitleColorRole: return card.titleColor;
+    case LinesRole: return card.lines;
+    default: return QVariant();
+    }
+}
+
+// ============================================================================
+// 卡片内容 (与原 createDroneCard / createImageCard 保持一致)
+// ============================================================================
+void TargetListModel::upsertDrone(const QString &key, const DroneInfo &info)
+{
+    Card card;
+    card.key = key;
+    card.title = QString("机型: %1").arg(info.model_name);
+    card.titleColor = QColor("#FFD700");
+    card.lines = {
+        QString("ID: %1").arg(info.uav_id),
+        QString("距离: %1 m").arg(info.distance, 0, 'f', 1),
+        QString("方位角: %1°").arg(info.azimuth, 0, 'f', 1),
+        QString("频率: %1 MHz").arg(info.freq, 0, 'f', 1),
+        QString("高度: %1 m").arg(info.height, 0, 'f', 1),
+        QString("无人机坐标: %1, %2").arg(info.uav_lat, 0, 'f', 6).arg(info.uav_lng, 0, 'f', 6),
+        QString("飞手坐标: %1, %2").arg(info.pilot_lat, 0, 'f', 6).arg(info.pilot_lng, 0, 'f', 6),
+        QString("飞手距离: %1 m").arg(info.pilot_distance, 0, 'f', 1),
+        QString("速度: %1").arg(info.velocity),
+        QString("UUID: %1").arg(info.uuid)
+    };
+    upsert(std::move(card));
+}
+
+void TargetListModel::upsertImage(const QString &key, const ImageInfo &info)
+{
+    // Type 1 = FPV (0x06) 蓝色, Type 0 = 图传/频谱 (0x07) 绿色
+    Card card;
+    card.key = key;
+    card.title = (info.type == 1) ? "信号: FPV (0x06)" : "信号: 图传 (0x07)";
+    card.titleColor = (info.type == 1) ? QColor("#00BFFF") : QColor("#32CD32");
+    card.lines = {
+        QString("ID: %1").arg(info.id),
+        QString("频率: %1 MHz").arg(info.freq, 0, 'f', 1),
+        QString("强度: %1").arg(info.amplitude, 0, 'f', 1),
+        QString("时间: %1").arg(QDateTime::currentDateTime().toString("HH:mm:ss")) // 最近一次更新
+    };
+    upsert(std::move(card));
+}
+
+void TargetListModel::upsert(Card &&card)
+{
+    auto it = m_rowOf.constFind(card.key);
+    if (it != m_rowOf.constEnd()) {
+        // 已存在：只通知这一行重绘
+        int row = it.value();
+        m_cards[row] = std::move(card);
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx);
+        return;
+    }
+
+    int row = m_cards.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_rowOf.insert(card.key, row);
+    m_cards.append(std::move(card));
+    endInsertRows();
+}
+
+void TargetListModel::removeTarget(const QString &key)
+{
+    auto it = m_rowOf.find(key);
+    if (it == m_rowOf.end()) return;
+
+    int row = it.value();
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rowOf.erase(it);
+    m_cards.removeAt(row);
+    // 后续行号前移
+    for (int i = row; i < m_cards.size(); ++i) {
+        m_rowOf[m_cards.at(i).key] = i;
+    }
+    endRemoveRows();
+}
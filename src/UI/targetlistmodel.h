@@ -0,0 +1,52 @@
+#ifndef TARGETLISTMODEL_H
+#define TARGETLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include "../Backend/DataStructs.h"
+
+// ============================================================================
+// 目标列表模型 (左侧面板：无人机 / FPV / 图传)
+// 每个目标一行，文字在数据变化时格式化一次；航迹增量只触及发生变化的行，
+// 由 TargetCardDelegate 绘制成卡片，不再每个刷新周期重建 QFrame/QLabel
+// ============================================================================
+class TargetListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Roles {
+        KeyRole = Qt::UserRole + 1,
+        TitleRole,        // 卡片标题
+        TitleColorRole,   // 标题颜色
+        LinesRole         // 明细行 (QStringList)
+    };
+
+    explicit TargetListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // 新增或更新 (按 key 定位行)
+    void upsertDrone(const QString &key, const DroneInfo &info);
+    void upsertImage(const QString &key, const ImageInfo &info);
+    void removeTarget(const QString &key);
+    bool contains(const QString &key) const { return m_rowOf.contains(key); }
+
+private:
+    struct Card {
+        QString key;
+        QString title;
+        QColor titleColor;
+        QStringList lines;
+    };
+
+    void upsert(Card &&card);
+
+    QList<Card> m_cards;
+    QHash<QString, int> m_rowOf; // key -> 行号
+};
+
+#endif // TARGETLISTMODEL_H
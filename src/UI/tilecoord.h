@@ -0,0 +1,39 @@
+#ifndef TILECOORD_H
+#define TILECOORD_H
+
+#include <QHash>
+#include <QMetaType>
+
+// --- 瓦片索引结构 ---
+struct TileCoord {
+    int x;
+    int y;
+    int z;
+
+    // 用于 QHash 的比较
+    bool operator==(const TileCoord &other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+
+    // 打包成 64 位整数键: z(8 位) | x(28 位) | y(28 位)
+    // 缩放级别 <= 28 时 x/y < 2^28，键唯一且可直接用于 QSet/QHash
+    quint64 key() const {
+        return (quint64(quint32(z)) << 56)
+             | (quint64(quint32(x) & 0x0FFFFFFFu) << 28)
+             | quint64(quint32(y) & 0x0FFFFFFFu);
+    }
+
+    static TileCoord fromKey(quint64 key) {
+        return { int((key >> 28) & 0x0FFFFFFFu), int(key & 0x0FFFFFFFu), int(key >> 56) };
+    }
+};
+
+// 全局哈希函数：对打包键做整数哈希，不构造字符串、不分配内存
+inline size_t qHash(const TileCoord &key, size_t seed = 0) noexcept {
+    return qHash(key.key(), seed);
+}
+
+// 解码结果由线程池排队交回 GUI 线程
+Q_DECLARE_METATYPE(TileCoord)
+
+#endif // TILECOORD_H
@@ -0,0 +1,94 @@
+#include "tileloader.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+
+namespace {
+// 解码成绘制最快的格式，GUI 线程上传时无需再转换
+QImage decodeTile(const QByteArray &data)
+{
+    QImage img;
+    if (!img.loadFromData(data)) return QImage();
+    return img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+}
+
+TileLoader::TileLoader(QObject *parent) : QObject(parent)
+{
+    // 解码是 CPU 密集型，两个线程足以跟上平移/缩放，不与后端线程抢核
+    m_pool.setMaxThreadCount(2);
+}
+
+TileLoader::~TileLoader()
+{
+    // 丢弃尚未开始的任务，等待正在执行的任务结束 (任务内会访问 this 发信号)
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool TileLoader::openArchive(const QString &path)
+{
+    return m_archive.open(path);
+}
+
+bool TileLoader::loadFromArchive(const TileCoord &coord, int priority)
+{
+    QByteArrayView bytes = m_archive.find(coord.key());
+    if (bytes.isNull()) return false;
+
+    m_pool.start([this, coord, bytes]() {
+        QElapsedTimer timer;
+        timer.start();
+        // fromRawData 不拷贝，直接解码映射内存
+        QImage img = decodeTile(QByteArray::fromRawData(bytes.data(), bytes.size()));
+        if (img.isNull()) {
+            emit sigTileMissing(coord); // 包内数据损坏，改走网络下载
+            return;
+        }
+        emit sigTileDecoded(coord, img, timer.nsecsElapsed());
+    }, priority);
+    return true;
+}
+
+void TileLoader::loadFromDisk(const TileCoord &coord, const QString &path, int priority)
+{
+    m_pool.start([this, coord, path]() {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit sigTileMissing(coord);
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        QImage img = decodeTile(file.readAll());
+        if (img.isNull()) {
+            emit sigTileMissing(coord); // 文件损坏，重新下载
+            return;
+        }
+        emit sigTileDecoded(coord, img, timer.nsecsElapsed());
+    }, priority);
+}
+
+void TileLoader::decodeDownloaded(const TileCoord &coord, const QByteArray &data, const QString &savePath,
+                                  int priority)
+{
+    m_pool.start([this, coord, data, savePath]() {
+        QElapsedTimer timer;
+        timer.start();
+        QImage img = decodeTile(data);
+        if (img.isNull()) {
+            emit sigTileFailed(coord);
+            return;
+        }
+        qint64 decodeNs = timer.nsecsElapsed();
+
+        // 解码成功才落盘，避免把错误页面缓存成瓦片；QSaveFile 保证不会留下半个文件
+        QSaveFile file(savePath);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+            file.commit();
+        }
+        emit sigTileDecoded(coord, img, decodeNs);
+    }, priority);
+}
@@ -0,0 +1,51 @@
+#ifndef TILELOADER_H
+#define TILELOADER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QImage>
+#include <QByteArray>
+#include <QString>
+#include "radarview.h"
+#include "../Utils/tilearchive.h"
+
+// ============================================================================
+// 后台瓦片加载器
+// 磁盘读取、PNG 解码、落盘写入都在线程池中完成，结果以 QImage 排队交回 GUI 线程，
+// 由 RadarView 转成 QPixmap 上传 (QPixmap 只能在 GUI 线程创建)
+// ============================================================================
+class TileLoader : public QObject
+{
+    Q_OBJECT
+public:
+    // 线程池任务优先级：可见瓦片先于预取瓦片
+    enum Priority { PrefetchPriority = 0, VisiblePriority = 1 };
+
+    explicit TileLoader(QObject *parent = nullptr);
+    ~TileLoader();
+
+    // 打开离线瓦片包 (内存映射)，之后 loadFromArchive 直接从映射内存解码
+    bool openArchive(const QString &path);
+    bool hasArchive() const { return m_archive.isOpen(); }
+
+    // 在离线瓦片包中查找 (调用线程上一次二分查找)，命中则排队后台解码并返回 true
+    bool loadFromArchive(const TileCoord &coord, int priority = VisiblePriority);
+
+    // 读取本地缓存文件；不存在或损坏时发出 sigTileMissing
+    void loadFromDisk(const TileCoord &coord, const QString &path, int priority = VisiblePriority);
+
+    // 解码网络下载的数据，成功后写入本地缓存文件
+    void decodeDownloaded(const TileCoord &coord, const QByteArray &data, const QString &savePath,
+                          int priority = VisiblePriority);
+
+signals:
+    void sigTileDecoded(const TileCoord &coord, const QImage &image, qint64 decodeNs);
+    void sigTileMissing(const TileCoord &coord);
+    void sigTileFailed(const TileCoord &coord);
+
+private:
+    TileArchive m_archive; // 须在 m_pool 之前声明：解码任务引用其映射内存
+    QThreadPool m_pool;
+};
+
+#endif // TILELOADER_H
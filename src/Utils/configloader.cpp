@@ -30,6 +30,143 @@ void ConfigLoader::initDefaults()
     m_spoofPort = settings.value("SpoofDevice/Port", Config::DEFAULT_SPOOF_PORT).toInt();
 
     qDebug() << "[Config] 加载诱骗设备配置 IP:" << m_spoofIp << " Port:" << m_spoofPort;
+
+    // [Backend] Threaded=false 时退回单线程 (后端与界面共用事件循环，仅用于排查问题)
+    m_backendThreaded = settings.value("Backend/Threaded", true).toBool();
+
+    // [Diagnostics] 侦测->处置延迟统计，定期写入日志并导出到文件供审计
+    m_latencyReportSec = settings.value("Diagnostics/LatencyReportSec", 60).toInt();
+    m_latencyReportFile = settings.value("Diagnostics/LatencyReportFile",
+                                         QCoreApplication::applicationDirPath() + "/latency_report.txt").toString();
+
+    // [Capture] / [Replay] 原始数据流录制与回放
+    m_captureEnabled = settings.value("Capture/Enabled", false).toBool();
+    m_captureDir = settings.value("Capture/Dir", QCoreApplication::applicationDirPath() + "/captures").toString();
+    m_replayFile = settings.value("Replay/File").toString();
+    m_replaySpeed = settings.value("Replay/Speed", 1.0).toDouble();
+    m_replayLoop = settings.value("Replay/Loop", false).toBool();
+
+    // [Synthetic] 进程内合成侦测数据 (目标数/帧率/替换率/轨迹模型)
+    m_syntheticEnabled = settings.value("Synthetic/Enabled", false).toBool();
+    m_synthetic.targets = settings.value("Synthetic/Targets", m_synthetic.targets).toInt();
+    m_synthetic.images = settings.value("Synthetic/Images", m_synthetic.images).toInt();
+    m_synthetic.rateHz = settings.value("Synthetic/RateHz", m_synthetic.rateHz).toDouble();
+    m_synthetic.churnPerSec = settings.value("Synthetic/ChurnPerSec", m_synthetic.churnPerSec).toDouble();
+    m_synthetic.radiusM = settings.value("Synthetic/RadiusM", m_synthetic.radiusM).toDouble();
+    m_synthetic.trajectory = SyntheticDriver::trajectoryFromString(settings.value("Synthetic/Trajectory", "mixed").toString());
+    m_synthetic.mode = settings.value("Synthetic/Mode", "inject").toString().toLower() == "loopback"
+                           ? SyntheticDriver::Mode::Loopback : SyntheticDriver::Mode::Inject;
+    m_synthetic.port = quint16(settings.value("Synthetic/Port", m_synthetic.port).toUInt());
+    m_synthetic.seed = settings.value("Synthetic/Seed", m_synthetic.seed).toUInt();
+
+    int defaultLoopReport = m_syntheticEnabled ? 5 : 0;
+    m_eventLoopReportSec = settings.value("Diagnostics/EventLoopReportSec", defaultLoopReport).toInt();
+
+    // [ThreatPolicy] 威胁评分与处置门限，缺省值与原固定逻辑一致 (任一目标诱骗，1000 m 内压制)
+    ThreatPolicy &p = m_threatPolicy;
+    p.maxRangeM = settings.value("ThreatPolicy/MaxRangeM", p.maxRangeM).toDouble();
+    p.closingRefMps = settings.value("ThreatPolicy/ClosingRefMps", p.closingRefMps).toDouble();
+    p.altitudeRefM = settings.value("ThreatPolicy/AltitudeRefM", p.altitudeRefM).toDouble();
+    p.weightDistance = settings.value("ThreatPolicy/WeightDistance", p.weightDistance).toDouble();
+    p.weightClosing = settings.value("ThreatPolicy/WeightClosing", p.weightClosing).toDouble();
+    p.weightAltitude = settings.value("ThreatPolicy/WeightAltitude", p.weightAltitude).toDouble();
+    p.weightModel = settings.value("ThreatPolicy/WeightModel", p.weightModel).toDouble();
+    p.defaultModelWeight = settings.value("ThreatPolicy/DefaultModelWeight", p.defaultModelWeight).toDouble();
+    p.spoofScore = settings.value("ThreatPolicy/SpoofScore", p.spoofScore).toDouble();
+    p.relayDistanceM = settings.value("ThreatPolicy/RelayDistanceM", p.relayDistanceM).toDouble();
+    p.relayScore = settings.value("ThreatPolicy/RelayScore", p.relayScore).toDouble();
+    p.stopDelayMs = settings.value("ThreatPolicy/StopDelayMs", p.stopDelayMs).toInt();
+    p.weightBreach = settings.value("ThreatPolicy/WeightBreach", p.weightBreach).toDouble();
+    p.breachHorizonSec = settings.value("ThreatPolicy/BreachHorizonSec", p.breachHorizonSec).toDouble();
+    p.relayHysteresisM = settings.value("ThreatPolicy/RelayHysteresisM", p.relayHysteresisM).toDouble();
+    p.relayScoreHysteresis = settings.value("ThreatPolicy/RelayScoreHysteresis", p.relayScoreHysteresis).toDouble();
+    p.relayMinHoldMs = settings.value("ThreatPolicy/RelayMinHoldMs", p.relayMinHoldMs).toInt();
+    p.filter.alpha = settings.value("ThreatPolicy/FilterAlpha", p.filter.alpha).toDouble();
+    p.filter.beta = settings.value("ThreatPolicy/FilterBeta", p.filter.beta).toDouble();
+    p.filter.gateM = settings.value("ThreatPolicy/FilterGateM", p.filter.gateM).toDouble();
+    p.coastIntervalMs = settings.value("ThreatPolicy/CoastIntervalMs", p.coastIntervalMs).toInt();
+
+    // ModelWeights = Matrice:1.0, Mavic:0.6, ...  (逗号分隔，QSettings 读出为列表)
+    const QStringList rules = settings.value("ThreatPolicy/ModelWeights").toStringList();
+    for (const QString &rule : rules) {
+        int sep = rule.lastIndexOf(':');
+        if (sep <= 0) continue;
+        bool ok = false;
+        double weight = rule.mid(sep + 1).trimmed().toDouble(&ok);
+        if (ok) p.modelWeights.append(qMakePair(rule.left(sep).trimmed(), weight));
+    }
+
+    // [Geofence] 禁飞区 / 保护区 / 排除区，例：
+    //   size=1
+    //   1\Name=跑道
+    //   1\Type=exclusion            (nofly | protected | exclusion)
+    //   1\Points=31.2301 121.4702, 31.2312 121.4745, 31.2298 121.4751
+    //   1\WarnSec=0                 (预计进入时间不超过此值即告警，保护区默认 60)
+    m_geofenceCellM = settings.value("Geofence/CellM", 250.0).toDouble();
+    int zoneCount = settings.beginReadArray("Geofence");
+    for (int i = 0; i < zoneCount; ++i) {
+        settings.setArrayIndex(i);
+        Geofence::Zone zone;
+        zone.name = settings.value("Name", QString("区域%1").arg(i + 1)).toString();
+        zone.type = Geofence::typeFromString(settings.value("Type", "nofly").toString());
+        zone.warnSec = settings.value("WarnSec", zone.type == Geofence::ZoneType::Protected ? 60.0 : 0.0).toDouble();
+
+        // 每个点 "纬度 经度"，点之间逗号分隔
+        const QStringList points = settings.value("Points").toStringList();
+        for (const QString &point : points) {
+            const QStringList ll = point.split(' ', Qt::SkipEmptyParts);
+            if (ll.size() == 2) zone.points.append(QPointF(ll.at(1).toDouble(), ll.at(0).toDouble()));
+        }
+        if (zone.points.size() >= 3) {
+            m_geofenceZones.append(zone);
+        } else {
+            qDebug() << "[Config] 围栏区域点数不足，已忽略:" << zone.name;
+        }
+    }
+    settings.endArray();
+
+    // [Relay] 继电器板路数 (1-32)、帧格式 (rtu = RTU over TCP 带 CRC | tcp = Modbus TCP) 与站号
+    m_relay.channels = settings.value("Relay/Channels", m_relay.channels).toInt();
+    m_relay.framing = ModbusCodec::framingFromString(settings.value("Relay/Protocol", "rtu").toString());
+    m_relay.unit = quint8(settings.value("Relay/Unit", m_relay.unit).toUInt());
+
+    // [Detection] 断线重连从 ReconnectMinMs 起指数退避至 ReconnectMaxMs；
+    // StaleGraceMs 内保留最后已知目标 (界面标记为过时)，超时仍未恢复才清除
+    m_detection.reconnectMinMs = settings.value("Detection/ReconnectMinMs", m_detection.reconnectMinMs).toInt();
+    m_detection.reconnectMaxMs = settings.value("Detection/ReconnectMaxMs", m_detection.reconnectMaxMs).toInt();
+    m_detection.staleGraceMs = settings.value("Detection/StaleGraceMs", m_detection.staleGraceMs).toInt();
+    m_fusionWindowMs = settings.value("Detection/FusionWindowMs", 3000).toLongLong();
+
+    // [DetectionSources] 多块侦测板同时接入，上报经融合后进入航迹库，例：
+    //   size=2
+    //   1\Name=北塔
+    //   1\Type=socketio
+    //   1\Url=ws://192.178.1.12:8090/socket.io/?EIO=3&transport=websocket
+    //   2\Name=南塔
+    //   2\Url=ws://192.178.1.13:8090/socket.io/?EIO=3&transport=websocket
+    // 旧版侦测板 (TCP 帧协议，板子主动连入) 用 Type=tcp，Url 为本机监听地址：
+    //   3\Type=tcp
+    //   3\Url=tcp://:8089
+    // 编号最小的数据源视为与基站同址 (融合结果的距离/方位取自它)
+    int sourceCount = settings.beginReadArray("DetectionSources");
+    for (int i = 0; i < sourceCount; ++i) {
+        settings.setArrayIndex(i);
+        DetectionSource::Config source;
+        source.name = settings.value("Name", sourceCount > 1 ? QString("侦测%1").arg(i + 1) : QString()).toString();
+        source.url = settings.value("Url").toString();
+        QString type = settings.value("Type", "socketio").toString();
+        if (!DetectionSource::typeFromString(type, source.type) || source.url.isEmpty()) {
+            qDebug() << "[Config] 侦测数据源配置无效，已忽略:" << source.name << type << source.url;
+            continue;
+        }
+        m_detectionSources.append(source);
+    }
+    settings.endArray();
+    if (m_detectionSources.isEmpty()) {
+        DetectionSource::Config source;
+        source.url = "ws://192.178.1.12:8090/socket.io/?EIO=3&transport=websocket";
+        m_detectionSources.append(source);
+    }
 }
 
 QString ConfigLoader::getSpoofIp() const
@@ -41,3 +178,93 @@ int ConfigLoader::getSpoofPort() const
 {
     return m_spoofPort;
 }
+
+bool ConfigLoader::isBackendThreaded() const
+{
+    return m_backendThreaded;
+}
+
+int ConfigLoader::latencyReportSec() const
+{
+    return m_latencyReportSec;
+}
+
+QString ConfigLoader::latencyReportFile() const
+{
+    return m_latencyReportFile;
+}
+
+bool ConfigLoader::isCaptureEnabled() const
+{
+    return m_captureEnabled;
+}
+
+QString ConfigLoader::captureDir() const
+{
+    return m_captureDir;
+}
+
+QString ConfigLoader::replayFile() const
+{
+    return m_replayFile;
+}
+
+double ConfigLoader::replaySpeed() const
+{
+    return m_replaySpeed;
+}
+
+bool ConfigLoader::isReplayLoop() const
+{
+    return m_replayLoop;
+}
+
+bool ConfigLoader::isSyntheticEnabled() const
+{
+    return m_syntheticEnabled;
+}
+
+SyntheticDriver::Settings ConfigLoader::syntheticSettings() const
+{
+    return m_synthetic;
+}
+
+int ConfigLoader::eventLoopReportSec() const
+{
+    return m_eventLoopReportSec;
+}
+
+ThreatPolicy ConfigLoader::threatPolicy() const
+{
+    return m_threatPolicy;
+}
+
+QList<Geofence::Zone> ConfigLoader::geofenceZones() const
+{
+    return m_geofenceZones;
+}
+
+double ConfigLoader::geofenceCellM() const
+{
+    return m_geofenceCellM;
+}
+
+RelayDriver::Settings ConfigLoader::relaySettings() const
+{
+    return m_relay;
+}
+
+DetectionSource::Settings ConfigLoader::detectionSettings() const
+{
+    return m_detection;
+}
+
+QList<DetectionSource::Config> ConfigLoader::detectionSources() const
+{
+    return m_detectionSources;
+}
+
+qint64 ConfigLoader::fusionWindowMs() const
+{
+    return m_fusionWindowMs;
+}
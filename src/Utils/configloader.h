@@ -4,6 +4,10 @@
 #include <QObject>
 #include <QSettings>
 #include <QString>
+#include "../Backend/Drivers/syntheticdriver.h"
+#include "../Backend/threatengine.h"
+#include "../Backend/Drivers/relaydriver.h"
+#include "../Backend/Drivers/detectionsource.h"
 
 class ConfigLoader : public QObject
 {
@@ -15,10 +19,68 @@ public:
     QString getSpoofIp() const;
     int getSpoofPort() const;
 
+    // 后端 (DeviceManager + 驱动) 是否运行在独立线程，默认开启
+    bool isBackendThreaded() const;
+
+    // 延迟统计：定期输出间隔 (秒，0 = 关闭) 与导出文件路径
+    int latencyReportSec() const;
+    QString latencyReportFile() const;
+
+    // 录制：开启后把侦测帧/诱骗数据报/继电器收发写入 <目录>/capture_时间.dsrec
+    bool isCaptureEnabled() const;
+    QString captureDir() const;
+
+    // 回放：文件非空时用录制文件代替侦测 WebSocket 与诱骗上报 (速度 0 = 最快)
+    QString replayFile() const;
+    double replaySpeed() const;
+    bool isReplayLoop() const;
+
+    // 合成数据源 (压力测试)：开启后代替侦测 WebSocket
+    bool isSyntheticEnabled() const;
+    SyntheticDriver::Settings syntheticSettings() const;
+
+    // 事件循环利用率汇报间隔 (秒，0 = 关闭；合成数据源开启时默认 5 秒)
+    int eventLoopReportSec() const;
+
+    // 自动决策策略：威胁评分权重、诱骗/压制门限、停止防御延时
+    ThreatPolicy threatPolicy() const;
+
+    // 电子围栏区域 ([Geofence] 数组) 与网格索引格子边长 (米)
+    QList<Geofence::Zone> geofenceZones() const;
+    double geofenceCellM() const;
+
+    // 继电器 Modbus 参数 (路数 / 帧格式 / 站号)
+    RelayDriver::Settings relaySettings() const;
+
+    // 侦测链路重连退避与断线宽限期 (ms)
+    DetectionSource::Settings detectionSettings() const;
+    // 侦测数据源列表 ([DetectionSources] 数组；未配置时为单一默认源)
+    QList<DetectionSource::Config> detectionSources() const;
+    // 多数据源融合：各数据源报告参与位置合并的有效期 (ms)
+    qint64 fusionWindowMs() const;
+
 private:
     void initDefaults(); // 如果文件不存在，写入默认值
     QString m_spoofIp;
     int m_spoofPort;
+    bool m_backendThreaded;
+    int m_latencyReportSec;
+    QString m_latencyReportFile;
+    bool m_captureEnabled;
+    QString m_captureDir;
+    QString m_replayFile;
+    double m_replaySpeed;
+    bool m_replayLoop;
+    bool m_syntheticEnabled;
+    SyntheticDriver::Settings m_synthetic;
+    int m_eventLoopReportSec;
+    ThreatPolicy m_threatPolicy;
+    QList<Geofence::Zone> m_geofenceZones;
+    double m_geofenceCellM;
+    RelayDriver::Settings m_relay;
+    DetectionSource::Settings m_detection;
+    QList<DetectionSource::Config> m_detectionSources;
+    qint64 m_fusionWindowMs;
 };
 
 #endif // CONFIGLOADER_H
@@ -1,5 +1,44 @@
 #include "crcutils.h"
+#include <array>
 
-CrcUtils::CrcUtils(QObject *parent)
-    : QObject{parent}
-{}
+namespace {
+constexpr std::array<quint16, 256> makeModbusTable()
+{
+    std::array<quint16, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        quint16 crc = quint16(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? quint16((crc >> 1) ^ 0xA001) : quint16(crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<quint16, 256> MODBUS_TABLE = makeModbusTable();
+}
+
+quint16 CrcUtils::modbus(const char *data, qsizetype size)
+{
+    quint16 crc = 0xFFFF;
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    for (qsizetype i = 0; i < size; ++i) {
+        crc = quint16((crc >> 8) ^ MODBUS_TABLE[(crc ^ p[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+void CrcUtils::appendModbus(QByteArray &frame)
+{
+    quint16 crc = modbus(frame);
+    frame.append(char(crc & 0xFF));
+    frame.append(char(crc >> 8));
+}
+
+bool CrcUtils::checkModbus(const char *frame, qsizetype size)
+{
+    if (size < 3) return false;
+    quint16 crc = modbus(frame, size - 2);
+    const uchar *tail = reinterpret_cast<const uchar *>(frame + size - 2);
+    return tail[0] == (crc & 0xFF) && tail[1] == (crc >> 8);
+}
@@ -1,15 +1,25 @@
 #ifndef CRCUTILS_H
 #define CRCUTILS_H
 
-#include <QObject>
+#include <QByteArray>
+#include <QtGlobal>
 
-class CrcUtils : public QObject
+// ============================================================================
+// 校验工具
+//
+// CRC-16/MODBUS：多项式 0x8005 (反射 0xA001)，初值 0xFFFF，帧尾低字节在前。
+// 按字节查表 (256 项表编译期生成)，每字节一次查表 + 移位。
+// ============================================================================
+class CrcUtils
 {
-    Q_OBJECT
 public:
-    explicit CrcUtils(QObject *parent = nullptr);
+    static quint16 modbus(const char *data, qsizetype size);
+    static quint16 modbus(const QByteArray &data) { return modbus(data.constData(), data.size()); }
 
-signals:
+    // 在帧尾追加 CRC (低字节在前)
+    static void appendModbus(QByteArray &frame);
+    // 校验帧尾 CRC (帧长至少 3 字节)
+    static bool checkModbus(const char *frame, qsizetype size);
 };
 
 #endif // CRCUTILS_H
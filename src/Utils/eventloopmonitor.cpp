@@ -0,0 +1,84 @@
+#include "eventloopmonitor.h"
+#include <QAbstractEventDispatcher>
+#include <QThread>
+
+namespace {
+const int PROBE_INTERVAL_MS = 20;
+}
+
+EventLoopMonitor::EventLoopMonitor(const QString &name, QObject *parent)
+    : QObject(parent), m_name(name)
+{
+    m_probeTimer = new QTimer(this);
+    m_probeTimer->setTimerType(Qt::PreciseTimer);
+    m_probeTimer->setInterval(PROBE_INTERVAL_MS);
+    connect(m_probeTimer, &QTimer::timeout, this, &EventLoopMonitor::onProbe);
+
+    m_reportTimer = new QTimer(this);
+    connect(m_reportTimer, &QTimer::timeout, this, &EventLoopMonitor::onReport);
+
+    if (QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(thread())) {
+        connect(dispatcher, &QAbstractEventDispatcher::awake, this, &EventLoopMonitor::onAwake);
+        connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, &EventLoopMonitor::onAboutToBlock);
+    }
+}
+
+void EventLoopMonitor::start(int reportIntervalMs)
+{
+    m_clock.start();
+    m_busy = true;
+    m_busySinceNs = 0;
+    m_busyNs = 0;
+    m_windowStartNs = 0;
+    m_lastProbeNs = 0;
+    m_maxLagNs = 0;
+
+    m_probeTimer->start();
+    m_reportTimer->start(reportIntervalMs);
+}
+
+void EventLoopMonitor::stop()
+{
+    m_probeTimer->stop();
+    m_reportTimer->stop();
+}
+
+void EventLoopMonitor::onAwake()
+{
+    if (m_busy) return;
+    m_busy = true;
+    m_busySinceNs = m_clock.nsecsElapsed();
+}
+
+void EventLoopMonitor::onAboutToBlock()
+{
+    if (!m_busy) return;
+    m_busy = false;
+    m_busyNs += m_clock.nsecsElapsed() - m_busySinceNs;
+}
+
+void EventLoopMonitor::onProbe()
+{
+    qint64 now = m_clock.nsecsElapsed();
+    if (m_lastProbeNs > 0) {
+        qint64 lag = now - m_lastProbeNs - PROBE_INTERVAL_MS * 1000000LL;
+        if (lag > m_maxLagNs) m_maxLagNs = lag;
+    }
+    m_lastProbeNs = now;
+}
+
+void EventLoopMonitor::onReport()
+{
+    qint64 now = m_clock.nsecsElapsed();
+    qint64 busy = m_busyNs;
+    if (m_busy) busy += now - m_busySinceNs; // 当前仍在忙碌的部分
+
+    qint64 window = now - m_windowStartNs;
+    double utilization = window > 0 ? qBound(0.0, double(busy) / double(window), 1.0) : 0.0;
+    emit sigReport(m_name, utilization, m_maxLagNs / 1e6);
+
+    m_windowStartNs = now;
+    m_busyNs = 0;
+    m_busySinceNs = now;
+    m_maxLagNs = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// ============================================================================
+// 事件循环利用率监视
+// 必须在被监视的线程中创建。通过事件分发器的 awake/aboutToBlock 统计
+// 线程忙碌时间占比，另用一个固定间隔的探测定时器测量事件处理延迟
+// (定时器实际触发时刻 - 预期时刻)，两者按周期汇报
+// ============================================================================
+class EventLoopMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EventLoopMonitor(const QString &name, QObject *parent = nullptr);
+
+    void start(int reportIntervalMs);
+    void stop();
+
+signals:
+    // utilization: 0~1；maxLagMs: 本周期探测定时器的最大延迟
+    void sigReport(const QString &name, double utilization, double maxLagMs);
+
+private slots:
+    void onAwake();
+    void onAboutToBlock();
+    void onProbe();
+    void onReport();
+
+private:
+    QString m_name;
+    QTimer *m_probeTimer;
+    QTimer *m_reportTimer;
+    QElapsedTimer m_clock;
+
+    bool m_busy = true;
+    qint64 m_busySinceNs = 0;
+    qint64 m_busyNs = 0;
+    qint64 m_windowStartNs = 0;
+
+    qint64 m_lastProbeNs = 0;
+    qint64 m_maxLagNs = 0;
+};
+
+#endif // EVENTLOOPMONITOR_H
@@ -0,0 +1,54 @@
+#include "geodesy.h"
+#include "../Backend/Consts.h"
+#include <QtMath>
+
+namespace Geodesy {
+
+void LocalProjection::setOrigin(double lat, double lng)
+{
+    m_originLat = lat;
+    m_originLng = lng;
+    m_metersPerDegLat = Config::DEG_TO_RAD * Config::EARTH_RADIUS;
+    m_metersPerDegLng = m_metersPerDegLat * std::cos(lat * Config::DEG_TO_RAD);
+    m_valid = true;
+}
+
+void LocalProjection::toLocal(const double *lat, const double *lng, double *east, double *north,
+                              qsizetype count) const
+{
+    const double lat0 = m_originLat, lng0 = m_originLng;
+    const double kLat = m_metersPerDegLat, kLng = m_metersPerDegLng;
+    for (qsizetype i = 0; i < count; ++i) {
+        east[i] = (lng[i] - lng0) * kLng;
+        north[i] = (lat[i] - lat0) * kLat;
+    }
+}
+
+namespace Mercator {
+
+namespace {
+const double INV_2PI = 1.0 / (2.0 * M_PI);
+}
+
+QPointF toWorld(double lat, double lng)
+{
+    return QPointF((lng + 180.0) / 360.0, 0.5 - std::asinh(std::tan(lat * Config::DEG_TO_RAD)) * INV_2PI);
+}
+
+QPointF toGeo(double x, double y)
+{
+    double latRad = std::atan(std::sinh(M_PI * (1.0 - 2.0 * y)));
+    return QPointF(x * 360.0 - 180.0, latRad / Config::DEG_TO_RAD);
+}
+
+void toWorld(const double *lat, const double *lng, double *x, double *y, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        x[i] = (lng[i] + 180.0) * (1.0 / 360.0);
+        y[i] = 0.5 - std::asinh(std::tan(lat[i] * Config::DEG_TO_RAD)) * INV_2PI;
+    }
+}
+
+}
+
+}
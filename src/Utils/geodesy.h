@@ -0,0 +1,63 @@
+#ifndef GEODESY_H
+#define GEODESY_H
+
+#include <QPointF>
+#include <QtGlobal>
+
+// ============================================================================
+// 公共坐标换算
+//
+// LocalProjection：以基站为原点的局部切平面 (东, 北，单位米)。原点确定后
+// 每度对应的米数只算一次，单点换算只剩乘加，几十公里范围内误差可忽略。
+// Mercator：Web 墨卡托归一化坐标 (0~1)，与缩放级别无关；瓦片坐标 = 归一化坐标 * 2^z。
+//
+// 批量接口以平行数组 (SoA) 输入输出，循环体无分支，便于编译器向量化；
+// 决策、围栏、绘制每帧对每个目标只换算一次，结果各自缓存复用。
+// ============================================================================
+namespace Geodesy {
+
+class LocalProjection
+{
+public:
+    LocalProjection() = default;
+    LocalProjection(double originLat, double originLng) { setOrigin(originLat, originLng); }
+
+    void setOrigin(double lat, double lng);
+    bool isValid() const { return m_valid; }
+    double originLat() const { return m_originLat; }
+    double originLng() const { return m_originLng; }
+
+    // 经纬度 -> 本地 (x = 东, y = 北)
+    QPointF toLocal(double lat, double lng) const
+    {
+        return QPointF((lng - m_originLng) * m_metersPerDegLng, (lat - m_originLat) * m_metersPerDegLat);
+    }
+
+    // 本地 -> 经纬度 (x = 经度, y = 纬度)
+    QPointF toGeo(double east, double north) const
+    {
+        return QPointF(m_originLng + east / m_metersPerDegLng, m_originLat + north / m_metersPerDegLat);
+    }
+
+    void toLocal(const double *lat, const double *lng, double *east, double *north, qsizetype count) const;
+
+private:
+    bool m_valid = false;
+    double m_originLat = 0.0;
+    double m_originLng = 0.0;
+    double m_metersPerDegLat = 0.0;
+    double m_metersPerDegLng = 0.0;
+};
+
+namespace Mercator {
+// 经纬度 -> 归一化墨卡托坐标 (x 向东、y 向南，均为 0~1)
+QPointF toWorld(double lat, double lng);
+// 归一化墨卡托坐标 -> 经纬度 (x = 经度, y = 纬度)
+QPointF toGeo(double x, double y);
+
+void toWorld(const double *lat, const double *lng, double *x, double *y, qsizetype count);
+}
+
+}
+
+#endif // GEODESY_H
@@ -0,0 +1,177 @@
+#include "tilearchive.h"
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char ARCHIVE_MAGIC[8] = {'D', 'S', 'T', 'I', 'L', 'E', 'S', '1'};
+const quint32 ARCHIVE_VERSION = 1;
+const int HEADER_SIZE = 32;
+const int INDEX_ENTRY_SIZE = 24;
+
+void writeHeader(uchar *buf, quint32 count, quint64 indexOffset)
+{
+    std::memset(buf, 0, HEADER_SIZE);
+    std::memcpy(buf, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    qToLittleEndian<quint32>(ARCHIVE_VERSION, buf + 8);
+    qToLittleEndian<quint32>(count, buf + 12);
+    qToLittleEndian<quint64>(indexOffset, buf + 16);
+}
+}
+
+// ============================================================================
+// 读取
+// ============================================================================
+TileArchive::~TileArchive()
+{
+    close();
+}
+
+bool TileArchive::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    qint64 fileSize = m_file.size();
+    if (fileSize < HEADER_SIZE) {
+        qWarning() << "[TileArchive] 文件过小:" << path;
+        close();
+        return false;
+    }
+
+    uchar *base = m_file.map(0, fileSize);
+    if (!base) {
+        qWarning() << "[TileArchive] 内存映射失败:" << path << m_file.errorString();
+        close();
+        return false;
+    }
+
+    quint32 version = qFromLittleEndian<quint32>(base + 8);
+    quint32 count = qFromLittleEndian<quint32>(base + 12);
+    quint64 indexOffset = qFromLittleEndian<quint64>(base + 16);
+
+    if (std::memcmp(base, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || version != ARCHIVE_VERSION
+        || indexOffset < quint64(HEADER_SIZE)
+        || indexOffset + quint64(count) * INDEX_ENTRY_SIZE > quint64(fileSize)) {
+        qWarning() << "[TileArchive] 文件头无效:" << path;
+        close();
+        return false;
+    }
+
+    m_base = base;
+    m_index = base + indexOffset;
+    m_dataEnd = indexOffset;
+    m_count = count;
+    qDebug() << "[TileArchive] 已加载离线瓦片包:" << path << "瓦片数:" << m_count;
+    return true;
+}
+
+void TileArchive::close()
+{
+    if (m_base) m_file.unmap(const_cast<uchar *>(m_base));
+    m_file.close();
+    m_base = nullptr;
+    m_index = nullptr;
+    m_dataEnd = 0;
+    m_count = 0;
+}
+
+QByteArrayView TileArchive::find(quint64 key) const
+{
+    // 索引按 key 升序，直接在映射内存上二分
+    quint32 lo = 0;
+    quint32 hi = m_count;
+    while (lo < hi) {
+        quint32 mid = lo + (hi - lo) / 2;
+        const uchar *entry = m_index + qsizetype(mid) * INDEX_ENTRY_SIZE;
+        quint64 k = qFromLittleEndian<quint64>(entry);
+        if (k < key) {
+            lo = mid + 1;
+        } else if (k > key) {
+            hi = mid;
+        } else {
+            quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+            quint32 size = qFromLittleEndian<quint32>(entry + 16);
+            // 索引项损坏 (越出数据区) 按不存在处理，由调用方回退到网络下载
+            if (offset < quint64(HEADER_SIZE) || offset > m_dataEnd || size > m_dataEnd - offset) {
+                return QByteArrayView();
+            }
+            return QByteArrayView(m_base + offset, qsizetype(size));
+        }
+    }
+    return QByteArrayView();
+}
+
+// ============================================================================
+// 写入
+// ============================================================================
+TileArchiveWriter::TileArchiveWriter(const QString &path)
+    : m_file(path)
+{
+}
+
+bool TileArchiveWriter::begin()
+{
+    if (!m_file.open(QIODevice::WriteOnly)) return false;
+
+    // 先占位文件头，finish() 时回填
+    uchar header[HEADER_SIZE];
+    writeHeader(header, 0, 0);
+    if (m_file.write(reinterpret_cast<const char *>(header), HEADER_SIZE) != HEADER_SIZE) return false;
+
+    m_entries.clear();
+    m_writePos = HEADER_SIZE;
+    return true;
+}
+
+bool TileArchiveWriter::addTile(quint64 key, QByteArrayView data)
+{
+    if (data.isEmpty()) return false;
+    if (m_file.write(data.data(), data.size()) != data.size()) return false;
+
+    m_entries.append({key, m_writePos, quint32(data.size())});
+    m_writePos += quint64(data.size());
+    return true;
+}
+
+bool TileArchiveWriter::finish()
+{
+    // 稳定排序后同 key 只保留最后写入的一条
+    std::stable_sort(m_entries.begin(), m_entries.end(),
+                     [](const Entry &a, const Entry &b) { return a.key < b.key; });
+    QList<Entry> unique;
+    unique.reserve(m_entries.size());
+    for (const Entry &e : m_entries) {
+        if (!unique.isEmpty() && unique.last().key == e.key) unique.last() = e;
+        else unique.append(e);
+    }
+
+    QByteArray index(unique.size() * INDEX_ENTRY_SIZE, '\0');
+    uchar *p = reinterpret_cast<uchar *>(index.data());
+    for (const Entry &e : unique) {
+        qToLittleEndian<quint64>(e.key, p);
+        qToLittleEndian<quint64>(e.offset, p + 8);
+        qToLittleEndian<quint32>(e.size, p + 16);
+        p += INDEX_ENTRY_SIZE;
+    }
+
+    quint64 indexOffset = m_writePos;
+    if (m_file.write(index) != index.size()) return false;
+
+    uchar header[HEADER_SIZE];
+    writeHeader(header, quint32(unique.size()), indexOffset);
+    if (!m_file.seek(0)) return false;
+    if (m_file.write(reinterpret_cast<const char *>(header), HEADER_SIZE) != HEADER_SIZE) return false;
+
+    m_entries = unique;
+    return m_file.commit();
+}
+
+void TileArchiveWriter::cancel()
+{
+    m_file.cancelWriting();
+    m_entries.clear();
+}
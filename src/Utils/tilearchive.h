@@ -0,0 +1,79 @@
+#ifndef TILEARCHIVE_H
+#define TILEARCHIVE_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+// ============================================================================
+// 离线瓦片包 (单文件，内存映射)
+//
+// 文件布局 (小端):
+//   [Header 32B] magic "DSTILES1" | version u32 | count u32 | indexOffset u64 | reserved u64
+//   [瓦片数据]   PNG/JPG 原始字节依次排列
+//   [Index]      count 个 {key u64, offset u64, size u32, reserved u32}，按 key 升序
+//
+// key 即 TileCoord::key() (z|x|y 打包)。读取时整个文件只 open/map 一次，
+// 查瓦片是对映射内存做二分查找，没有逐瓦片的文件系统访问。
+// 映射是只读的，多个线程可同时调用 find()。
+// ============================================================================
+class TileArchive
+{
+public:
+    TileArchive() = default;
+    ~TileArchive();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_index != nullptr; }
+
+    int tileCount() const { return int(m_count); }
+    QString path() const { return m_file.fileName(); }
+
+    // 返回瓦片原始字节 (指向映射内存，archive 关闭前有效)；不存在时返回空 view
+    QByteArrayView find(quint64 key) const;
+    bool contains(quint64 key) const { return !find(key).isNull(); }
+
+private:
+    Q_DISABLE_COPY(TileArchive)
+
+    QFile m_file;
+    const uchar *m_base = nullptr;
+    const uchar *m_index = nullptr;
+    quint64 m_dataEnd = 0; // 瓦片数据区结束位置 (= 索引起始)，find() 据此校验索引项
+    quint32 m_count = 0;
+};
+
+// ============================================================================
+// 离线瓦片包写入 (供预下载/导入工具使用)
+// 数据直接顺序追加，finish() 时排序写出索引并回填文件头；
+// 同一 key 重复写入时以最后一次为准
+// ============================================================================
+class TileArchiveWriter
+{
+public:
+    explicit TileArchiveWriter(const QString &path);
+
+    bool begin();
+    bool addTile(quint64 key, QByteArrayView data);
+    bool finish();
+    void cancel();
+
+    int tileCount() const { return m_entries.size(); }
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    struct Entry {
+        quint64 key;
+        quint64 offset;
+        quint32 size;
+    };
+
+    QSaveFile m_file;
+    QList<Entry> m_entries;
+    quint64 m_writePos = 0;
+};
+
+#endif // TILEARCHIVE_H
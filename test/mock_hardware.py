@@ -20,6 +20,7 @@ def get_direction_name(angle):
         return str(angle)
 
 def run_udp_server():
+    pa_switch = 0  # 射频开关实际状态，随 602 指令变化并在 600 状态中回报
     sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
     sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
     
@@ -51,7 +52,8 @@ def run_udp_server():
                     if code == "601":
                         print(f"   📍 [位置] Lat: {obj.get('dbLat')}, Lon: {obj.get('dbLon')}, Alt: {obj.get('dbAlt')}")
                     elif code == "602":
-                        state = "🟢 开启 (ON)" if obj.get('iSwitch') == 1 else "🔴 关闭 (OFF)"
+                        pa_switch = 1 if obj.get('iSwitch') == 1 else 0
+                        state = "🟢 开启 (ON)" if pa_switch == 1 else "🔴 关闭 (OFF)"
                         print(f"   ⚡️ [开关] {state}")
                     elif code == "603":
                         val = list(obj.values())[-1]
@@ -71,7 +73,7 @@ def run_udp_server():
                     elif code == "619":
                         print(f"   👋 [登录] 上报本机: {obj.get('sIP')}:{obj.get('iPort')}")
 
-                    reply_content = '{"iSysSta": 3, "iOcxoSta": 3, "iPASwitch": 1}'
+                    reply_content = f'{{"iSysSta": 3, "iOcxoSta": 3, "iPASwitch": {pa_switch}}}'
                     reply_len = str(len(reply_content)).zfill(4)
                     reply_packet = f"FF{reply_len}600{reply_content}"
                     sock.sendto(reply_packet.encode(), addr)
@@ -2,6 +2,8 @@ import asyncio
 import socketio
 from aiohttp import web
 import json
+import struct
+import zlib
 import random
 import time
 import datetime
@@ -13,7 +15,10 @@ import datetime
 current_distance = 1000.0  
 is_jamming = False         
 is_spoofing = False        
+relay_coils = 0            # 继电器线圈状态 (bit0 = 通道 1)
 uav_id = "1636J1400AAXML"  # 模拟 Mavic 2 ID
+# 侦测载荷格式: text = 42 文本事件; binary = UTF-8 JSON 二进制附件; zlib = qCompress 格式附件
+PAYLOAD_MODE = "text"
 
 # 基地坐标 (西安大华)
 BASE_LAT = 34.218146
@@ -23,6 +28,16 @@ BASE_LON = 108.834316
 def get_time():
     return datetime.datetime.now().strftime("%H:%M:%S.%f")[:-3]
 
+# 辅助函数：按 PAYLOAD_MODE 编码侦测事件数据 (bytes 由 python-socketio 作为二进制附件发送)
+def encode_payload(data):
+    if PAYLOAD_MODE == "text":
+        return data
+    raw = json.dumps(data, separators=(',', ':')).encode('utf-8')
+    if PAYLOAD_MODE == "zlib":
+        # 与 qUncompress 对应：4 字节大端原始长度 + zlib 流
+        return struct.pack('>I', len(raw)) + zlib.compress(raw)
+    return raw
+
 # ==========================================
 # 1. Socket.IO Server Setup
 # ==========================================
@@ -102,6 +117,43 @@ class UdpProtocol:
 # ==========================================
 # 4. TCP Server (继电器压制模拟 - 接收 TCP Hex)
 # ==========================================
+def modbus_crc(frame):
+    crc = 0xFFFF
+    for b in frame:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return bytes([crc & 0xFF, crc >> 8])
+
+def relay_reply(frame):
+    """按 Modbus RTU 应答: 写指令回显，读线圈返回当前状态"""
+    global relay_coils
+    if len(frame) < 8:
+        return b''
+    fc = frame[1]
+    addr = (frame[2] << 8) | frame[3]
+    if fc == 0x05:
+        if frame[4] == 0xFF:
+            relay_coils |= (1 << addr)
+        else:
+            relay_coils &= ~(1 << addr)
+        return frame[:8]
+    if fc == 0x0F:
+        count = (frame[4] << 8) | frame[5]
+        nbytes = frame[6]
+        value = int.from_bytes(frame[7:7 + nbytes], 'little')
+        mask = ((1 << count) - 1) << addr
+        relay_coils = (relay_coils & ~mask) | ((value << addr) & mask)
+        head = frame[:6]
+        return head + modbus_crc(head)
+    if fc == 0x01:
+        count = (frame[4] << 8) | frame[5]
+        nbytes = (count + 7) // 8
+        value = (relay_coils >> addr) & ((1 << count) - 1)
+        body = bytes([frame[0], 0x01, nbytes]) + value.to_bytes(nbytes, 'little')
+        return body + modbus_crc(body)
+    return b''
+
 async def handle_relay_client(reader, writer):
     addr = writer.get_extra_info('peername')
     print(f"[{get_time()}] [RELAY] TCP 连接建立: {addr}")
@@ -127,6 +179,11 @@ async def handle_relay_client(reader, writer):
             elif hex_str.startswith("FE05"):
                 print("   >>> 解析: 单通道控制")
 
+            reply = relay_reply(data)
+            if reply:
+                writer.write(reply)
+                await writer.drain()
+
     except Exception as e:
         print(f"[RELAY Error] {e}")
     finally:
@@ -179,7 +236,7 @@ async def simulation_loop():
                     "type": "drone"
                 }
             }]
-            await sio.emit('droneStatus', drone_data)
+            await sio.emit('droneStatus', encode_payload(drone_data))
             
             image_data = [{
                 "id": "5800_fpv",
@@ -189,7 +246,7 @@ async def simulation_loop():
                 "mes": int(time.time() * 1000),
                 "first": 0
             }]
-            await sio.emit('imageStatus', image_data)
+            await sio.emit('imageStatus', encode_payload(image_data))
             await sio.emit('detect_batch', [len(drone_data) + len(image_data)])
             await sio.emit('info', {'lat': BASE_LAT, 'lng': BASE_LON})
 
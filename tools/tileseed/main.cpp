@@ -0,0 +1,246 @@
+// ============================================================================
+// DroneShield_TileSeed - 离线瓦片包预下载/导入工具
+//
+// 用法示例:
+//   DroneShield_TileSeed --out img_w.tiles --bbox 34.10,108.70,34.35,109.00 --zoom 10-17 --key <天地图key>
+//   DroneShield_TileSeed --out img_w.tiles --from-dir ~/.droneshield_cache/tiles_cache --offline
+//
+// 生成的文件放到 RadarView 缓存目录下 (<缓存目录>/<图层>.tiles) 即可离线使用
+// ============================================================================
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QQueue>
+#include <QtMath>
+#include <QTextStream>
+#include <cmath>
+#include <functional>
+#include "../../src/UI/tilecoord.h"
+#include "../../src/Utils/tilearchive.h"
+
+namespace {
+
+const int MAX_ZOOM = 18;
+const int MAX_RETRY = 2;
+const double PI = 3.14159265358979323846;
+
+struct BBox {
+    double minLat, minLng, maxLat, maxLng;
+};
+
+QTextStream &out()
+{
+    static QTextStream s(stdout);
+    return s;
+}
+
+int lngToTileX(double lng, int z)
+{
+    int n = 1 << z;
+    int x = int(std::floor((lng + 180.0) / 360.0 * n));
+    return qBound(0, x, n - 1);
+}
+
+int latToTileY(double lat, int z)
+{
+    int n = 1 << z;
+    double latRad = qDegreesToRadians(qBound(-85.05112878, lat, 85.05112878));
+    int y = int(std::floor((1.0 - std::asinh(std::tan(latRad)) / PI) / 2.0 * n));
+    return qBound(0, y, n - 1);
+}
+
+// 天地图在 key 无效/限流时返回 XML 或 HTML，只接受真正的图片数据
+bool looksLikeImage(const QByteArray &data)
+{
+    return data.startsWith("\x89PNG") || data.startsWith("\xFF\xD8");
+}
+
+QString tileUrl(const QString &layer, const QString &key, const TileCoord &c)
+{
+    int serverNode = (c.x + c.y) % 8;
+    return QString("http://t%1.tianditu.gov.cn/DataServer?T=%2&x=%3&y=%4&l=%5&tk=%6")
+        .arg(serverNode).arg(layer).arg(c.x).arg(c.y).arg(c.z).arg(key);
+}
+
+bool parseBBox(const QString &text, BBox &box)
+{
+    const QStringList parts = text.split(',');
+    if (parts.size() != 4) return false;
+    bool ok[4];
+    box = {parts[0].toDouble(&ok[0]), parts[1].toDouble(&ok[1]),
+           parts[2].toDouble(&ok[2]), parts[3].toDouble(&ok[3])};
+    if (!(ok[0] && ok[1] && ok[2] && ok[3])) return false;
+    if (box.minLat > box.maxLat) std::swap(box.minLat, box.maxLat);
+    if (box.minLng > box.maxLng) std::swap(box.minLng, box.maxLng);
+    return true;
+}
+
+bool parseZoom(const QString &text, int &zMin, int &zMax)
+{
+    const QStringList parts = text.split('-');
+    bool ok1 = false, ok2 = true;
+    zMin = parts.value(0).toInt(&ok1);
+    zMax = parts.size() > 1 ? parts.value(1).toInt(&ok2) : zMin;
+    return ok1 && ok2 && zMin >= 0 && zMax <= MAX_ZOOM && zMin <= zMax;
+}
+
+// 导入 RadarView 的逐文件缓存 (文件名: <图层>_<z>_<x>_<y>.png)
+int importDirectory(const QString &dirPath, const QString &layer, TileArchiveWriter &writer,
+                    QSet<quint64> &have)
+{
+    QDir dir(dirPath);
+    const QStringList files = dir.entryList({layer + "_*.png"}, QDir::Files);
+    int imported = 0;
+    for (const QString &name : files) {
+        const QStringList parts = name.chopped(4).mid(layer.size() + 1).split('_');
+        if (parts.size() != 3) continue;
+        TileCoord c = {parts[1].toInt(), parts[2].toInt(), parts[0].toInt()};
+
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        QByteArray data = file.readAll();
+        if (!looksLikeImage(data)) continue;
+
+        if (writer.addTile(c.key(), data)) {
+            have.insert(c.key());
+            ++imported;
+        }
+    }
+    return imported;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("DroneShield_TileSeed");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("生成 RadarView 离线瓦片包");
+    parser.addHelpOption();
+    QCommandLineOption outOpt("out", "输出文件 (<图层>.tiles)", "file");
+    QCommandLineOption bboxOpt("bbox", "范围: minLat,minLng,maxLat,maxLng", "bbox");
+    QCommandLineOption zoomOpt("zoom", "缩放级别范围, 如 10-17", "range", "10-17");
+    QCommandLineOption layerOpt("layer", "天地图图层", "layer", "img_w");
+    QCommandLineOption keyOpt("key", "天地图 key", "key");
+    QCommandLineOption dirOpt("from-dir", "先导入已有的逐文件瓦片缓存目录", "dir");
+    QCommandLineOption offlineOpt("offline", "只导入本地文件，不访问网络");
+    QCommandLineOption concurrencyOpt("concurrency", "并发下载数", "n", "8");
+    parser.addOptions({outOpt, bboxOpt, zoomOpt, layerOpt, keyOpt, dirOpt, offlineOpt, concurrencyOpt});
+    parser.process(app);
+
+    if (!parser.isSet(outOpt)) {
+        out() << "缺少 --out" << Qt::endl;
+        return 1;
+    }
+    const QString layer = parser.value(layerOpt);
+
+    BBox box{};
+    int zMin = 0, zMax = 0;
+    bool hasBox = parser.isSet(bboxOpt);
+    if (hasBox && !parseBBox(parser.value(bboxOpt), box)) {
+        out() << "--bbox 格式错误" << Qt::endl;
+        return 1;
+    }
+    if (!parseZoom(parser.value(zoomOpt), zMin, zMax)) {
+        out() << "--zoom 格式错误 (0-" << MAX_ZOOM << ")" << Qt::endl;
+        return 1;
+    }
+
+    TileArchiveWriter writer(parser.value(outOpt));
+    if (!writer.begin()) {
+        out() << "无法创建输出文件: " << writer.errorString() << Qt::endl;
+        return 1;
+    }
+
+    // 1. 导入已有文件
+    QSet<quint64> have;
+    if (parser.isSet(dirOpt)) {
+        int n = importDirectory(parser.value(dirOpt), layer, writer, have);
+        out() << "[导入] " << n << " 个本地瓦片" << Qt::endl;
+    }
+
+    // 2. 计算范围内缺失的瓦片
+    QQueue<TileCoord> queue;
+    if (hasBox) {
+        for (int z = zMin; z <= zMax; ++z) {
+            int x0 = lngToTileX(box.minLng, z), x1 = lngToTileX(box.maxLng, z);
+            int y0 = latToTileY(box.maxLat, z), y1 = latToTileY(box.minLat, z); // 纬度越大 y 越小
+            for (int x = x0; x <= x1; ++x) {
+                for (int y = y0; y <= y1; ++y) {
+                    TileCoord c = {x, y, z};
+                    if (!have.contains(c.key())) queue.enqueue(c);
+                }
+            }
+        }
+        out() << "[范围] 缩放 " << zMin << "-" << zMax << " 需下载 " << queue.size() << " 个瓦片" << Qt::endl;
+    }
+
+    if (parser.isSet(offlineOpt) || queue.isEmpty()) {
+        if (!writer.finish()) {
+            out() << "写入失败: " << writer.errorString() << Qt::endl;
+            return 1;
+        }
+        out() << "[完成] 共 " << writer.tileCount() << " 个瓦片" << Qt::endl;
+        return 0;
+    }
+
+    if (!parser.isSet(keyOpt)) {
+        out() << "下载需要 --key" << Qt::endl;
+        writer.cancel();
+        return 1;
+    }
+
+    // 3. 并发下载，结果顺序追加到瓦片包
+    const QString tk = parser.value(keyOpt);
+    const int concurrency = qBound(1, parser.value(concurrencyOpt).toInt(), 32);
+    const int total = queue.size();
+    QNetworkAccessManager net;
+    QHash<quint64, int> retries;
+    int inFlight = 0, done = 0, failed = 0;
+
+    std::function<void()> pump = [&]() {
+        while (inFlight < concurrency && !queue.isEmpty()) {
+            TileCoord c = queue.dequeue();
+            QNetworkRequest request((QUrl(tileUrl(layer, tk, c))));
+            request.setRawHeader("User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36");
+            QNetworkReply *reply = net.get(request);
+            ++inFlight;
+
+            QObject::connect(reply, &QNetworkReply::finished, [&, reply, c]() {
+                reply->deleteLater();
+                --inFlight;
+
+                QByteArray data = reply->error() == QNetworkReply::NoError ? reply->readAll() : QByteArray();
+                if (looksLikeImage(data)) {
+                    writer.addTile(c.key(), data);
+                    ++done;
+                } else if (++retries[c.key()] <= MAX_RETRY) {
+                    queue.enqueue(c);
+                } else {
+                    ++failed;
+                }
+
+                if ((done + failed) % 500 == 0) {
+                    out() << "[下载] " << done + failed << "/" << total << " 失败 " << failed << Qt::endl;
+                }
+                if (inFlight == 0 && queue.isEmpty()) app.quit();
+                else pump();
+            });
+        }
+    };
+    pump();
+    app.exec();
+
+    if (!writer.finish()) {
+        out() << "写入失败: " << writer.errorString() << Qt::endl;
+        return 1;
+    }
+    out() << "[完成] 下载 " << done << " 失败 " << failed << " 共 " << writer.tileCount() << " 个瓦片" << Qt::endl;
+    return failed ? 2 : 0;
+}